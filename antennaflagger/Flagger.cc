@@ -3,10 +3,13 @@
 
 #include <array>
 #include <cassert>
+#include <cmath>
 #include <cstddef>
 #include <iostream>
 #include <set>
 
+#include <aocommon/staticfor.h>
+
 #include <xtensor/xcomplex.hpp>
 #include <xtensor/xindex_view.hpp>
 #include <xtensor/xmasked_view.hpp>
@@ -81,27 +84,89 @@ xt::xtensor<std::complex<float>, 2> Flagger::ComputeStatsSumSquare(
   return stats;
 }
 
+void Flagger::ComputeStatsStdDevAndSumSquare(
+    const dp3::base::DPBuffer::DataType& data,
+    xt::xtensor<std::complex<float>, 2>& stats_stddev,
+    xt::xtensor<std::complex<float>, 2>& stats_sum_square) {
+  const size_t n_baselines = data.shape(0);
+  const size_t n_channels = data.shape(1);
+  const size_t n_correlations = data.shape(2);
+  stats_stddev.resize({n_baselines, n_correlations});
+  stats_sum_square.resize({n_baselines, n_correlations});
+
+  aocommon::StaticFor<size_t> loop;
+  loop.Run(0, n_baselines, [&](size_t start_baseline, size_t end_baseline) {
+    // Per correlation: sum and sum of squares of the real and imaginary parts.
+    // Accumulating in double precision keeps the single-pass variance
+    // accurate.
+    std::vector<std::complex<double>> sums(n_correlations);
+    std::vector<std::complex<double>> sums_square(n_correlations);
+    for (size_t bl = start_baseline; bl < end_baseline; ++bl) {
+      std::fill(sums.begin(), sums.end(), 0.0);
+      std::fill(sums_square.begin(), sums_square.end(), 0.0);
+      const std::complex<float>* bl_data = &data(bl, 0, 0);
+      for (size_t ch = 0; ch < n_channels; ++ch) {
+        for (size_t cor = 0; cor < n_correlations; ++cor) {
+          const std::complex<double> value = *bl_data;
+          ++bl_data;
+          sums[cor] += value;
+          sums_square[cor] += std::complex<double>(
+              value.real() * value.real(), value.imag() * value.imag());
+        }
+      }
+
+      for (size_t cor = 0; cor < n_correlations; ++cor) {
+        const std::complex<double> mean = sums[cor] / double(n_channels);
+        const double variance_real = std::max(
+            sums_square[cor].real() / n_channels - mean.real() * mean.real(),
+            0.0);
+        const double variance_imag = std::max(
+            sums_square[cor].imag() / n_channels - mean.imag() * mean.imag(),
+            0.0);
+        stats_stddev(bl, cor) = std::complex<float>(std::sqrt(variance_real),
+                                                    std::sqrt(variance_imag));
+        stats_sum_square(bl, cor) = sums_square[cor];
+      }
+    }
+  });
+}
+
 xt::xtensor<std::complex<float>, 3> Flagger::GroupStats(
     size_t n_stations, size_t n_antennas_per_station,
     const xt::xtensor<std::complex<float>, 2>& stats_baseline,
     common::BaselineOrder baseline_order) {
   const size_t n_correlations = stats_baseline.shape(1);
   const size_t n_antennas = n_stations * n_antennas_per_station;
+  const float scale = 1.0f / n_antennas_per_station;
 
   xt::xtensor<std::complex<float>, 3> stats_antenna(
       {n_stations, n_antennas_per_station, n_correlations});
 
-  for (size_t station = 0; station < n_stations; ++station) {
-    for (size_t antenna1 = 0; antenna1 < n_antennas_per_station; ++antenna1) {
-      const size_t antenna2 = station * n_antennas_per_station + antenna1;
-      const std::vector<size_t> baseline_indices =
-          common::ComputeBaselineList(antenna2, n_antennas, baseline_order);
-      xt::view(stats_antenna, station, antenna1, xt::all()) += xt::nansum(
-          xt::view(stats_baseline, xt::keep(baseline_indices), xt::all()), 0);
+  // Every antenna only writes its own accumulator, which allows processing
+  // the antennas in parallel.
+  aocommon::StaticFor<size_t> loop;
+  loop.Run(0, n_antennas, [&](size_t start_antenna, size_t end_antenna) {
+    std::vector<std::complex<float>> sums(n_correlations);
+    for (size_t antenna = start_antenna; antenna < end_antenna; ++antenna) {
+      std::fill(sums.begin(), sums.end(), 0.0f);
+      for (size_t other = 0; other < n_antennas; ++other) {
+        const size_t bl = common::ComputeBaselineIndex(
+            antenna, other, n_antennas, baseline_order);
+        for (size_t cor = 0; cor < n_correlations; ++cor) {
+          const std::complex<float> value = stats_baseline(bl, cor);
+          // Like xt::nansum, skip values with a NaN component.
+          if (!std::isnan(value.real()) && !std::isnan(value.imag())) {
+            sums[cor] += value;
+          }
+        }
+      }
+      const size_t station = antenna / n_antennas_per_station;
+      const size_t station_antenna = antenna % n_antennas_per_station;
+      for (size_t cor = 0; cor < n_correlations; ++cor) {
+        stats_antenna(station, station_antenna, cor) = sums[cor] * scale;
+      }
     }
-  }
-
-  stats_antenna /= float(n_antennas_per_station);
+  });
 
   return stats_antenna;
 }
@@ -182,10 +247,10 @@ xt::xtensor<int, 2> Flagger::ComputeStationFlags(
 void Flagger::ComputeStats(const dp3::base::DPBuffer::DataType& data,
                            common::BaselineOrder baseline_order) {
   compute_statistics_timer_.start();
-  xt::xtensor<std::complex<float>, 2> stats_baseline_stddev =
-      ComputeStatsStdDev(data);
-  xt::xtensor<std::complex<float>, 2> stats_baseline_sum_square =
-      ComputeStatsSumSquare(data);
+  xt::xtensor<std::complex<float>, 2> stats_baseline_stddev;
+  xt::xtensor<std::complex<float>, 2> stats_baseline_sum_square;
+  ComputeStatsStdDevAndSumSquare(data, stats_baseline_stddev,
+                                 stats_baseline_sum_square);
   stats_antenna_stddev_ =
       Flagger::GroupStats(n_stations_, n_antennas_per_station_,
                           stats_baseline_stddev, baseline_order);
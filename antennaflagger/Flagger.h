@@ -93,6 +93,21 @@ class Flagger {
   static xt::xtensor<std::complex<float>, 2> ComputeStatsSumSquare(
       const dp3::base::DPBuffer::DataType& data);
 
+  /**
+   * Compute both the statistics of ComputeStatsStdDev and of
+   * ComputeStatsSumSquare in a single pass over the input. The baselines are
+   * divided over multiple threads.
+   *
+   * @param stats_stddev Is resized to (baselines, correlations) and filled
+   * with the standard deviations.
+   * @param stats_sum_square Is resized to (baselines, correlations) and filled
+   * with the sums of squares.
+   */
+  static void ComputeStatsStdDevAndSumSquare(
+      const dp3::base::DPBuffer::DataType& data,
+      xt::xtensor<std::complex<float>, 2>& stats_stddev,
+      xt::xtensor<std::complex<float>, 2>& stats_sum_square);
+
   /**
    * Compute the per antenna statistics by combining the
    * statistics of all baselines an antenna contributed to. The input is in the
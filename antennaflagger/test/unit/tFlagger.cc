@@ -3,6 +3,8 @@
 
 #include "../../Flagger.h"
 
+#include <limits>
+
 #include <aocommon/xt/span.h>
 #include <boost/test/unit_test.hpp>
 #include <boost/test/data/test_case.hpp>
@@ -188,6 +190,82 @@ BOOST_AUTO_TEST_CASE(compute_antenna_flags) {
   BOOST_CHECK_EQUAL(flags_sum_square, expected_flags);
 }
 
+BOOST_AUTO_TEST_CASE(compute_stats_single_pass) {
+  const unsigned int kNAntennas = 12;
+  const unsigned int kNChannels = 16;
+  const unsigned int kNCorrelations = 4;
+  const unsigned int kNBaselines = dp3::common::ComputeNBaselines(kNAntennas);
+
+  xt::xtensor<std::complex<float>, 3> data = CreateBrokenAntennaData(
+      kNBaselines, kNAntennas, kNChannels, kNCorrelations, 3);
+  // Add an offset to check that the mean is removed accurately.
+  data += std::complex<float>(10.0f, -5.0f);
+  const dp3::base::DPBuffer::DataType data_span =
+      aocommon::xt::CreateSpan(data);
+
+  xt::xtensor<std::complex<float>, 2> stats_stddev;
+  xt::xtensor<std::complex<float>, 2> stats_sum_square;
+  dp3::antennaflagger::Flagger::ComputeStatsStdDevAndSumSquare(
+      data_span, stats_stddev, stats_sum_square);
+
+  const xt::xtensor<std::complex<float>, 2> expected_stddev =
+      dp3::antennaflagger::Flagger::ComputeStatsStdDev(data_span);
+  const xt::xtensor<std::complex<float>, 2> expected_sum_square =
+      dp3::antennaflagger::Flagger::ComputeStatsSumSquare(data_span);
+  BOOST_REQUIRE(stats_stddev.shape() == expected_stddev.shape());
+  BOOST_REQUIRE(stats_sum_square.shape() == expected_sum_square.shape());
+  BOOST_CHECK(xt::allclose(stats_stddev, expected_stddev, 1.0e-4, 1.0e-5));
+  BOOST_CHECK(xt::allclose(stats_sum_square, expected_sum_square, 1.0e-5));
+}
+
+BOOST_AUTO_TEST_CASE(group_stats) {
+  const size_t kNStations = 3;
+  const size_t kNAntennasPerStation = 4;
+  const size_t kNAntennas = kNStations * kNAntennasPerStation;
+  const size_t kNCorrelations = 2;
+  const size_t kNBaselines = dp3::common::ComputeNBaselines(kNAntennas);
+
+  xt::random::seed(0);
+  xt::xtensor<std::complex<float>, 2> stats_baseline(
+      {kNBaselines, kNCorrelations});
+  xt::real(stats_baseline) =
+      xt::random::rand<float>(stats_baseline.shape(), 0, 1);
+  xt::imag(stats_baseline) =
+      xt::random::rand<float>(stats_baseline.shape(), 0, 1);
+  // NaN values should be ignored.
+  stats_baseline(5, 1) =
+      std::complex<float>(std::numeric_limits<float>::quiet_NaN(), 1.0f);
+
+  for (dp3::common::BaselineOrder baseline_order :
+       {dp3::common::BaselineOrder::kRowMajor,
+        dp3::common::BaselineOrder::kColumnMajor}) {
+    const xt::xtensor<std::complex<float>, 3> stats_antenna =
+        dp3::antennaflagger::Flagger::GroupStats(
+            kNStations, kNAntennasPerStation, stats_baseline, baseline_order);
+
+    for (size_t antenna = 0; antenna < kNAntennas; ++antenna) {
+      for (size_t cor = 0; cor < kNCorrelations; ++cor) {
+        std::complex<float> expected = 0.0f;
+        for (size_t bl = 0; bl < kNBaselines; ++bl) {
+          const std::pair<size_t, size_t> antennas =
+              dp3::common::ComputeBaseline(bl, kNAntennas, baseline_order);
+          const std::complex<float> value = stats_baseline(bl, cor);
+          if ((antennas.first == antenna || antennas.second == antenna) &&
+              !std::isnan(value.real())) {
+            expected += value;
+          }
+        }
+        expected /= float(kNAntennasPerStation);
+        const std::complex<float> result =
+            stats_antenna(antenna / kNAntennasPerStation,
+                          antenna % kNAntennasPerStation, cor);
+        BOOST_CHECK_CLOSE(result.real(), expected.real(), 1.0e-4);
+        BOOST_CHECK_CLOSE(result.imag(), expected.imag(), 1.0e-4);
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(find_bad_antennas) {
   const unsigned int kNStations = 2;
   const unsigned int kNAntennasPerStation = 48;
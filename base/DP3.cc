@@ -14,6 +14,7 @@
 #include <dp3/base/DPBuffer.h>
 #include <dp3/base/DPInfo.h>
 #include "ProgressMeter.h"
+#include "Sharding.h"
 #include "SkyModelCache.h"
 
 #include "../steps/AntennaFlagger.h"
@@ -30,6 +31,7 @@
 #include "../steps/BdaDdeCal.h"
 #include "../steps/Demixer.h"
 #include "../steps/Filter.h"
+#include "../steps/FusedStep.h"
 #include "../steps/GainCal.h"
 #include "../steps/H5ParmPredict.h"
 #include "../steps/IDGPredict.h"
@@ -38,6 +40,7 @@
 #include "../steps/MadFlagger.h"
 #include "../steps/MSBDAWriter.h"
 #include "../steps/MsColumnReader.h"
+#include "../steps/MSReader.h"
 #include "../steps/MSUpdater.h"
 #include "../steps/MSWriter.h"
 #include "../steps/NullStep.h"
@@ -56,6 +59,8 @@
 #include "../pythondp3/PyStep.h"
 
 #include <dp3/common/Fields.h>
+#include "../common/Memory.h"
+#include "../common/Numa.h"
 #include "../common/Timer.h"
 #include "../common/StreamUtil.h"
 #include "../steps/AntennaFlagger.h"
@@ -155,7 +160,7 @@ std::shared_ptr<Step> MakeSingleStep(const std::string& type,
   if (type == "aoflagger" || type == "aoflag") {
     step = std::make_shared<steps::AOFlaggerStep>(parset, prefix);
   } else if (type == "averager" || type == "average" || type == "squash") {
-    step = std::make_shared<steps::Averager>(parset, prefix);
+    step = std::make_shared<steps::Averager>(parset, prefix, inputType);
   } else if (type == "bdaaverage" || type == "bdaaverager") {
     step = std::make_shared<steps::BDAAverager>(parset, prefix);
   } else if (type == "bdaexpander") {
@@ -175,7 +180,7 @@ std::shared_ptr<Step> MakeSingleStep(const std::string& type,
   } else if (type == "counter" || type == "count") {
     step = std::make_shared<steps::Counter>(parset, prefix);
   } else if (type == "phaseshifter" || type == "phaseshift") {
-    step = std::make_shared<steps::PhaseShift>(parset, prefix);
+    step = std::make_shared<steps::PhaseShift>(parset, prefix, inputType);
   } else if (type == "demixer" || type == "demix") {
     step = std::make_shared<steps::Demixer>(parset, prefix);
   } else if (type == "applybeam") {
@@ -189,7 +194,8 @@ std::shared_ptr<Step> MakeSingleStep(const std::string& type,
   } else if (type == "filter") {
     step = std::make_shared<steps::Filter>(parset, prefix);
   } else if (type == "applycal" || type == "correct") {
-    step = std::make_shared<steps::ApplyCal>(parset, prefix);
+    step = std::make_shared<steps::ApplyCal>(parset, prefix, false, "",
+                                             inputType);
   } else if (type == "nullstokes") {
     step = std::make_shared<steps::NullStokes>(parset, prefix);
   } else if (type == "predict") {
@@ -276,6 +282,12 @@ void Execute(const string& parsetName, int argc, char* argv[]) {
   aocommon::Logger::SetLogTime(parset.getBool("time_logging", false));
   aocommon::Logger::SetLogMemory(parset.getBool("memory_logging", false));
 
+  const size_t n_shards = parset.getUint("shards", 1);
+  if (n_shards > 1) {
+    ExecuteSharded(parset, n_shards);
+    return;
+  }
+
   bool showProgress = parset.getBool("showprogress", true);
   bool showTimings = parset.getBool("showtimings", true);
   // checkparset is an integer parameter now, but accepts a bool as well
@@ -296,6 +308,23 @@ void Execute(const string& parsetName, int argc, char* argv[]) {
   aocommon::ThreadPool::GetInstance().SetNThreads(n_threads);
   Step::SetThreadingIsInitialized();
   aocommon::Logger::Debug << "DP3 started with " << n_threads << " threads.\n";
+  if (parset.getBool("numa", false)) {
+    const size_t n_nodes = common::SetNumaAwareMode(true);
+    aocommon::Logger::Info << "Threads are pinned to cpus on " << n_nodes
+                           << " NUMA node(s).\n";
+  } else {
+    common::SetNumaAwareMode(false);
+  }
+
+  // Divide a total memory budget (in GB or a percentage of the system
+  // memory) among the steps that buffer data.
+  const double memory_budget = parset.getDouble("memorybudget", 0.0);
+  const double memory_budget_percentage =
+      parset.getDouble("memorybudgetperc", 0.0);
+  common::MemoryBudget::GetInstance().SetTotal(
+      (memory_budget > 0.0 || memory_budget_percentage > 0.0)
+          ? common::AvailableMemory(memory_budget, memory_budget_percentage)
+          : 0.0);
 
   // Create the steps, link them together
   std::shared_ptr<InputStep> firstStep = MakeMainSteps(parset);
@@ -397,20 +426,160 @@ firstStep->finish();
       step = step->getNextStep();
     }
   }
+  if (common::MemoryBudget::GetInstance().GetTotal() > 0.0) {
+    std::ostringstream os;
+    common::MemoryBudget::GetInstance().ShowPeakUsage(os);
+    aocommon::Logger::Info << os.str();
+  }
   aocommon::Logger::Debug << "End timer output\n";
   // The destructors are called automatically at this point.
 }
 
+/// Get the type of a step. The alphabetic part of the name is the default
+/// step type. This allows names like average1, out3.
+std::string GetStepType(const common::ParameterSet& parset,
+                        const std::string& step_name) {
+  std::string default_type = step_name;
+  while (!default_type.empty() && std::isdigit(default_type.back())) {
+    default_type.resize(default_type.size() - 1);
+  }
+  std::string type = parset.getString(step_name + ".type", default_type);
+  boost::algorithm::to_lower(type);
+  return type;
+}
+
+/// Create the steps with the given names and link them together.
+static std::shared_ptr<Step> MakeSteps(
+    const common::ParameterSet& parset,
+    const std::vector<std::string>& stepNames,
+    const std::string& input_ms_name, bool terminateChain,
+    Step::MsType initial_step_output) {
+  std::string msName = input_ms_name;
+
+  std::shared_ptr<Step> firstStep;
+  std::shared_ptr<Step> lastStep;
+  for (const std::string& stepName : stepNames) {
+    std::string prefix(stepName + '.');
+    const std::string type = GetStepType(parset, stepName);
+
+    Step::MsType inputType =
+        lastStep ? lastStep->outputs() : initial_step_output;
+    std::shared_ptr<Step> step =
+        MakeSingleStep(type, parset, prefix, inputType);
+    if (!step && (type == "out" || type == "output" || type == "msout")) {
+      step = MakeOutputStep(parset, prefix, msName, inputType);
+    }
+    if (!step) {
+      throw std::runtime_error("Could not create step of type '" + type + "'");
+    }
+
+    if (lastStep) {
+      if (!step->accepts(lastStep->outputs())) {
+        throw std::invalid_argument("Step " + type +
+                                    " is incompatible with the input data.");
+      }
+      lastStep->setNextStep(step);
+    }
+    lastStep = step;
+
+    if (!firstStep) {
+      firstStep = step;
+    }
+  }
+
+  if (terminateChain && lastStep) {
+    // Add a null step, so the last step can use getNextStep->process().
+    lastStep->setNextStep(std::make_shared<steps::NullStep>());
+  }
+
+  return firstStep;
+}
+
+/// Check if the baseline and channel selection of the first step can be
+/// applied by the reader, such that the deselected data is never read.
+/// That is the case if the first step is a filter that only selects baselines
+/// (in MSSelection syntax) and/or channels without removing antennas, and the
+/// input is a single MS without a selection of its own.
+/// @return The parset prefix of the filter step, or an empty string if its
+/// selection can not be pushed into the reader.
+static std::string FindPushableSelection(
+    const common::ParameterSet& parset,
+    const std::vector<std::string>& step_names) {
+  if (step_names.empty() || GetStepType(parset, step_names.front()) != "filter")
+    return "";
+  const std::string prefix = step_names.front() + '.';
+
+  const std::vector<std::string> in_names = parset.getStringVector(
+      parset.isDefined("msin.name") ? "msin.name" : "msin",
+      std::vector<std::string>());
+  if (in_names.size() != 1 ||
+      in_names.front().find_first_of("*?{['") != std::string::npos) {
+    return "";
+  }
+  for (const char* key : {"baseline", "startchan", "nchan"}) {
+    if (parset.isDefined(std::string("msin.") + key)) return "";
+  }
+
+  // The filter may not have other keys, like corrtype or blrange.
+  bool has_selection = false;
+  const common::ParameterSet filter_parset = parset.makeSubset(prefix);
+  for (const auto& [key, value] : filter_parset) {
+    if (key == "baseline" || key == "startchan" || key == "nchan") {
+      has_selection = true;
+    } else if (key != "type" && key != "remove") {
+      return "";
+    }
+  }
+  if (!has_selection || parset.getBool(prefix + "remove", false)) return "";
+  // A baseline selection given as a vector of antenna name patterns can only
+  // be handled by the filter.
+  if (parset.getString(prefix + "baseline", "").find('[') == 0) return "";
+  return prefix;
+}
+
+/// Insert a FusedStep in front of each series of at least two consecutive
+/// steps that can process the data in tiles of baselines.
+static void FuseSteps(const std::shared_ptr<Step>& first_step) {
+  std::shared_ptr<Step> step = first_step;
+  while (step->getNextStep()) {
+    std::vector<std::shared_ptr<Step>> series;
+    for (std::shared_ptr<Step> next = step->getNextStep();
+         next && next->SupportsBaselineTiles(); next = next->getNextStep()) {
+      series.push_back(next);
+    }
+    if (series.size() >= 2) {
+      auto fused_step = std::make_shared<steps::FusedStep>(series);
+      step->setNextStep(fused_step);
+      fused_step->setNextStep(series.front());
+      step = series.back();
+    } else {
+      step = step->getNextStep();
+    }
+  }
+}
+
 std::shared_ptr<InputStep> MakeMainSteps(const common::ParameterSet& parset) {
-  std::shared_ptr<InputStep> input_step = InputStep::CreateReader(parset);
+  std::vector<std::string> step_names = parset.getStringVector("steps");
+  const std::string selection_prefix =
+      FindPushableSelection(parset, step_names);
+  std::shared_ptr<InputStep> input_step =
+      InputStep::CreateReader(parset, selection_prefix);
   std::shared_ptr<Step> last_step = input_step;
 
+  // Only a regular MSReader applies the selection; otherwise keep the filter.
+  if (!selection_prefix.empty() &&
+      dynamic_cast<steps::MSReader*>(input_step.get())) {
+    aocommon::Logger::Info << "Selection of step " << step_names.front()
+                           << " is applied while reading the MS\n";
+    step_names.erase(step_names.begin());
+  }
+
   // Create the second and later steps, as requested by the parset. The chain
   // is not terminated by a null step yet.
   const std::string ms_name =
       casacore::Path(input_step->msName()).absoluteName();
-  std::shared_ptr<Step> step = MakeStepsFromParset(
-      parset, "", "steps", ms_name, false, input_step->outputs());
+  std::shared_ptr<Step> step =
+      MakeSteps(parset, step_names, ms_name, false, input_step->outputs());
   if (step) {
     input_step->setNextStep(step);
 
@@ -446,6 +615,10 @@ std::shared_ptr<InputStep> MakeMainSteps(const common::ParameterSet& parset) {
     last_step->setNextStep(std::make_shared<steps::NullStep>());
   }
 
+  if (parset.getBool("fusesteps", false)) {
+    FuseSteps(input_step);
+  }
+
   // Tell the reader which fields must be read.
   input_step->setFieldsToRead(
       GetChainRequiredFields(input_step->getNextStep()));
@@ -459,55 +632,8 @@ std::shared_ptr<Step> MakeStepsFromParset(const common::ParameterSet& parset,
                                           const std::string& input_ms_name,
                                           bool terminateChain,
                                           Step::MsType initial_step_output) {
-  std::string msName = input_ms_name;
-  const std::vector<string> stepNames =
-      parset.getStringVector(prefix + step_names_key);
-
-  std::shared_ptr<Step> firstStep;
-  std::shared_ptr<Step> lastStep;
-  for (const std::string& stepName : stepNames) {
-    std::string prefix(stepName + '.');
-
-    // The alphabetic part of the name is the default step type.
-    // This allows names like average1, out3.
-    std::string defaultType = stepName;
-    while (!defaultType.empty() && std::isdigit(defaultType.back())) {
-      defaultType.resize(defaultType.size() - 1);
-    }
-    std::string type = parset.getString(prefix + "type", defaultType);
-    boost::algorithm::to_lower(type);
-
-    Step::MsType inputType =
-        lastStep ? lastStep->outputs() : initial_step_output;
-    std::shared_ptr<Step> step =
-        MakeSingleStep(type, parset, prefix, inputType);
-    if (!step && (type == "out" || type == "output" || type == "msout")) {
-      step = MakeOutputStep(parset, prefix, msName, inputType);
-    }
-    if (!step) {
-      throw std::runtime_error("Could not create step of type '" + type + "'");
-    }
-
-    if (lastStep) {
-      if (!step->accepts(lastStep->outputs())) {
-        throw std::invalid_argument("Step " + type +
-                                    " is incompatible with the input data.");
-      }
-      lastStep->setNextStep(step);
-    }
-    lastStep = step;
-
-    if (!firstStep) {
-      firstStep = step;
-    }
-  }
-
-  if (terminateChain && lastStep) {
-    // Add a null step, so the last step can use getNextStep->process().
-    lastStep->setNextStep(std::make_shared<steps::NullStep>());
-  }
-
-  return firstStep;
+  return MakeSteps(parset, parset.getStringVector(prefix + step_names_key),
+                   input_ms_name, terminateChain, initial_step_output);
 }
 
 size_t GetNThreads() { return aocommon::ThreadPool::GetInstance().NThreads(); }
@@ -19,6 +19,30 @@
 #define USE_CASACORE_MOVE_SEMANTICS
 #endif
 
+namespace {
+template <typename Tensor>
+void SelectChannelRange(Tensor& tensor, std::size_t start_channel,
+                        std::size_t n_channels) {
+  const std::size_t n_in_channels = tensor.shape(1);
+  if (tensor.size() == 0 ||
+      (start_channel == 0 && n_channels == n_in_channels)) {
+    return;
+  }
+  assert(start_channel + n_channels <= n_in_channels);
+  const std::array<std::size_t, 3> shape{tensor.shape(0), n_channels,
+                                         tensor.shape(2)};
+  Tensor selection(shape);
+  const std::size_t in_size = n_in_channels * shape[2];
+  const std::size_t out_size = n_channels * shape[2];
+  const auto* in = tensor.data() + start_channel * shape[2];
+  auto* out = selection.data();
+  for (std::size_t bl = 0; bl < shape[0]; ++bl) {
+    std::copy_n(in + bl * in_size, out_size, out + bl * out_size);
+  }
+  tensor = std::move(selection);
+}
+}  // namespace
+
 namespace dp3 {
 namespace base {
 
@@ -148,5 +172,15 @@ void DPBuffer::MoveData(DPBuffer& source, const std::string& source_name,
   }
 }
 
+void DPBuffer::SelectChannels(std::size_t start_channel,
+                              std::size_t n_channels) {
+  SelectChannelRange(data_, start_channel, n_channels);
+  for (auto& [name, data] : extra_data_) {
+    SelectChannelRange(data, start_channel, n_channels);
+  }
+  SelectChannelRange(flags_, start_channel, n_channels);
+  SelectChannelRange(weights_, start_channel, n_channels);
+}
+
 }  // namespace base
 }  // namespace dp3
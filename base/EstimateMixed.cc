@@ -14,7 +14,11 @@
 
 #include "../common/StreamUtil.h"  ///
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
+
 using dp3::common::operator<<;
 
 namespace dp3 {
@@ -47,19 +51,37 @@ void makeIndex(std::size_t n_direction, std::size_t n_station,
   }
 }
 
-bool estimate(size_t nDirection, size_t nStation, size_t nBaseline,
-              size_t nChannel, const_cursor<Baseline> baselines,
-              std::vector<const_cursor<std::complex<float>>> data,
-              std::vector<const_cursor<std::complex<double>>> model,
-              const_cursor<bool> flag, const_cursor<float> weight,
-              const_cursor<std::complex<double>> mix, double *unknowns,
-              size_t maxiter) {
-  assert(data.size() == nDirection && model.size() == nDirection);
-
-  // Initialize LSQ solver.
-  const size_t nUnknowns = nDirection * nStation * 4 * 2;
-  casacore::LSQFit solver(nUnknowns);
-
+namespace {
+
+/// Solve the normal equations for the unknowns: the upper triangle of the
+/// normal matrix is overwritten by its Cholesky factor and the right hand
+/// side by the solution.
+extern "C" void dposv_(char *uplo, int *n, int *nrhs, double *a, int *lda,
+                       double *b, int *ldb, int *info);
+
+/// Damping of the Levenberg-Marquardt iterations of estimateDense().
+constexpr double kInitialDamping = 1.0e-3;
+constexpr double kMinimumDamping = 1.0e-9;
+constexpr double kDampingFactor = 10.0;
+/// estimateDense() has converged when no unknown changes by more than this
+/// fraction of the largest unknown.
+constexpr double kSolutionTolerance = 1.0e-8;
+
+/// Compute the equations for all visibilities, linearized around the current
+/// values of the unknowns. For each (real) equation, calls
+/// add_equation(correlation, index, derivatives, weight, residual), where
+/// index and derivatives are arrays of nDirection * 8 values (see
+/// makeIndex()). After all equations of a baseline, calls
+/// end_baseline(baseline).
+template <typename AddEquation, typename EndBaseline>
+void makeEquations(size_t nDirection, size_t nStation, size_t nBaseline,
+                   size_t nChannel, const_cursor<Baseline> baselines,
+                   std::vector<const_cursor<std::complex<float>>> data,
+                   std::vector<const_cursor<std::complex<double>>> model,
+                   const_cursor<bool> flag, const_cursor<float> weight,
+                   const_cursor<std::complex<double>> mix,
+                   const double *unknowns, AddEquation &&add_equation,
+                   EndBaseline &&end_baseline) {
   // Each visibility provides information about two (complex) unknowns per
   // station per direction. A visibility is measured by a specific
   // interferometer, which is the combination of two stations. Thus, in total
@@ -68,208 +90,226 @@ bool estimate(size_t nDirection, size_t nStation, size_t nBaseline,
   // unknowns the value of the partial derivative of the model with respect
   // to the unknown has to be computed.
   const size_t nPartial = nDirection * 8;
-  vector<unsigned int> dIndex(4 * nPartial);
+  std::vector<unsigned int> dIndex(4 * nPartial);
 
   // Allocate space for intermediate results.
   std::vector<std::complex<double>> M(nDirection * 4), dM(nDirection * 16);
   std::vector<double> dR(nPartial), dI(nPartial);
 
-  // Iterate until convergence.
-  size_t nIterations = 0;
-  while (!solver.isReady() && nIterations < maxiter) {
-    for (size_t bl = 0; bl < nBaseline; ++bl) {
-      const size_t p = baselines->first;
-      const size_t q = baselines->second;
-
-      if (p != q) {
-        // Create partial derivative index for current baseline.
-        makeIndex(nDirection, nStation, *baselines, &(dIndex[0]));
-
-        for (size_t ch = 0; ch < nChannel; ++ch) {
-          for (size_t dr = 0; dr < nDirection; ++dr) {
-            // Jones matrix for station P.
-            const double *Jp = &(unknowns[dr * nStation * 8 + p * 8]);
-            const std::complex<double> Jp_00(Jp[0], Jp[1]);
-            const std::complex<double> Jp_01(Jp[2], Jp[3]);
-            const std::complex<double> Jp_10(Jp[4], Jp[5]);
-            const std::complex<double> Jp_11(Jp[6], Jp[7]);
-
-            // Jones matrix for station Q, conjugated.
-            const double *Jq = &(unknowns[dr * nStation * 8 + q * 8]);
-            const std::complex<double> Jq_00(Jq[0], -Jq[1]);
-            const std::complex<double> Jq_01(Jq[2], -Jq[3]);
-            const std::complex<double> Jq_10(Jq[4], -Jq[5]);
-            const std::complex<double> Jq_11(Jq[6], -Jq[7]);
-
-            // Fetch model visibilities for the current direction.
-            const std::complex<double> xx = model[dr][0];
-            const std::complex<double> xy = model[dr][1];
-            const std::complex<double> yx = model[dr][2];
-            const std::complex<double> yy = model[dr][3];
-
-            // Precompute terms involving conj(Jq) and the model
-            // visibilities.
-            const std::complex<double> Jq_00xx_01xy = Jq_00 * xx + Jq_01 * xy;
-            const std::complex<double> Jq_00yx_01yy = Jq_00 * yx + Jq_01 * yy;
-            const std::complex<double> Jq_10xx_11xy = Jq_10 * xx + Jq_11 * xy;
-            const std::complex<double> Jq_10yx_11yy = Jq_10 * yx + Jq_11 * yy;
-
-            // Precompute (Jp x conj(Jq)) * vec(data), where 'x'
-            // denotes the Kronecker product. This is the model
-            // visibility for the current direction, with the
-            // current Jones matrix estimates applied. This is
-            // stored in M.
-            // Also, precompute the partial derivatives of M with
-            // respect to all 16 parameters (i.e. 2 Jones matrices
-            // Jp and Jq, 4 complex scalars per Jones matrix, 2 real
-            // scalars per complex scalar, 2 * 4 * 2 = 16). These
-            // partial derivatives are stored in dM.
-            M[dr * 4] = Jp_00 * Jq_00xx_01xy + Jp_01 * Jq_00yx_01yy;
-            dM[dr * 16] = Jq_00xx_01xy;                 // dM_00/dJp_00
-            dM[dr * 16 + 1] = Jq_00yx_01yy;             // dM_00/dJp_01
-            dM[dr * 16 + 2] = Jp_00 * xx + Jp_01 * yx;  // dM_00/dJq_00
-            dM[dr * 16 + 3] = Jp_00 * xy + Jp_01 * yy;  // dM_00/dJq_01
-
-            M[dr * 4 + 1] = Jp_00 * Jq_10xx_11xy + Jp_01 * Jq_10yx_11yy;
-            dM[dr * 16 + 4] = Jq_10xx_11xy;     // dM_01/dJp_00
-            dM[dr * 16 + 5] = Jq_10yx_11yy;     // dM_01/dJp_01
-            dM[dr * 16 + 6] = dM[dr * 16 + 2];  // dM_01/dJq_10
-            dM[dr * 16 + 7] = dM[dr * 16 + 3];  // dM_01/dJq_11
-
-            M[dr * 4 + 2] = Jp_10 * Jq_00xx_01xy + Jp_11 * Jq_00yx_01yy;
-            dM[dr * 16 + 8] = dM[dr * 16];               // dM_10/dJp_10
-            dM[dr * 16 + 9] = dM[dr * 16 + 1];           // dM_10/dJp_11
-            dM[dr * 16 + 10] = Jp_10 * xx + Jp_11 * yx;  // dM_10/dJq_00
-            dM[dr * 16 + 11] = Jp_10 * xy + Jp_11 * yy;  // dM_10/dJq_01
-
-            M[dr * 4 + 3] = Jp_10 * Jq_10xx_11xy + Jp_11 * Jq_10yx_11yy;
-            dM[dr * 16 + 12] = dM[dr * 16 + 4];   // dM_11/dJp_10
-            dM[dr * 16 + 13] = dM[dr * 16 + 5];   // dM_11/dJp_11
-            dM[dr * 16 + 14] = dM[dr * 16 + 10];  // dM_11/dJq_10
-            dM[dr * 16 + 15] = dM[dr * 16 + 11];  // dM_11/dJq_11
-          }
+  for (size_t bl = 0; bl < nBaseline; ++bl) {
+    const size_t p = baselines->first;
+    const size_t q = baselines->second;
 
-          for (size_t cr = 0; cr < 4; ++cr)  // correlation: 00,01,10,11
-          {
-            if (!flag[cr]) {
-              for (size_t tg = 0; tg < nDirection; ++tg) {
-                std::complex<double> visibility(0.0, 0.0);
-                for (size_t dr = 0; dr < nDirection; ++dr) {
-                  // Look-up mixing weight.
-                  const std::complex<double> mix_weight = *mix;
-
-                  // Weight model visibility.
-                  visibility += mix_weight * M[dr * 4 + cr];
-
-                  // Compute weighted partial derivatives.
-                  std::complex<double> derivative(0.0, 0.0);
-                  derivative = mix_weight * dM[dr * 16 + cr * 4];
-                  dR[dr * 8] = real(derivative);  // for cr==0: Re(d/dRe(p_00)))
-                  dI[dr * 8] = imag(derivative);  // for cr==0: Re(d/dIm(p_00)))
-                  dR[dr * 8 + 1] =
-                      -imag(derivative);  // for cr==0: Im(d/dRe(p_00)))
-                  dI[dr * 8 + 1] =
-                      real(derivative);  // for cr==0: Im(d/dIm(p_00)))
-
-                  derivative = mix_weight * dM[dr * 16 + cr * 4 + 1];
-                  dR[dr * 8 + 2] =
-                      real(derivative);  // for cr==0: Re(d/dRe(p_01)))
-                  dI[dr * 8 + 2] =
-                      imag(derivative);  // for cr==0: Re(d/dIm(p_01)))
-                  dR[dr * 8 + 3] =
-                      -imag(derivative);  // for cr==0: Im(d/dRe(p_01)))
-                  dI[dr * 8 + 3] =
-                      real(derivative);  // for cr==0: Im(d/dIm(p_01)))
-
-                  derivative = mix_weight * dM[dr * 16 + cr * 4 + 2];
-                  dR[dr * 8 + 4] =
-                      real(derivative);  // for cr==0: Re(d/dRe(q_00)))
-                  dI[dr * 8 + 4] =
-                      imag(derivative);  // for cr==0: Re(d/dIm(q_00)))
-                  dR[dr * 8 + 5] =
-                      imag(derivative);  // for cr==0: Im(d/dRe(q_00)))
-                  dI[dr * 8 + 5] =
-                      -real(derivative);  // for cr==0: Im(d/dIm(q_00)))
-
-                  derivative = mix_weight * dM[dr * 16 + cr * 4 + 3];
-                  dR[dr * 8 + 6] =
-                      real(derivative);  // for cr==0: Re(d/dRe(q_01)))
-                  dI[dr * 8 + 6] =
-                      imag(derivative);  // for cr==0: Re(d/dIm(q_01)))
-                  dR[dr * 8 + 7] =
-                      imag(derivative);  // for cr==0: Im(d/dRe(q_01)))
-                  dI[dr * 8 + 7] =
-                      -real(derivative);  // for cr==0: Im(d/dIm(q_01)))
-
-                  // Move to next source direction.
-                  mix.forward(1);
-                }  // Source directions.
-
-                // Compute the residual.
-                std::complex<double> residual =
-                    std::complex<double>{data[tg][cr]} - visibility;
-
-                // Update the normal equations.
-                solver.makeNorm(nPartial, &(dIndex[cr * nPartial]), &(dR[0]),
-                                double{weight[cr]}, residual.real());
-                solver.makeNorm(nPartial, &(dIndex[cr * nPartial]), &(dI[0]),
-                                double{weight[cr]}, residual.imag());
-
-                // Move to next target direction.
-                mix.backward(1, nDirection);
-                mix.forward(0);
-              }  // Target directions.
-
-              // Reset cursor to the start of the correlation.
-              mix.backward(0, nDirection);
-            }
-
-            // Move to the next correlation.
-            mix.forward(2);
-          }  // Correlations.
+    if (p != q) {
+      // Create partial derivative index for current baseline.
+      makeIndex(nDirection, nStation, *baselines, &(dIndex[0]));
 
-          // Move to the next channel.
-          mix.backward(2, 4);
-          mix.forward(3);
+      for (size_t ch = 0; ch < nChannel; ++ch) {
+        for (size_t dr = 0; dr < nDirection; ++dr) {
+          // Jones matrix for station P.
+          const double *Jp = &(unknowns[dr * nStation * 8 + p * 8]);
+          const std::complex<double> Jp_00(Jp[0], Jp[1]);
+          const std::complex<double> Jp_01(Jp[2], Jp[3]);
+          const std::complex<double> Jp_10(Jp[4], Jp[5]);
+          const std::complex<double> Jp_11(Jp[6], Jp[7]);
+
+          // Jones matrix for station Q, conjugated.
+          const double *Jq = &(unknowns[dr * nStation * 8 + q * 8]);
+          const std::complex<double> Jq_00(Jq[0], -Jq[1]);
+          const std::complex<double> Jq_01(Jq[2], -Jq[3]);
+          const std::complex<double> Jq_10(Jq[4], -Jq[5]);
+          const std::complex<double> Jq_11(Jq[6], -Jq[7]);
+
+          // Fetch model visibilities for the current direction.
+          const std::complex<double> xx = model[dr][0];
+          const std::complex<double> xy = model[dr][1];
+          const std::complex<double> yx = model[dr][2];
+          const std::complex<double> yy = model[dr][3];
+
+          // Precompute terms involving conj(Jq) and the model
+          // visibilities.
+          const std::complex<double> Jq_00xx_01xy = Jq_00 * xx + Jq_01 * xy;
+          const std::complex<double> Jq_00yx_01yy = Jq_00 * yx + Jq_01 * yy;
+          const std::complex<double> Jq_10xx_11xy = Jq_10 * xx + Jq_11 * xy;
+          const std::complex<double> Jq_10yx_11yy = Jq_10 * yx + Jq_11 * yy;
+
+          // Precompute (Jp x conj(Jq)) * vec(data), where 'x'
+          // denotes the Kronecker product. This is the model
+          // visibility for the current direction, with the
+          // current Jones matrix estimates applied. This is
+          // stored in M.
+          // Also, precompute the partial derivatives of M with
+          // respect to all 16 parameters (i.e. 2 Jones matrices
+          // Jp and Jq, 4 complex scalars per Jones matrix, 2 real
+          // scalars per complex scalar, 2 * 4 * 2 = 16). These
+          // partial derivatives are stored in dM.
+          M[dr * 4] = Jp_00 * Jq_00xx_01xy + Jp_01 * Jq_00yx_01yy;
+          dM[dr * 16] = Jq_00xx_01xy;                 // dM_00/dJp_00
+          dM[dr * 16 + 1] = Jq_00yx_01yy;             // dM_00/dJp_01
+          dM[dr * 16 + 2] = Jp_00 * xx + Jp_01 * yx;  // dM_00/dJq_00
+          dM[dr * 16 + 3] = Jp_00 * xy + Jp_01 * yy;  // dM_00/dJq_01
+
+          M[dr * 4 + 1] = Jp_00 * Jq_10xx_11xy + Jp_01 * Jq_10yx_11yy;
+          dM[dr * 16 + 4] = Jq_10xx_11xy;     // dM_01/dJp_00
+          dM[dr * 16 + 5] = Jq_10yx_11yy;     // dM_01/dJp_01
+          dM[dr * 16 + 6] = dM[dr * 16 + 2];  // dM_01/dJq_10
+          dM[dr * 16 + 7] = dM[dr * 16 + 3];  // dM_01/dJq_11
+
+          M[dr * 4 + 2] = Jp_10 * Jq_00xx_01xy + Jp_11 * Jq_00yx_01yy;
+          dM[dr * 16 + 8] = dM[dr * 16];               // dM_10/dJp_10
+          dM[dr * 16 + 9] = dM[dr * 16 + 1];           // dM_10/dJp_11
+          dM[dr * 16 + 10] = Jp_10 * xx + Jp_11 * yx;  // dM_10/dJq_00
+          dM[dr * 16 + 11] = Jp_10 * xy + Jp_11 * yy;  // dM_10/dJq_01
+
+          M[dr * 4 + 3] = Jp_10 * Jq_10xx_11xy + Jp_11 * Jq_10yx_11yy;
+          dM[dr * 16 + 12] = dM[dr * 16 + 4];   // dM_11/dJp_10
+          dM[dr * 16 + 13] = dM[dr * 16 + 5];   // dM_11/dJp_11
+          dM[dr * 16 + 14] = dM[dr * 16 + 10];  // dM_11/dJq_10
+          dM[dr * 16 + 15] = dM[dr * 16 + 11];  // dM_11/dJq_11
+        }
 
-          for (size_t dr = 0; dr < nDirection; ++dr) {
-            model[dr].forward(1);
-            data[dr].forward(1);
+        for (size_t cr = 0; cr < 4; ++cr)  // correlation: 00,01,10,11
+        {
+          if (!flag[cr]) {
+            for (size_t tg = 0; tg < nDirection; ++tg) {
+              std::complex<double> visibility(0.0, 0.0);
+              for (size_t dr = 0; dr < nDirection; ++dr) {
+                // Look-up mixing weight.
+                const std::complex<double> mix_weight = *mix;
+
+                // Weight model visibility.
+                visibility += mix_weight * M[dr * 4 + cr];
+
+                // Compute weighted partial derivatives.
+                std::complex<double> derivative(0.0, 0.0);
+                derivative = mix_weight * dM[dr * 16 + cr * 4];
+                dR[dr * 8] = real(derivative);  // for cr==0: Re(d/dRe(p_00)))
+                dI[dr * 8] = imag(derivative);  // for cr==0: Re(d/dIm(p_00)))
+                dR[dr * 8 + 1] =
+                    -imag(derivative);  // for cr==0: Im(d/dRe(p_00)))
+                dI[dr * 8 + 1] =
+                    real(derivative);  // for cr==0: Im(d/dIm(p_00)))
+
+                derivative = mix_weight * dM[dr * 16 + cr * 4 + 1];
+                dR[dr * 8 + 2] =
+                    real(derivative);  // for cr==0: Re(d/dRe(p_01)))
+                dI[dr * 8 + 2] =
+                    imag(derivative);  // for cr==0: Re(d/dIm(p_01)))
+                dR[dr * 8 + 3] =
+                    -imag(derivative);  // for cr==0: Im(d/dRe(p_01)))
+                dI[dr * 8 + 3] =
+                    real(derivative);  // for cr==0: Im(d/dIm(p_01)))
+
+                derivative = mix_weight * dM[dr * 16 + cr * 4 + 2];
+                dR[dr * 8 + 4] =
+                    real(derivative);  // for cr==0: Re(d/dRe(q_00)))
+                dI[dr * 8 + 4] =
+                    imag(derivative);  // for cr==0: Re(d/dIm(q_00)))
+                dR[dr * 8 + 5] =
+                    imag(derivative);  // for cr==0: Im(d/dRe(q_00)))
+                dI[dr * 8 + 5] =
+                    -real(derivative);  // for cr==0: Im(d/dIm(q_00)))
+
+                derivative = mix_weight * dM[dr * 16 + cr * 4 + 3];
+                dR[dr * 8 + 6] =
+                    real(derivative);  // for cr==0: Re(d/dRe(q_01)))
+                dI[dr * 8 + 6] =
+                    imag(derivative);  // for cr==0: Re(d/dIm(q_01)))
+                dR[dr * 8 + 7] =
+                    imag(derivative);  // for cr==0: Im(d/dRe(q_01)))
+                dI[dr * 8 + 7] =
+                    -real(derivative);  // for cr==0: Im(d/dIm(q_01)))
+
+                // Move to next source direction.
+                mix.forward(1);
+              }  // Source directions.
+
+              // Compute the residual.
+              std::complex<double> residual =
+                  std::complex<double>{data[tg][cr]} - visibility;
+
+              // Update the normal equations.
+              add_equation(cr, &(dIndex[cr * nPartial]), &(dR[0]),
+                           double{weight[cr]}, residual.real());
+              add_equation(cr, &(dIndex[cr * nPartial]), &(dI[0]),
+                           double{weight[cr]}, residual.imag());
+
+              // Move to next target direction.
+              mix.backward(1, nDirection);
+              mix.forward(0);
+            }  // Target directions.
+
+            // Reset cursor to the start of the correlation.
+            mix.backward(0, nDirection);
           }
-          flag.forward(1);
-          weight.forward(1);
-        }  // Channels.
 
-        // Reset cursors to the start of the baseline.
+          // Move to the next correlation.
+          mix.forward(2);
+        }  // Correlations.
+
+        // Move to the next channel.
+        mix.backward(2, 4);
+        mix.forward(3);
+
         for (size_t dr = 0; dr < nDirection; ++dr) {
-          model[dr].backward(1, nChannel);
-          data[dr].backward(1, nChannel);
+          model[dr].forward(1);
+          data[dr].forward(1);
         }
-        flag.backward(1, nChannel);
-        weight.backward(1, nChannel);
-        mix.backward(3, nChannel);
-      }
+        flag.forward(1);
+        weight.forward(1);
+      }  // Channels.
 
-      // Move cursors to the next baseline.
+      // Reset cursors to the start of the baseline.
       for (size_t dr = 0; dr < nDirection; ++dr) {
-        model[dr].forward(2);
-        data[dr].forward(2);
+        model[dr].backward(1, nChannel);
+        data[dr].backward(1, nChannel);
       }
-      flag.forward(2);
-      weight.forward(2);
-      mix.forward(4);
-      ++baselines;
-    }  // Baselines.
+      flag.backward(1, nChannel);
+      weight.backward(1, nChannel);
+      mix.backward(3, nChannel);
+
+      end_baseline(*baselines);
+    }
 
-    // Reset all cursors for the next iteration.
+    // Move cursors to the next baseline.
     for (size_t dr = 0; dr < nDirection; ++dr) {
-      model[dr].backward(2, nBaseline);
-      data[dr].backward(2, nBaseline);
+      model[dr].forward(2);
+      data[dr].forward(2);
     }
-    flag.backward(2, nBaseline);
-    weight.backward(2, nBaseline);
-    mix.backward(4, nBaseline);
-    baselines -= nBaseline;
+    flag.forward(2);
+    weight.forward(2);
+    mix.forward(4);
+    ++baselines;
+  }  // Baselines.
+}
+
+}  // namespace
+
+bool estimate(size_t nDirection, size_t nStation, size_t nBaseline,
+              size_t nChannel, const_cursor<Baseline> baselines,
+              std::vector<const_cursor<std::complex<float>>> data,
+              std::vector<const_cursor<std::complex<double>>> model,
+              const_cursor<bool> flag, const_cursor<float> weight,
+              const_cursor<std::complex<double>> mix, double *unknowns,
+              size_t maxiter) {
+  assert(data.size() == nDirection && model.size() == nDirection);
+
+  // Initialize LSQ solver.
+  const size_t nUnknowns = nDirection * nStation * 4 * 2;
+  casacore::LSQFit solver(nUnknowns);
+  const size_t nPartial = nDirection * 8;
+
+  // Iterate until convergence.
+  size_t nIterations = 0;
+  while (!solver.isReady() && nIterations < maxiter) {
+    makeEquations(
+        nDirection, nStation, nBaseline, nChannel, baselines, data, model,
+        flag, weight, mix, unknowns,
+        [&](size_t, const unsigned int *index, const double *derivatives,
+            double eqWeight, double residual) {
+          solver.makeNorm(nPartial, index, derivatives, eqWeight, residual);
+        },
+        [](const Baseline &) {});
 
     // Perform LSQ iteration.
     casacore::uInt rank;
@@ -285,5 +325,133 @@ bool estimate(size_t nDirection, size_t nStation, size_t nBaseline,
   return converged;
 }
 
+bool estimateDense(size_t nDirection, size_t nStation, size_t nBaseline,
+                   size_t nChannel, const_cursor<Baseline> baselines,
+                   std::vector<const_cursor<std::complex<float>>> data,
+                   std::vector<const_cursor<std::complex<double>>> model,
+                   const_cursor<bool> flag, const_cursor<float> weight,
+                   const_cursor<std::complex<double>> mix, double *unknowns,
+                   DenseEstimateWorkspace &workspace, size_t maxiter) {
+  assert(data.size() == nDirection && model.size() == nDirection);
+
+  const size_t nUnknowns = nDirection * nStation * 4 * 2;
+  const size_t nPartial = nDirection * 8;
+  // All equations of a baseline involve the same 16 unknowns per direction:
+  // 8 for station p followed by 8 for station q. The equations of a baseline
+  // are first accumulated in a small local matrix, which is then added to the
+  // (large) normal matrix at once.
+  const size_t nLocal = nDirection * 16;
+
+  // For each correlation, the index of each partial derivative in the local
+  // unknowns. The local index increases with the partial derivative index.
+  std::vector<size_t> localIndex(4 * nPartial);
+  for (size_t cr = 0; cr < 4; ++cr) {
+    for (size_t i = 0; i < nPartial; ++i) {
+      const size_t dr = i / 8;
+      const size_t k = i % 8;
+      localIndex[cr * nPartial + i] =
+          dr * 16 + (k < 4 ? (cr / 2) * 4 + k : 8 + (cr % 2) * 4 + k - 4);
+    }
+  }
+
+  std::vector<double> &normal = workspace.normal_matrix;
+  std::vector<double> &rhs = workspace.rhs;
+  std::vector<double> &local = workspace.local_matrix;
+  std::vector<double> &localRhs = workspace.local_rhs;
+  normal.resize(nUnknowns * nUnknowns);
+  rhs.resize(nUnknowns);
+  local.assign(nLocal * nLocal, 0.0);
+  localRhs.assign(nLocal, 0.0);
+  workspace.previous.assign(unknowns, unknowns + nUnknowns);
+
+  double damping = kInitialDamping;
+  double previousChi2 = std::numeric_limits<double>::infinity();
+  bool converged = false;
+  for (size_t iteration = 0; iteration < maxiter && !converged; ++iteration) {
+    // Accumulate the upper triangle of the normal matrix.
+    std::fill(normal.begin(), normal.end(), 0.0);
+    std::fill(rhs.begin(), rhs.end(), 0.0);
+    double chi2 = 0.0;
+    makeEquations(
+        nDirection, nStation, nBaseline, nChannel, baselines, data, model,
+        flag, weight, mix, unknowns,
+        [&](size_t cr, const unsigned int *, const double *derivatives,
+            double eqWeight, double residual) {
+          const size_t *index = &localIndex[cr * nPartial];
+          chi2 += eqWeight * residual * residual;
+          for (size_t i = 0; i < nPartial; ++i) {
+            const double weighted = eqWeight * derivatives[i];
+            double *column = &local[index[i] * nLocal];
+            localRhs[index[i]] += weighted * residual;
+            for (size_t j = 0; j <= i; ++j) {
+              column[index[j]] += weighted * derivatives[j];
+            }
+          }
+        },
+        [&](const Baseline &baseline) {
+          for (size_t b = 0; b < nLocal; ++b) {
+            const size_t globalB = (b / 16) * nStation * 8 +
+                                   (b % 16 < 8 ? baseline.first * 8 + b % 16
+                                               : baseline.second * 8 +
+                                                     b % 16 - 8);
+            rhs[globalB] += localRhs[b];
+            for (size_t a = 0; a <= b; ++a) {
+              const size_t globalA = (a / 16) * nStation * 8 +
+                                     (a % 16 < 8 ? baseline.first * 8 + a % 16
+                                                 : baseline.second * 8 +
+                                                       a % 16 - 8);
+              normal[std::min(globalA, globalB) +
+                     std::max(globalA, globalB) * nUnknowns] +=
+                  local[a + b * nLocal];
+            }
+          }
+          std::fill(local.begin(), local.end(), 0.0);
+          std::fill(localRhs.begin(), localRhs.end(), 0.0);
+        });
+
+    if (chi2 > previousChi2) {
+      // The last step increased the residual: undo it and retry with a
+      // larger damping in the next iteration.
+      std::copy(workspace.previous.begin(), workspace.previous.end(),
+                unknowns);
+      damping *= kDampingFactor;
+      continue;
+    }
+    if (std::isfinite(previousChi2) && chi2 < previousChi2) {
+      damping = std::max(damping / kDampingFactor, kMinimumDamping);
+    }
+    previousChi2 = chi2;
+    std::copy(unknowns, unknowns + nUnknowns, workspace.previous.begin());
+
+    // Apply the Levenberg-Marquardt damping. Unknowns without equations
+    // (e.g. of flagged stations) are kept constant.
+    for (size_t i = 0; i < nUnknowns; ++i) {
+      double &element = normal[i + i * nUnknowns];
+      element = element == 0.0 ? 1.0 : element * (1.0 + damping);
+    }
+
+    char uplo = 'U';
+    int n = nUnknowns;
+    int nrhs = 1;
+    int info;
+    dposv_(&uplo, &n, &nrhs, normal.data(), &n, rhs.data(), &n, &info);
+    if (info != 0) {
+      damping *= kDampingFactor;
+      continue;
+    }
+
+    double maxStep = 0.0;
+    double maxUnknown = 0.0;
+    for (size_t i = 0; i < nUnknowns; ++i) {
+      unknowns[i] += rhs[i];
+      maxStep = std::max(maxStep, std::abs(rhs[i]));
+      maxUnknown = std::max(maxUnknown, std::abs(unknowns[i]));
+    }
+    converged = maxStep <= kSolutionTolerance * maxUnknown;
+  }
+
+  return converged;
+}
+
 }  // namespace base
 }  // namespace dp3
@@ -63,6 +63,31 @@ bool estimate(size_t nDirection, size_t nStation, size_t nBaseline,
               const_cursor<std::complex<double>> mix, double* unknowns,
               size_t maxiter = 50);
 
+/// Buffers for estimateDense(), which can be reused between calls to avoid
+/// reallocating them.
+struct DenseEstimateWorkspace {
+  /// Normal matrix of size (nDirection * nStation * 8)^2.
+  std::vector<double> normal_matrix;
+  std::vector<double> rhs;
+  std::vector<double> local_matrix;
+  std::vector<double> local_rhs;
+  std::vector<double> previous;
+};
+
+/// Alternative for estimate() that accumulates the normal equations of each
+/// baseline in a small dense matrix, adds it to a dense normal matrix, and
+/// solves that with a LAPACK Cholesky decomposition. The non-linear problem is
+/// solved with Levenberg-Marquardt iterations. This is faster than estimate()
+/// for many stations, at the cost of memory for the normal matrix. The input
+/// variables are the same as for estimate().
+bool estimateDense(size_t nDirection, size_t nStation, size_t nBaseline,
+                   size_t nChannel, const_cursor<Baseline> baselines,
+                   std::vector<const_cursor<std::complex<float>>> data,
+                   std::vector<const_cursor<std::complex<double>>> model,
+                   const_cursor<bool> flag, const_cursor<float> weight,
+                   const_cursor<std::complex<double>> mix, double* unknowns,
+                   DenseEstimateWorkspace& workspace, size_t maxiter = 50);
+
 #ifdef HAVE_LIBDIRAC
 /// method for LBFGS (robust) solver, with extra input variables:
 ///  \param[in] lbfgs_mem
@@ -0,0 +1,508 @@
+// Sharding.cc: Run a pipeline in multiple processes, split over time
+// Copyright (C) 2023 ASTRON (Netherlands Institute for Radio Astronomy)
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "Sharding.h"
+
+#include <dp3/base/DP3.h>
+#include <dp3/base/DPInfo.h>
+
+#include "StManParsetKeys.h"
+
+#include "../common/Numa.h"
+#include "../common/ParameterSet.h"
+#include "../steps/InputStep.h"
+
+#include <aocommon/logger.h>
+#include <aocommon/system.h>
+
+#include <casacore/casa/Arrays/Vector.h>
+#include <casacore/tables/Tables/ArrayColumn.h>
+#include <casacore/tables/Tables/Table.h>
+#include <casacore/tables/Tables/TableCopy.h>
+
+#include <H5Cpp.h>
+
+#include <sched.h>
+#include <spawn.h>
+#include <sys/wait.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+extern char** environ;
+
+namespace dp3 {
+namespace base {
+
+namespace {
+
+std::string ShardName(const std::string& name, std::size_t shard) {
+  return name + ".shard" + std::to_string(shard);
+}
+
+std::vector<std::string> ShardNames(const std::string& name,
+                                    std::size_t n_shards) {
+  std::vector<std::string> names;
+  for (std::size_t shard = 0; shard != n_shards; ++shard) {
+    names.push_back(ShardName(name, shard));
+  }
+  return names;
+}
+
+/// Returns the names of the objects of a given type in an HDF5 group.
+std::vector<std::string> GetMemberNames(const H5::Group& group,
+                                        H5O_type_t type) {
+  std::vector<std::string> names;
+  for (hsize_t i = 0; i != group.getNumObjs(); ++i) {
+    const std::string name = group.getObjnameByIdx(i);
+    if (group.childObjType(name) == type) {
+      names.push_back(name);
+    }
+  }
+  return names;
+}
+
+bool HasMember(const H5::Group& group, const std::string& name) {
+  return H5Lexists(group.getId(), name.c_str(), H5P_DEFAULT) > 0;
+}
+
+/// Returns the axis names of a value dataset of a solution table.
+std::vector<std::string> GetAxisNames(const H5::DataSet& values) {
+  const H5::Attribute attribute = values.openAttribute("AXES");
+  std::string axes;
+  attribute.read(attribute.getStrType(), axes);
+  std::vector<std::string> names;
+  std::istringstream stream(axes);
+  std::string name;
+  while (std::getline(stream, name, ',')) {
+    names.push_back(name);
+  }
+  return names;
+}
+
+/// Concatenates a dataset with the same name in several groups along an
+/// axis, and replaces the dataset in the first group by the result. The
+/// attributes of the dataset in the first group are kept.
+void ConcatenateDataSet(std::vector<H5::Group>& groups,
+                        const std::string& name, std::size_t axis) {
+  std::vector<std::vector<double>> parts;
+  std::vector<hsize_t> merged_shape;
+  std::vector<hsize_t> axis_sizes;
+  for (const H5::Group& group : groups) {
+    const H5::DataSet dataset = group.openDataSet(name);
+    const H5::DataSpace space = dataset.getSpace();
+    std::vector<hsize_t> shape(space.getSimpleExtentNdims());
+    space.getSimpleExtentDims(shape.data());
+    if (axis >= shape.size()) {
+      throw std::runtime_error("Dataset " + name + " of " +
+                               group.getObjName() + " has no axis " +
+                               std::to_string(axis));
+    }
+    axis_sizes.push_back(shape[axis]);
+    if (merged_shape.empty()) {
+      merged_shape = shape;
+    } else {
+      shape[axis] = merged_shape[axis];
+      if (shape != merged_shape) {
+        throw std::runtime_error("Dataset " + name + " of " +
+                                 group.getObjName() +
+                                 " does not match the other shards");
+      }
+      merged_shape[axis] += axis_sizes.back();
+    }
+    parts.emplace_back(space.getSimpleExtentNpoints());
+    dataset.read(parts.back().data(), H5::PredType::NATIVE_DOUBLE);
+  }
+
+  // Interleave the parts: for every index of the axes before the
+  // concatenation axis, append the blocks of all parts.
+  const std::size_t inner_size =
+      std::accumulate(merged_shape.begin() + axis + 1, merged_shape.end(),
+                      std::size_t(1), std::multiplies<std::size_t>());
+  const std::size_t outer_size =
+      std::accumulate(merged_shape.begin(), merged_shape.begin() + axis,
+                      std::size_t(1), std::multiplies<std::size_t>());
+  std::vector<double> merged;
+  merged.reserve(outer_size * merged_shape[axis] * inner_size);
+  for (std::size_t outer = 0; outer != outer_size; ++outer) {
+    for (std::size_t part = 0; part != parts.size(); ++part) {
+      const std::size_t block_size = axis_sizes[part] * inner_size;
+      const auto block = parts[part].begin() + outer * block_size;
+      merged.insert(merged.end(), block, block + block_size);
+    }
+  }
+
+  // Datasets in an H5Parm have a fixed size, so replace the dataset.
+  H5::Group& output = groups.front();
+  H5::DataSet original = output.openDataSet(name);
+  const H5::DataType type = original.getDataType();
+  struct RawAttribute {
+    std::string name;
+    H5::DataType type;
+    H5::DataSpace space;
+    std::string text;
+    std::vector<char> data;
+  };
+  std::vector<RawAttribute> attributes;
+  for (int i = 0; i != original.getNumAttrs(); ++i) {
+    const H5::Attribute attribute = original.openAttribute(i);
+    RawAttribute& raw = attributes.emplace_back();
+    raw.name = attribute.getName();
+    raw.type = attribute.getDataType();
+    raw.space = attribute.getSpace();
+    if (raw.type.getClass() == H5T_STRING) {
+      attribute.read(attribute.getStrType(), raw.text);
+    } else {
+      raw.data.resize(raw.type.getSize() * raw.space.getSimpleExtentNpoints());
+      attribute.read(raw.type, raw.data.data());
+    }
+  }
+  original.close();
+  output.unlink(name);
+
+  const H5::DataSet replacement = output.createDataSet(
+      name, type, H5::DataSpace(merged_shape.size(), merged_shape.data()));
+  replacement.write(merged.data(), H5::PredType::NATIVE_DOUBLE);
+  for (const RawAttribute& raw : attributes) {
+    H5::Attribute attribute =
+        replacement.createAttribute(raw.name, raw.type, raw.space);
+    if (raw.type.getClass() == H5T_STRING) {
+      attribute.write(attribute.getStrType(), raw.text);
+    } else {
+      attribute.write(raw.type, raw.data.data());
+    }
+  }
+}
+
+}  // namespace
+
+std::vector<std::pair<std::size_t, std::size_t>> DivideTimeSlots(
+    std::size_t n_times, std::size_t n_shards, std::size_t granularity) {
+  granularity = std::max<std::size_t>(granularity, 1);
+  n_shards = std::max<std::size_t>(n_shards, 1);
+  const std::size_t n_blocks = (n_times + granularity - 1) / granularity;
+  std::vector<std::pair<std::size_t, std::size_t>> shards;
+  for (std::size_t shard = 0; shard != n_shards; ++shard) {
+    const std::size_t start =
+        std::min(shard * n_blocks / n_shards * granularity, n_times);
+    const std::size_t end =
+        std::min((shard + 1) * n_blocks / n_shards * granularity, n_times);
+    if (end > start) {
+      shards.emplace_back(start, end - start);
+    }
+  }
+  return shards;
+}
+
+std::size_t GetShardGranularity(const common::ParameterSet& parset) {
+  std::size_t granularity = 1;
+  // Number of input time slots per time slot of the current step.
+  std::size_t time_factor = 1;
+  for (const std::string& name :
+       parset.getStringVector("steps", std::vector<std::string>())) {
+    const std::string prefix = name + '.';
+    const std::string type = GetStepType(parset, name);
+    if (type == "averager" || type == "average" || type == "squash") {
+      if (parset.getDouble(prefix + "timeresolution", 0.0) > 0.0) {
+        throw std::runtime_error("Sharding requires " + prefix +
+                                 "timestep instead of " + prefix +
+                                 "timeresolution");
+      }
+      time_factor *= std::max(1u, parset.getUint(prefix + "timestep", 1));
+      granularity = std::lcm(granularity, time_factor);
+    } else if (type == "ddecal" || type == "gaincal" || type == "calibrate") {
+      const unsigned int solution_interval =
+          parset.getUint(prefix + "solint", 1);
+      if (solution_interval == 0) {
+        throw std::runtime_error("Sharding cannot split the single solution "
+                                 "interval of step " +
+                                 name);
+      }
+      granularity = std::lcm(granularity, time_factor * solution_interval);
+    } else if (type == "demixer" || type == "demix") {
+      if (parset.getDouble(prefix + "demixtimeresolution", 0.0) > 0.0) {
+        throw std::runtime_error("Sharding requires " + prefix +
+                                 "demixtimestep instead of " + prefix +
+                                 "demixtimeresolution");
+      }
+      const unsigned int time_step =
+          std::max(1u, parset.getUint(prefix + "timestep", 1));
+      const unsigned int demix_time_step =
+          std::max(1u, parset.getUint(prefix + "demixtimestep", time_step));
+      granularity = std::lcm(granularity, time_factor * demix_time_step);
+      time_factor *= time_step;
+      granularity = std::lcm(granularity, time_factor);
+    } else if (type == "upsample" || type == "bdaaverager" ||
+               type == "bdaaverage" || type == "out" || type == "output" ||
+               type == "msout" || type == "split" || type == "explode") {
+      // Split steps may contain output steps and steps that change the time
+      // resolution in their sub-steps.
+      throw std::runtime_error("Sharding does not support step " + name +
+                               " of type " + type);
+    } else if (type == "madflagger" || type == "madflag" ||
+               type == "aoflagger" || type == "aoflag" ||
+               type == "interpolate") {
+      // These steps use a window of time slots around every time slot, which
+      // would be cut off at the shard boundaries.
+      throw std::runtime_error("Sharding does not support step " + name +
+                               " of type " + type +
+                               ", because its result would depend on the "
+                               "shard boundaries");
+    }
+  }
+  return granularity;
+}
+
+void ExecuteSharded(const common::ParameterSet& parset, std::size_t n_shards) {
+  const std::string out_key =
+      parset.isDefined("msout.name") ? "msout.name" : "msout";
+  const std::string out_name = parset.getString(out_key, "");
+  if (out_name.empty() || out_name == ".") {
+    throw std::runtime_error("Sharding requires a new output MS");
+  }
+  if (parset.getDouble("msout.chunkduration", 0.0) != 0.0) {
+    throw std::runtime_error(
+        "Sharding cannot be combined with msout.chunkduration");
+  }
+  if (parset.isDefined("msin.starttime") || parset.isDefined("msin.endtime")) {
+    throw std::runtime_error(
+        "Sharding requires msin.starttimeslot and msin.ntimes instead of "
+        "msin.starttime and msin.endtime");
+  }
+  if (StManParsetKeys(parset, "msout.").stManName == "dysco") {
+    // Merging the shards copies the rows of all but the first shard, which
+    // would compress the already compressed data again.
+    throw std::runtime_error(
+        "Sharding does not support Dysco compression of the output");
+  }
+  const std::size_t granularity = GetShardGranularity(parset);
+
+  // Every shard writes its own solution files.
+  std::vector<std::pair<std::string, std::string>> solution_files;
+  const std::string msin = parset.getString("msin");
+  for (const std::string& name :
+       parset.getStringVector("steps", std::vector<std::string>())) {
+    const std::string type = GetStepType(parset, name);
+    if (type == "ddecal") {
+      const std::string file_name =
+          parset.getString(name + ".h5parm", msin + "/instrument.h5");
+      if (!file_name.empty()) {
+        solution_files.emplace_back(name + ".h5parm", file_name);
+      }
+    } else if (type == "gaincal" || type == "calibrate") {
+      const std::string file_name =
+          parset.getString(name + ".parmdb", msin + "/instrument");
+      if (file_name.find(".h5") == std::string::npos) {
+        throw std::runtime_error("Sharding requires H5Parm output for step " +
+                                 name);
+      }
+      solution_files.emplace_back(name + ".parmdb", file_name);
+    }
+  }
+
+  std::size_t n_times = 0;
+  {
+    const std::unique_ptr<steps::InputStep> reader =
+        steps::InputStep::CreateReader(parset);
+    n_times = reader->getInfo().ntime();
+  }
+  // Like the MSReader, accept a negative start time slot, which inserts time
+  // slots before the start of the MS. The reader above counted those too, so
+  // the start time slot of a shard is this offset plus the shard offset.
+  const int first_time_slot = parset.getInt("msin.starttimeslot", 0);
+  const std::vector<std::pair<std::size_t, std::size_t>> shards =
+      DivideTimeSlots(n_times, n_shards, granularity);
+  if (shards.empty()) {
+    throw std::runtime_error("Sharding found no time slots to process in " +
+                             msin);
+  }
+  aocommon::Logger::Info << "Processing " << n_times << " time slots in "
+                         << shards.size() << " shards of multiples of "
+                         << granularity << " time slots ...\n";
+
+  // Give the workers an equal part of the cpus. In NUMA-aware mode, each
+  // worker gets its own cpus, preferably on a single NUMA node. Spawned
+  // processes inherit the cpu affinity of the spawning thread.
+  const std::size_t n_threads =
+      parset.isDefined("numthreads")
+          ? parset.getUint("numthreads")
+          : std::max<std::size_t>(
+                1, aocommon::system::ProcessorCount() / shards.size());
+  std::vector<int> cpus;
+  cpu_set_t original_cpus;
+  CPU_ZERO(&original_cpus);
+  if (parset.getBool("numa", false) &&
+      sched_getaffinity(0, sizeof(original_cpus), &original_cpus) == 0) {
+    std::size_t n_nodes = 0;
+    cpus = common::GetNumaOrderedCpus(n_nodes);
+  }
+
+  const std::string executable =
+      parset.getString("shardexecutable", "/proc/self/exe");
+  const std::vector<std::string> out_names =
+      ShardNames(out_name, shards.size());
+  std::vector<std::string> parset_names;
+  std::vector<pid_t> workers;
+  std::string spawn_error;
+  for (std::size_t shard = 0; shard != shards.size(); ++shard) {
+    common::ParameterSet shard_parset = parset.makeSubset("");
+    shard_parset.replace("shards", "1");
+    if (shard_parset.isDefined("shardexecutable")) {
+      shard_parset.remove("shardexecutable");
+    }
+    shard_parset.replace("showprogress", "false");
+    shard_parset.replace("numthreads", std::to_string(n_threads));
+    const int start_time_slot =
+        first_time_slot + static_cast<int>(shards[shard].first);
+    shard_parset.replace("msin.starttimeslot", std::to_string(start_time_slot));
+    shard_parset.replace("msin.ntimes", std::to_string(shards[shard].second));
+    shard_parset.replace(out_key, out_names[shard]);
+    for (const auto& [key, file_name] : solution_files) {
+      shard_parset.replace(key, ShardName(file_name, shard));
+    }
+    parset_names.push_back(out_names[shard] + ".parset");
+    shard_parset.writeFile(parset_names.back());
+
+    if (!cpus.empty()) {
+      const std::size_t begin = shard * cpus.size() / shards.size();
+      const std::size_t end = std::max(
+          begin + 1, (shard + 1) * cpus.size() / shards.size());
+      cpu_set_t worker_cpus;
+      CPU_ZERO(&worker_cpus);
+      for (std::size_t i = begin; i != end; ++i) {
+        CPU_SET(cpus[i], &worker_cpus);
+      }
+      sched_setaffinity(0, sizeof(worker_cpus), &worker_cpus);
+    }
+
+    std::vector<char*> arguments{const_cast<char*>(executable.c_str()),
+                                 const_cast<char*>(parset_names.back().c_str()),
+                                 nullptr};
+    pid_t pid;
+    const int error = posix_spawn(&pid, executable.c_str(), nullptr, nullptr,
+                                  arguments.data(), environ);
+    if (error != 0) {
+      spawn_error = "Could not start " + executable + ": " +
+                    std::string(std::strerror(error));
+      break;
+    }
+    workers.push_back(pid);
+  }
+  if (!cpus.empty()) {
+    sched_setaffinity(0, sizeof(original_cpus), &original_cpus);
+  }
+
+  std::size_t n_failed = 0;
+  for (pid_t pid : workers) {
+    int status = 0;
+    if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) ||
+        WEXITSTATUS(status) != 0) {
+      ++n_failed;
+    }
+  }
+  if (!spawn_error.empty()) {
+    throw std::runtime_error(spawn_error);
+  }
+  if (n_failed != 0) {
+    throw std::runtime_error(std::to_string(n_failed) + " of " +
+                             std::to_string(workers.size()) +
+                             " shards failed; their output is kept");
+  }
+
+  aocommon::Logger::Info << "Merging the output of the shards ...\n";
+  MergeMeasurementSets(out_names, out_name,
+                       parset.getBool("msout.overwrite", false));
+  for (const auto& [key, file_name] : solution_files) {
+    const std::vector<std::string> names =
+        ShardNames(file_name, shards.size());
+    MergeH5Parms(names, file_name);
+    for (const std::string& name : names) std::filesystem::remove(name);
+  }
+  for (std::size_t shard = 0; shard != shards.size(); ++shard) {
+    std::filesystem::remove_all(out_names[shard]);
+    std::filesystem::remove(parset_names[shard]);
+  }
+}
+
+void MergeMeasurementSets(const std::vector<std::string>& input_names,
+                          const std::string& output_name, bool overwrite) {
+  if (input_names.empty()) {
+    throw std::runtime_error("No MeasurementSets to merge into " +
+                             output_name);
+  }
+  casacore::Table(input_names.front())
+      .deepCopy(output_name, overwrite ? casacore::Table::New
+                                       : casacore::Table::NewNoReplace);
+  casacore::Table merged(output_name, casacore::Table::Update);
+  for (std::size_t i = 1; i < input_names.size(); ++i) {
+    const casacore::Table shard(input_names[i]);
+    const casacore::rownr_t start = merged.nrow();
+    merged.addRow(shard.nrow());
+    casacore::TableCopy::copyRows(merged, shard, start, 0, shard.nrow());
+  }
+  merged.flush();
+
+  // The observation ends at the end of the last MS.
+  if (input_names.size() > 1) {
+    const casacore::Table last_observation(input_names.back() +
+                                           "/OBSERVATION");
+    casacore::Table observation(output_name + "/OBSERVATION",
+                                casacore::Table::Update);
+    if (observation.nrow() > 0 && last_observation.nrow() > 0) {
+      casacore::ArrayColumn<double> time_range(observation, "TIME_RANGE");
+      casacore::Vector<double> range = time_range(0);
+      range[1] = casacore::ArrayColumn<double>(last_observation,
+                                               "TIME_RANGE")(0)
+                     .data()[1];
+      time_range.put(0, range);
+    }
+  }
+}
+
+void MergeH5Parms(const std::vector<std::string>& input_names,
+                  const std::string& output_name) {
+  if (input_names.empty()) {
+    throw std::runtime_error("No H5Parm files to merge into " + output_name);
+  }
+  std::filesystem::copy_file(input_names.front(), output_name,
+                             std::filesystem::copy_options::overwrite_existing);
+  H5::H5File merged(output_name, H5F_ACC_RDWR);
+  std::vector<H5::H5File> others;
+  for (std::size_t i = 1; i < input_names.size(); ++i) {
+    others.emplace_back(input_names[i], H5F_ACC_RDONLY);
+  }
+
+  const H5::Group root = merged.openGroup("/");
+  for (const std::string& solset_name :
+       GetMemberNames(root, H5O_TYPE_GROUP)) {
+    const H5::Group solset = merged.openGroup(solset_name);
+    for (const std::string& soltab_name :
+         GetMemberNames(solset, H5O_TYPE_GROUP)) {
+      const std::string path = solset_name + '/' + soltab_name;
+      std::vector<H5::Group> groups{merged.openGroup(path)};
+      if (!HasMember(groups.front(), "val")) continue;
+      const std::vector<std::string> axes =
+          GetAxisNames(groups.front().openDataSet("val"));
+      const auto time_axis = std::find(axes.begin(), axes.end(), "time");
+      if (time_axis == axes.end()) continue;
+
+      for (const H5::H5File& file : others) {
+        groups.push_back(file.openGroup(path));
+      }
+      const std::size_t axis = time_axis - axes.begin();
+      ConcatenateDataSet(groups, "val", axis);
+      if (HasMember(groups.front(), "weight")) {
+        ConcatenateDataSet(groups, "weight", axis);
+      }
+      ConcatenateDataSet(groups, "time", 0);
+    }
+  }
+}
+
+}  // namespace base
+}  // namespace dp3
@@ -0,0 +1,69 @@
+// Sharding.h: Run a pipeline in multiple processes, split over time
+// Copyright (C) 2023 ASTRON (Netherlands Institute for Radio Astronomy)
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/// @file
+/// @brief Run a pipeline in multiple processes, split over time
+
+#ifndef DP3_BASE_SHARDING_H_
+#define DP3_BASE_SHARDING_H_
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace dp3 {
+namespace common {
+class ParameterSet;
+}
+
+namespace base {
+
+/**
+ * Divides time slots evenly over shards, such that shard boundaries are at
+ * multiples of a granularity.
+ * @return The start time slot and number of time slots of each shard. Shards
+ * that would be empty are left out.
+ */
+std::vector<std::pair<std::size_t, std::size_t>> DivideTimeSlots(
+    std::size_t n_times, std::size_t n_shards, std::size_t granularity);
+
+/**
+ * Determines the number of input time slots that a shard boundary should be
+ * a multiple of, such that it does not split averaged time slots or solution
+ * intervals of ddecal, gaincal and demixer steps.
+ * @throw std::runtime_error If the steps cannot be sharded, which includes
+ * steps whose result depends on neighbouring time slots, like flaggers.
+ */
+std::size_t GetShardGranularity(const common::ParameterSet& parset);
+
+/**
+ * Runs the pipeline of a parset in local worker processes, which each
+ * process a shard of the time slots and write their own output. Afterwards,
+ * the output MS and H5Parm files of the shards are merged in the order of
+ * the shards, which makes the result independent of the timing of the
+ * workers.
+ * @param n_shards The (maximum) number of worker processes.
+ */
+void ExecuteSharded(const common::ParameterSet& parset, std::size_t n_shards);
+
+/**
+ * Merges MeasurementSets by appending the rows of the other MSs to a copy of
+ * the first. Subtables are taken from the first MS.
+ */
+void MergeMeasurementSets(const std::vector<std::string>& input_names,
+                          const std::string& output_name, bool overwrite);
+
+/**
+ * Merges H5Parm files by concatenating the values and weights of every
+ * solution table with a time axis along that axis. Other solution tables
+ * are taken from the first file.
+ */
+void MergeH5Parms(const std::vector<std::string>& input_names,
+                  const std::string& output_name);
+
+}  // namespace base
+}  // namespace dp3
+
+#endif
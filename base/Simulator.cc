@@ -6,6 +6,8 @@
 //
 // $Id$
 
+#include <cmath>
+
 #include <casacore/casa/Arrays/MatrixMath.h>
 #include <casacore/casa/BasicSL/Constants.h>
 
@@ -21,6 +23,13 @@ namespace base {
 
 namespace {
 
+/// Number of channels after which the channel phasors of a station are
+/// computed exactly again, when the channels are evenly spaced.
+constexpr size_t kPhasorAnchorInterval = 16;
+
+/// Relative tolerance for considering the channel frequencies evenly spaced.
+constexpr double kRegularFreqTolerance = 1.0e-10;
+
 /**
  * Compute station phase shifts.
  *
@@ -34,13 +43,17 @@ namespace {
  * @param lmn LMN coordinates of source, should be length 3
  * @param uvw Station UVW coordinates, matrix of shape (3, nSt)
  * @param freq Channel frequencies, should be length nChannel
+ * @param freqStep Channel frequency step if the channels are evenly spaced,
+ * or zero otherwise. For evenly spaced channels, the phasors of most channels
+ * are computed by rotating the phasor of the previous channel, which avoids
+ * evaluating sin() and cos() for every channel.
  * @param shift Output matrix (2 for real,imag), shift per station, matrix of
  * shape (3, nSt)
  * @param stationPhases Output vector, store per station \f$(x_1,y_1)\f$
  */
 void phases(size_t nStation, size_t nChannel, const double* lmn,
             const xt::xtensor<double, 2>& uvw,
-            const casacore::Vector<double>& freq,
+            const casacore::Vector<double>& freq, double freqStep,
             Simulator::DuoMatrix<double>& shift,
             std::vector<double>& stationPhases);
 
@@ -73,6 +86,16 @@ Simulator::Simulator(const Direction& reference, size_t nStation,
       itsSpectrumBuffer() {
   itsShiftBuffer.resize(itsNChannel, nStation);
   itsStationPhases.resize(nStation);
+
+  if (itsNChannel > 1) {
+    const double step = (freq[itsNChannel - 1] - freq[0]) / (itsNChannel - 1);
+    bool is_regular = step != 0.0;
+    for (size_t ch = 1; ch < itsNChannel && is_regular; ++ch) {
+      is_regular = std::abs(freq[ch] - freq[ch - 1] - step) <=
+                   kRegularFreqTolerance * std::abs(step);
+    }
+    if (is_regular) itsFreqStep = step;
+  }
   if (stokesIOnly) {
     itsSpectrumBuffer.resize(1, itsNChannel);
   } else {
@@ -91,8 +114,8 @@ void Simulator::visit(const PointSource& component) {
   radec2lmn(itsReference, component.direction(), lmn);
 
   // Compute station phase shifts.
-  phases(itsNStation, itsNChannel, lmn, *itsStationUVW, itsFreq, itsShiftBuffer,
-         itsStationPhases);
+  phases(itsNStation, itsNChannel, lmn, *itsStationUVW, itsFreq, itsFreqStep,
+         itsShiftBuffer, itsStationPhases);
 
   // Compute component spectrum.
   spectrum(component, itsNChannel, itsFreq, itsSpectrumBuffer, itsStokesIOnly);
@@ -252,8 +275,8 @@ void Simulator::visit(const GaussianSource& component) {
   radec2lmn(itsReference, component.direction(), lmn);
 
   // Compute station phase shifts.
-  phases(itsNStation, itsNChannel, lmn, *itsStationUVW, itsFreq, itsShiftBuffer,
-         itsStationPhases);
+  phases(itsNStation, itsNChannel, lmn, *itsStationUVW, itsFreq, itsFreqStep,
+         itsShiftBuffer, itsStationPhases);
 
   // Compute component spectrum.
   spectrum(component, itsNChannel, itsFreq, itsSpectrumBuffer, itsStokesIOnly);
@@ -432,7 +455,7 @@ inline float computeSmearterm(double uvw, double halfwidth) {
 // Compute station phase shifts.
 inline void phases(size_t nStation, size_t nChannel, const double* lmn,
                    const xt::xtensor<double, 2>& uvw,
-                   const casacore::Vector<double>& freq,
+                   const casacore::Vector<double>& freq, double freqStep,
                    Simulator::DuoMatrix<double>& shift,
                    std::vector<double>& stationPhases) {
   double* shiftdata_re = shift.realdata();
@@ -444,6 +467,31 @@ inline void phases(size_t nStation, size_t nChannel, const double* lmn,
                                 uvw(st, 2) * (lmn[2] - 1.0));
   }
 
+  if (freqStep != 0.0) {
+    for (size_t st = 0; st < nStation; ++st) {
+      const double step_re = std::cos(stationPhases[st] * freqStep);
+      const double step_im = std::sin(stationPhases[st] * freqStep);
+      double phasor_re = 0.0;
+      double phasor_im = 0.0;
+      for (size_t ch = 0; ch < nChannel; ++ch) {
+        if (ch % kPhasorAnchorInterval == 0) {
+          // Compute the phasor exactly now and then, to avoid accumulating
+          // rounding errors.
+          const double phase = stationPhases[st] * freq[ch];
+          phasor_re = std::cos(phase);
+          phasor_im = std::sin(phase);
+        } else {
+          const double rotated_re = phasor_re * step_re - phasor_im * step_im;
+          phasor_im = phasor_re * step_im + phasor_im * step_re;
+          phasor_re = rotated_re;
+        }
+        *shiftdata_re++ = phasor_re;
+        *shiftdata_im++ = phasor_im;
+      }  // Channels.
+    }    // Stations.
+    return;
+  }
+
   std::vector<double> phase_terms(nChannel);
   // Note that sincos() does not vectorize yet, and
   // separate sin() cos() is merged to sincos() by the compiler.
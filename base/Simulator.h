@@ -169,6 +169,8 @@ class Simulator : public ModelComponentVisitor {
   std::vector<Baseline> itsBaselines;
   casacore::Vector<double> itsFreq;
   casacore::Vector<double> itsChanWidths;
+  /// Channel frequency step if the channels are evenly spaced, otherwise zero.
+  double itsFreqStep = 0.0;
   /// Non-owning pointer to UVW values for each station. The user of Simulator
   /// supplies them in the constructor, and ensures they remain valid.
   /// Using a pointer avoids copying the values.
@@ -11,13 +11,17 @@
 
 #include "../parmdb/SourceDB.h"
 #include "../parmdb/SkymodelToSourceDB.h"
+#include "../parmdb/SkymodelCache.h"
 
 #include "../common/ParameterValue.h"
 #include "../common/ProximityClustering.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <mutex>
 #include <numeric>
+#include <optional>
 #include <set>
 #include <vector>
 
@@ -264,6 +268,36 @@ std::vector<std::shared_ptr<Patch>> clusterProximateSources(
   return clusteredPatchList;
 }
 
+std::vector<std::shared_ptr<Patch>> RemoveFaintComponents(
+    const std::vector<std::shared_ptr<Patch>>& patch_list, double min_flux) {
+  std::vector<std::shared_ptr<Patch>> result;
+  result.reserve(patch_list.size());
+  for (const std::shared_ptr<Patch>& patch : patch_list) {
+    std::vector<std::shared_ptr<ModelComponent>> components;
+    components.reserve(patch->nComponents());
+    for (const std::shared_ptr<ModelComponent>& component : *patch) {
+      // GaussianSource derives from PointSource, so this covers all
+      // component types that have a flux.
+      const auto* point_source =
+          dynamic_cast<const PointSource*>(component.get());
+      if (!point_source || std::abs(point_source->stokes().I) >= min_flux) {
+        components.push_back(component);
+      }
+    }
+
+    if (components.size() == patch->nComponents()) {
+      result.push_back(patch);
+    } else if (!components.empty()) {
+      auto culled_patch = std::make_shared<Patch>(
+          patch->name(), components.begin(), components.end());
+      culled_patch->setDirection(patch->direction());
+      culled_patch->setBrightness(patch->brightness());
+      result.push_back(std::move(culled_patch));
+    }
+  }
+  return result;
+}
+
 std::vector<string> makePatchList(parmdb::SourceDB& sourceDB,
                                   std::vector<string> patterns) {
   if (patterns.empty()) {
@@ -407,9 +441,18 @@ bool CheckAnyOrientationIsAbsolute(
 
 SourceDBWrapper::SourceDBWrapper(const std::string& source_db_name) {
   if (HasSkymodelExtension(source_db_name)) {
-    source_db_ = parmdb::skymodel_to_source_db::MakeSourceDBSkymodel(
-        source_db_name,
-        parmdb::skymodel_to_source_db::ReadFormat("", source_db_name));
+    const std::string format =
+        parmdb::skymodel_to_source_db::ReadFormat("", source_db_name);
+    std::optional<parmdb::SourceDBSkymodel> cached =
+        parmdb::skymodel_cache::Read(
+            parmdb::skymodel_cache::CacheFilename(source_db_name),
+            source_db_name, format);
+    if (cached) {
+      source_db_ = std::move(*cached);
+    } else {
+      source_db_ = parmdb::skymodel_to_source_db::MakeSourceDBSkymodel(
+          source_db_name, format);
+    }
   } else {
     source_db_ =
         parmdb::SourceDB(parmdb::ParmDBMeta("", source_db_name), true, false);
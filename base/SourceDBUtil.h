@@ -55,6 +55,12 @@ std::vector<std::shared_ptr<Patch>> clusterProximateSources(
     const std::vector<std::shared_ptr<Patch>> &patchList,
     double proximityLimit);
 
+/// From a given patch list, create a new one without the components whose
+/// absolute Stokes I flux at the reference frequency is below @p min_flux
+/// (in Jy). Patches without remaining components are removed.
+std::vector<std::shared_ptr<Patch>> RemoveFaintComponents(
+    const std::vector<std::shared_ptr<Patch>> &patch_list, double min_flux);
+
 std::vector<std::string> makePatchList(parmdb::SourceDB &sourceDB,
                                        std::vector<std::string> patterns);
 
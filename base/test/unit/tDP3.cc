@@ -18,8 +18,15 @@
 #include <iostream>
 #include <filesystem>
 #include <stdexcept>
+#include <typeindex>
 
+#include "../../../steps/Averager.h"
+#include "../../../steps/Filter.h"
+#include "../../../steps/FusedStep.h"
+#include "../../../steps/MSWriter.h"
 #include "../../../steps/NullStep.h"
+#include "../../../steps/NullStokes.h"
+#include "../../../steps/ScaleData.h"
 #include "../../../steps/test/unit/mock/MockInput.h"
 #include "../../../steps/test/unit/mock/ThrowStep.h"
 
@@ -1132,6 +1139,130 @@ BOOST_FIXTURE_TEST_CASE(test_filter_keep_baselines, FixtureDirectory) {
   }
 }
 
+BOOST_FIXTURE_TEST_CASE(test_filter_pushdown, FixtureDirectory) {
+  // The selection of a leading filter is applied by the reader. An empty
+  // corrtype key prevents that, which gives the reference output.
+  for (const bool pushdown : {true, false}) {
+    const std::string output_ms =
+        std::string("tNDPPP_tmp.pushdown.") + (pushdown ? "1" : "0") + ".MS";
+    {
+      std::ofstream ostr(kParsetFile);
+      ostr << "checkparset=1\n";
+      ostr << "msin=" << kInputMs << '\n';
+      ostr << "msout=" << output_ms << '\n';
+      ostr << "msout.overwrite=true\n";
+      ostr << "steps=[filter]\n";
+      ostr << "filter.baseline=!RT[16]&&*\n";
+      ostr << "filter.startchan=2\n";
+      ostr << "filter.nchan=nchan/2\n";
+      if (!pushdown) ostr << "filter.corrtype=''\n";
+    }
+    {
+      const common::ParameterSet parset(kParsetFile);
+      std::shared_ptr<steps::InputStep> reader =
+          dp3::base::MakeMainSteps(parset);
+      BOOST_CHECK_EQUAL(
+          dynamic_cast<steps::Filter*>(reader->getNextStep().get()) == nullptr,
+          pushdown);
+    }
+    dp3::base::Execute(kParsetFile);
+  }
+
+  Table reference("tNDPPP_tmp.pushdown.0.MS");
+  Table pushed_down("tNDPPP_tmp.pushdown.1.MS");
+  BOOST_REQUIRE_EQUAL(pushed_down.nrow(), reference.nrow());
+  BOOST_CHECK_EQUAL(ArrayColumn<Complex>(pushed_down, "DATA").shape(0),
+                    IPosition(2, 4, 8));
+  BOOST_CHECK(allEQ(ArrayColumn<Complex>(pushed_down, "DATA").getColumn(),
+                    ArrayColumn<Complex>(reference, "DATA").getColumn()));
+  BOOST_CHECK(allEQ(ArrayColumn<bool>(pushed_down, "FLAG").getColumn(),
+                    ArrayColumn<bool>(reference, "FLAG").getColumn()));
+  BOOST_CHECK(allEQ(ScalarColumn<int>(pushed_down, "ANTENNA2").getColumn(),
+                    ScalarColumn<int>(reference, "ANTENNA2").getColumn()));
+}
+
+BOOST_FIXTURE_TEST_CASE(test_fuse_steps, FixtureDirectory) {
+  // Only series of at least two consecutive steps that support baseline
+  // tiles are fused. The fused chain should give the same output.
+  for (const bool fuse : {true, false}) {
+    const std::string output_ms =
+        std::string("tNDPPP_tmp.fused.") + (fuse ? "1" : "0") + ".MS";
+    {
+      std::ofstream ostr(kParsetFile);
+      ostr << "checkparset=1\n";
+      ostr << "fusesteps=" << (fuse ? "true" : "false") << '\n';
+      ostr << "msin=" << kInputMs << '\n';
+      ostr << "msout=" << output_ms << '\n';
+      ostr << "msout.overwrite=true\n";
+      ostr << "steps=[scaledata,nullstokes,avg1,scaledata,avg2,nullstokes,"
+              "scaledata]\n";
+      ostr << "scaledata.coeffs=2\n";
+      ostr << "scaledata.stations=*\n";
+      ostr << "scaledata.scalesize=false\n";
+      ostr << "nullstokes.modify_q=true\n";
+      ostr << "avg1.type=average\n";
+      ostr << "avg1.freqstep=2\n";
+      ostr << "avg2.type=average\n";
+      ostr << "avg2.timestep=2\n";
+    }
+    if (fuse) {
+      const common::ParameterSet parset(kParsetFile);
+      std::shared_ptr<steps::InputStep> reader =
+          dp3::base::MakeMainSteps(parset);
+      std::vector<std::type_index> types;
+      for (std::shared_ptr<steps::Step> step = reader->getNextStep(); step;
+           step = step->getNextStep()) {
+        const steps::Step& step_reference = *step;
+        types.emplace_back(typeid(step_reference));
+      }
+      const std::vector<std::type_index> expected_types{
+          typeid(steps::FusedStep), typeid(steps::ScaleData),
+          typeid(steps::NullStokes), typeid(steps::Averager),
+          typeid(steps::ScaleData), typeid(steps::Averager),
+          typeid(steps::FusedStep), typeid(steps::NullStokes),
+          typeid(steps::ScaleData), typeid(steps::MSWriter),
+          typeid(steps::NullStep)};
+      BOOST_CHECK(types == expected_types);
+    }
+    dp3::base::Execute(kParsetFile);
+  }
+
+  Table unfused("tNDPPP_tmp.fused.0.MS");
+  Table fused("tNDPPP_tmp.fused.1.MS");
+  BOOST_REQUIRE_EQUAL(fused.nrow(), unfused.nrow());
+  BOOST_CHECK(allEQ(ArrayColumn<Complex>(fused, "DATA").getColumn(),
+                    ArrayColumn<Complex>(unfused, "DATA").getColumn()));
+  BOOST_CHECK(allEQ(ArrayColumn<bool>(fused, "FLAG").getColumn(),
+                    ArrayColumn<bool>(unfused, "FLAG").getColumn()));
+}
+
+BOOST_FIXTURE_TEST_CASE(test_time_block, FixtureDirectory) {
+  // Reading blocks of time slots should give the same output as reading
+  // the time slots one by one. A block size of 4 does not divide the
+  // number of time slots.
+  for (const unsigned int time_block : {1, 4}) {
+    {
+      std::ofstream ostr(kParsetFile);
+      ostr << "checkparset=1\n";
+      ostr << "msin=" << kInputMs << '\n';
+      ostr << "msin.startchan=1\n";
+      ostr << "msin.timeblock=" << time_block << '\n';
+      ostr << "msout=tNDPPP_tmp.timeblock." << time_block << ".MS\n";
+      ostr << "msout.overwrite=true\n";
+      ostr << "steps=[]\n";
+    }
+    dp3::base::Execute(kParsetFile);
+  }
+
+  Table reference("tNDPPP_tmp.timeblock.1.MS");
+  Table blocked("tNDPPP_tmp.timeblock.4.MS");
+  BOOST_REQUIRE_EQUAL(blocked.nrow(), reference.nrow());
+  BOOST_CHECK(allEQ(ArrayColumn<Complex>(blocked, "DATA").getColumn(),
+                    ArrayColumn<Complex>(reference, "DATA").getColumn()));
+  BOOST_CHECK(allEQ(ArrayColumn<bool>(blocked, "FLAG").getColumn(),
+                    ArrayColumn<bool>(reference, "FLAG").getColumn()));
+}
+
 BOOST_FIXTURE_TEST_CASE(test_filter_different_data_column, FixtureCopyInput) {
   // Remove some baselines, update original file with different data column
   // This test justs tests if it runs without throwing exceptions
@@ -4,6 +4,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include <xtensor/xio.hpp>
+#include <xtensor/xview.hpp>
 
 #include <dp3/base/DPBuffer.h>
 
@@ -391,4 +392,37 @@ BOOST_AUTO_TEST_CASE(take_weights) {
   BOOST_CHECK_EQUAL(result, expected);
 }
 
+BOOST_AUTO_TEST_CASE(select_channels) {
+  DPBuffer buffer = CreateFilledBuffer();
+  for (std::size_t i = 0; i < buffer.GetData().size(); ++i) {
+    buffer.GetData().data()[i] = std::complex<float>(i, -1.0f * i);
+    buffer.GetWeights().data()[i] = i;
+    buffer.GetFlags().data()[i] = (i % 3 == 0);
+  }
+  const auto channels = xt::range(1, kNChannels);
+  const xt::xtensor<std::complex<float>, 3> data =
+      xt::view(buffer.GetData(), xt::all(), channels, xt::all());
+  const xt::xtensor<bool, 3> flags =
+      xt::view(buffer.GetFlags(), xt::all(), channels, xt::all());
+  const xt::xtensor<float, 3> weights =
+      xt::view(buffer.GetWeights(), xt::all(), channels, xt::all());
+  const double* uvw = buffer.GetUvw().data();
+
+  buffer.SelectChannels(1, kNChannels - 1);
+  const std::array<std::size_t, 3> shape{kNBaselines, kNChannels - 1,
+                                         kNCorrelations};
+  BOOST_CHECK_EQUAL(buffer.GetData(), data);
+  BOOST_CHECK_EQUAL(buffer.GetFlags(), flags);
+  BOOST_CHECK_EQUAL(buffer.GetWeights(), weights);
+  BOOST_CHECK_EQUAL(buffer.GetData(kFooDataName),
+                    xt::xtensor<std::complex<float>, 3>(shape, kFooDataValue));
+  // UVW coordinates do not depend on channel and are not copied.
+  BOOST_CHECK_EQUAL(buffer.GetUvw().data(), uvw);
+
+  // Selecting all channels does not copy the data.
+  const std::complex<float>* data_pointer = buffer.GetData().data();
+  buffer.SelectChannels(0, kNChannels - 1);
+  BOOST_CHECK_EQUAL(buffer.GetData().data(), data_pointer);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
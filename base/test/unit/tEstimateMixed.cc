@@ -0,0 +1,176 @@
+// Copyright (C) 2023 ASTRON (Netherlands Institute for Radio Astronomy)
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "../../EstimateMixed.h"
+
+#include <array>
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+using dp3::base::Baseline;
+using dp3::base::const_cursor;
+
+namespace {
+
+constexpr size_t kNStations = 5;
+constexpr size_t kNChannels = 3;
+constexpr size_t kNCorrelations = 4;
+
+using Jones = std::array<std::complex<double>, 4>;
+
+/// J_p * M * J_q^H for 2x2 matrices in row-major order.
+Jones Corrupt(const Jones& j_p, const Jones& model, const Jones& j_q) {
+  const Jones jm{j_p[0] * model[0] + j_p[1] * model[2],
+                 j_p[0] * model[1] + j_p[1] * model[3],
+                 j_p[2] * model[0] + j_p[3] * model[2],
+                 j_p[2] * model[1] + j_p[3] * model[3]};
+  return {jm[0] * std::conj(j_q[0]) + jm[1] * std::conj(j_q[1]),
+          jm[0] * std::conj(j_q[2]) + jm[1] * std::conj(j_q[3]),
+          jm[2] * std::conj(j_q[0]) + jm[3] * std::conj(j_q[1]),
+          jm[2] * std::conj(j_q[2]) + jm[3] * std::conj(j_q[3])};
+}
+
+Jones GetJones(const std::vector<double>& unknowns, size_t station) {
+  const double* j = &unknowns[station * 8];
+  return {std::complex<double>(j[0], j[1]), std::complex<double>(j[2], j[3]),
+          std::complex<double>(j[4], j[5]), std::complex<double>(j[6], j[7])};
+}
+
+/// A single direction problem without noise, with all cross-correlations of
+/// kNStations stations.
+struct Problem {
+  Problem() {
+    for (size_t p = 0; p != kNStations; ++p) {
+      for (size_t q = p + 1; q != kNStations; ++q) baselines.emplace_back(p, q);
+    }
+    const size_t n_values = baselines.size() * kNChannels * kNCorrelations;
+    model.resize(n_values);
+    data.resize(n_values);
+    flags = std::make_unique<bool[]>(n_values);
+    weights.assign(n_values, 1.0f);
+    mix.assign(n_values, 1.0);
+
+    std::vector<Jones> gains(kNStations);
+    for (size_t st = 0; st != kNStations; ++st) {
+      gains[st] = {std::polar(1.0 + 0.1 * st, 0.3 * st),
+                   std::complex<double>(0.0, 0.05),
+                   std::complex<double>(-0.03, 0.0),
+                   std::polar(0.9 - 0.05 * st, -0.2 * st)};
+    }
+    for (size_t bl = 0; bl != baselines.size(); ++bl) {
+      for (size_t ch = 0; ch != kNChannels; ++ch) {
+        const size_t index = (bl * kNChannels + ch) * kNCorrelations;
+        const double phase = 0.7 * bl + 0.1 * ch;
+        const Jones visibility{std::polar(2.0, phase),
+                               std::polar(0.2, -phase),
+                               std::polar(0.3, 2.0 * phase),
+                               std::polar(1.5, 0.5 * phase)};
+        const Jones corrupted = Corrupt(gains[baselines[bl].first], visibility,
+                                        gains[baselines[bl].second]);
+        for (size_t cr = 0; cr != kNCorrelations; ++cr) {
+          model[index + cr] = visibility[cr];
+          data[index + cr] = corrupted[cr];
+        }
+      }
+    }
+  }
+
+  /// Initial unknowns: unit Jones matrices.
+  static std::vector<double> InitialUnknowns() {
+    std::vector<double> unknowns(kNStations * 8, 0.0);
+    for (size_t st = 0; st != kNStations; ++st) {
+      unknowns[st * 8] = 1.0;
+      unknowns[st * 8 + 6] = 1.0;
+    }
+    return unknowns;
+  }
+
+  bool Estimate(bool dense, std::vector<double>& unknowns,
+                size_t max_iterations) const {
+    const size_t strides[3] = {1, kNCorrelations, kNCorrelations * kNChannels};
+    // Shape (direction, direction, correlation, channel, baseline).
+    const size_t mix_strides[5] = {1, 1, 1, kNCorrelations,
+                                   kNCorrelations * kNChannels};
+    const std::vector<const_cursor<std::complex<float>>> data_cursors{
+        const_cursor<std::complex<float>>(data.data(), 3, strides)};
+    const std::vector<const_cursor<std::complex<double>>> model_cursors{
+        const_cursor<std::complex<double>>(model.data(), 3, strides)};
+    const const_cursor<Baseline> baseline_cursor(baselines.data());
+    const const_cursor<bool> flag_cursor(flags.get(), 3, strides);
+    const const_cursor<float> weight_cursor(weights.data(), 3, strides);
+    const const_cursor<std::complex<double>> mix_cursor(mix.data(), 5,
+                                                        mix_strides);
+    if (dense) {
+      dp3::base::DenseEstimateWorkspace workspace;
+      return dp3::base::estimateDense(
+          1, kNStations, baselines.size(), kNChannels, baseline_cursor,
+          data_cursors, model_cursors, flag_cursor, weight_cursor, mix_cursor,
+          unknowns.data(), workspace, max_iterations);
+    } else {
+      return dp3::base::estimate(1, kNStations, baselines.size(), kNChannels,
+                                 baseline_cursor, data_cursors, model_cursors,
+                                 flag_cursor, weight_cursor, mix_cursor,
+                                 unknowns.data(), max_iterations);
+    }
+  }
+
+  std::vector<Baseline> baselines;
+  std::vector<std::complex<double>> model;
+  std::vector<std::complex<float>> data;
+  // std::vector<bool> has no data() member.
+  std::unique_ptr<bool[]> flags;
+  std::vector<float> weights;
+  std::vector<std::complex<double>> mix;
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(estimate_mixed)
+
+BOOST_AUTO_TEST_CASE(dense_equals_lsqfit) {
+  const Problem problem;
+  std::vector<double> lsqfit_unknowns = Problem::InitialUnknowns();
+  std::vector<double> dense_unknowns = Problem::InitialUnknowns();
+  BOOST_CHECK(problem.Estimate(false, lsqfit_unknowns, 50));
+  BOOST_CHECK(problem.Estimate(true, dense_unknowns, 50));
+
+  // The Jones matrices are only determined up to a unitary matrix, which
+  // both solvers may choose differently. Therefore, the corrupted model
+  // visibilities are compared, which do not depend on that choice.
+  for (size_t bl = 0; bl != problem.baselines.size(); ++bl) {
+    const size_t p = problem.baselines[bl].first;
+    const size_t q = problem.baselines[bl].second;
+    for (size_t ch = 0; ch != kNChannels; ++ch) {
+      const size_t index = (bl * kNChannels + ch) * kNCorrelations;
+      const Jones model{problem.model[index], problem.model[index + 1],
+                        problem.model[index + 2], problem.model[index + 3]};
+      const Jones lsqfit = Corrupt(GetJones(lsqfit_unknowns, p), model,
+                                   GetJones(lsqfit_unknowns, q));
+      const Jones dense = Corrupt(GetJones(dense_unknowns, p), model,
+                                  GetJones(dense_unknowns, q));
+      for (size_t cr = 0; cr != kNCorrelations; ++cr) {
+        const std::complex<double> data(problem.data[index + cr]);
+        BOOST_CHECK_SMALL(std::abs(dense[cr] - lsqfit[cr]), 1.0e-4);
+        BOOST_CHECK_SMALL(std::abs(dense[cr] - data), 1.0e-4);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(dense_not_converged) {
+  const Problem problem;
+  std::vector<double> lsqfit_unknowns = Problem::InitialUnknowns();
+  std::vector<double> dense_unknowns = Problem::InitialUnknowns();
+  // A single iteration does not reach the solution from unit Jones matrices.
+  BOOST_CHECK(!problem.Estimate(false, lsqfit_unknowns, 1));
+  BOOST_CHECK(!problem.Estimate(true, dense_unknowns, 1));
+  for (double unknown : dense_unknowns) {
+    BOOST_CHECK(std::isfinite(unknown));
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
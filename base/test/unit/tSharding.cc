@@ -0,0 +1,70 @@
+// Copyright (C) 2023 ASTRON (Netherlands Institute for Radio Astronomy)
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "../../Sharding.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include "../../../common/ParameterSet.h"
+
+using dp3::base::DivideTimeSlots;
+using dp3::base::GetShardGranularity;
+using dp3::common::ParameterSet;
+
+using Shards = std::vector<std::pair<std::size_t, std::size_t>>;
+
+BOOST_AUTO_TEST_SUITE(sharding)
+
+BOOST_AUTO_TEST_CASE(divide_time_slots) {
+  BOOST_CHECK(DivideTimeSlots(10, 1, 1) == Shards({{0, 10}}));
+  BOOST_CHECK(DivideTimeSlots(10, 3, 1) == Shards({{0, 3}, {3, 3}, {6, 4}}));
+  // Boundaries are at multiples of the granularity. The last shard gets the
+  // remaining time slots.
+  BOOST_CHECK(DivideTimeSlots(11, 2, 4) == Shards({{0, 4}, {4, 7}}));
+  // Shards that would be empty are left out.
+  BOOST_CHECK(DivideTimeSlots(5, 4, 2) == Shards({{0, 2}, {2, 2}, {4, 1}}));
+  BOOST_CHECK(DivideTimeSlots(0, 4, 1).empty());
+}
+
+BOOST_AUTO_TEST_CASE(granularity) {
+  ParameterSet parset;
+  parset.add("steps", "[average, ddecal, average2, gaincal]");
+  parset.add("average.timestep", "2");
+  parset.add("ddecal.solint", "3");
+  parset.add("average2.timestep", "5");
+  parset.add("gaincal.solint", "2");
+  // lcm(2, 2 * 3, 2 * 5, 2 * 5 * 2) = 60
+  BOOST_CHECK_EQUAL(GetShardGranularity(parset), 60);
+
+  parset.replace("steps", "[]");
+  BOOST_CHECK_EQUAL(GetShardGranularity(parset), 1);
+
+  parset.replace("steps", "[demixer, ddecal]");
+  parset.add("demixer.timestep", "2");
+  parset.add("demixer.demixtimestep", "6");
+  // lcm(6, 2, 2 * 3) = 6
+  BOOST_CHECK_EQUAL(GetShardGranularity(parset), 6);
+}
+
+BOOST_AUTO_TEST_CASE(granularity_unsupported) {
+  ParameterSet parset;
+  parset.add("steps", "[ddecal]");
+  parset.add("ddecal.solint", "0");
+  BOOST_CHECK_THROW(GetShardGranularity(parset), std::runtime_error);
+
+  parset.replace("steps", "[average]");
+  parset.add("average.timeresolution", "10");
+  BOOST_CHECK_THROW(GetShardGranularity(parset), std::runtime_error);
+
+  parset.replace("steps", "[out]");
+  BOOST_CHECK_THROW(GetShardGranularity(parset), std::runtime_error);
+
+  for (const std::string type : {"split", "explode", "madflagger",
+                                 "aoflagger", "interpolate"}) {
+    parset.replace("steps", "[step]");
+    parset.replace("step.type", type);
+    BOOST_CHECK_THROW(GetShardGranularity(parset), std::runtime_error);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -121,6 +121,58 @@ BOOST_AUTO_TEST_CASE(test_pointsource_onlyI_freqsmear) {
   BOOST_CHECK_CLOSE(std::abs(buffer(1, 0, kNStations - 1)), 0.759154, 1.0e-3);
 }
 
+BOOST_AUTO_TEST_CASE(regular_channels_accuracy) {
+  // For evenly spaced channels, the Simulator computes most station phasors by
+  // rotating the phasor of the previous channel. With many channels and long
+  // baselines, the result should still be equal to simulating each channel
+  // separately, which computes all phasors exactly.
+  const size_t kNManyChannels = 2000;
+  Stokes unit;
+  unit.I = 1.0;
+  unit.Q = 0.0;
+  unit.U = 0.0;
+  unit.V = 0.0;
+  auto pointsource = std::make_shared<PointSource>(kOffsetSource, unit);
+
+  std::vector<Baseline> baselines;
+  for (size_t st1 = 0; st1 < kNStations - 1; ++st1) {
+    for (size_t st2 = st1 + 1; st2 < kNStations; ++st2) {
+      baselines.emplace_back(Baseline(st1, st2));
+    }
+  }
+  xt::xtensor<double, 2> uvw({kNStations, 3});
+  for (size_t st = 0; st < kNStations; ++st) {
+    uvw(st, 0) = st * 50000.0;
+    uvw(st, 1) = st * 20000.0;
+    uvw(st, 2) = st * 100.0;
+  }
+
+  casacore::Vector<double> chan_freqs(kNManyChannels);
+  for (size_t chan = 0; chan < kNManyChannels; ++chan) {
+    chan_freqs[chan] = 120.0e6 + chan * 12.2e3;
+  }
+  const casacore::Vector<double> chan_widths(kNManyChannels, 12.2e3);
+  casacore::Cube<std::complex<double>> buffer(1, kNManyChannels,
+                                              baselines.size(), 0.0);
+  Simulator sim(kReference, kNStations, baselines, chan_freqs, chan_widths,
+                uvw, buffer, false, true);
+  sim.simulate(pointsource);
+
+  for (size_t chan = 0; chan < kNManyChannels; ++chan) {
+    const casacore::Vector<double> single_freq(1, chan_freqs[chan]);
+    const casacore::Vector<double> single_width(1, chan_widths[chan]);
+    casacore::Cube<std::complex<double>> single_buffer(1, 1, baselines.size(),
+                                                       0.0);
+    Simulator single_sim(kReference, kNStations, baselines, single_freq,
+                         single_width, uvw, single_buffer, false, true);
+    single_sim.simulate(pointsource);
+    for (size_t bl = 0; bl < baselines.size(); ++bl) {
+      BOOST_CHECK_SMALL(
+          std::abs(buffer(0, chan, bl) - single_buffer(0, 0, bl)), 1.0e-9);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(radec_to_lmn_conversion_simple) {
   // RA 0, DEC 90 degrees: (=north celestial pole)
   const Direction reference(0.0, 0.5 * M_PI);
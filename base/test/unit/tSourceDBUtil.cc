@@ -108,6 +108,33 @@ BOOST_AUTO_TEST_CASE(cluster_proximate_sources_multi) {
   BOOST_CHECK_CLOSE(output[1]->component(0)->direction().dec, 1.1, 1e-5);
 }
 
+BOOST_AUTO_TEST_CASE(remove_faint_components) {
+  dp3::base::Stokes bright;
+  bright.I = 2.0;
+  dp3::base::Stokes negative;
+  negative.I = -3.0;
+  dp3::base::Stokes faint;
+  faint.I = 0.1;
+  std::vector<std::shared_ptr<ModelComponent>> components_a{
+      std::make_shared<PointSource>(Direction(0.2, 0.4), bright),
+      std::make_shared<PointSource>(Direction(0.2, 0.5), faint),
+      std::make_shared<PointSource>(Direction(0.2, 0.6), negative)};
+  std::vector<std::shared_ptr<ModelComponent>> components_b{
+      std::make_shared<PointSource>(Direction(1.0, 1.1), faint)};
+  const std::vector<std::shared_ptr<Patch>> input{
+      std::make_shared<Patch>("a", components_a.begin(), components_a.end()),
+      std::make_shared<Patch>("b", components_b.begin(), components_b.end())};
+
+  const std::vector<std::shared_ptr<Patch>> output =
+      dp3::base::RemoveFaintComponents(input, 1.0);
+
+  BOOST_REQUIRE_EQUAL(output.size(), 1u);
+  BOOST_CHECK_EQUAL(output[0]->name(), "a");
+  BOOST_REQUIRE_EQUAL(output[0]->nComponents(), 2u);
+  BOOST_CHECK(output[0]->component(0) == components_a[0]);
+  BOOST_CHECK(output[0]->component(1) == components_a[2]);
+}
+
 static void TestPatches(dp3::base::SourceDBWrapper& source_db,
                         const std::vector<test_source_db::Patch>& expected) {
   const std::vector<std::shared_ptr<Patch>> patches = source_db.MakePatchList();
@@ -7,6 +7,7 @@
 
 #include <stdexcept>
 #include <algorithm>
+#include <iomanip>
 #include <iostream>
 
 namespace dp3 {
@@ -50,5 +51,72 @@ double AvailableMemory(const double memory, const double memory_percentage,
   return memory_avail;
 }
 
+MemoryBudget& MemoryBudget::GetInstance() {
+  static MemoryBudget instance;
+  return instance;
+}
+
+void MemoryBudget::SetTotal(double bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  total_ = bytes;
+}
+
+double MemoryBudget::GetTotal() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return total_;
+}
+
+void MemoryBudget::ShowPeakUsage(std::ostream& os) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  os << "Peak memory use of " << total_ / (1024.0 * 1024.0 * 1024.0)
+     << " GB budget:\n";
+  for (const auto& [id, usage] : consumers_) {
+    if (usage.peak > 0.0) {
+      os << "  " << std::fixed << std::setprecision(2)
+         << usage.peak / (1024.0 * 1024.0 * 1024.0) << " GB " << usage.name
+         << '\n';
+    }
+  }
+}
+
+MemoryBudget::Consumer::Consumer(const std::string& name) {
+  MemoryBudget& budget = GetInstance();
+  std::lock_guard<std::mutex> lock(budget.mutex_);
+  id_ = budget.next_id_++;
+  budget.consumers_[id_].name = name;
+}
+
+MemoryBudget::Consumer::~Consumer() {
+  MemoryBudget& budget = GetInstance();
+  std::lock_guard<std::mutex> lock(budget.mutex_);
+  budget.consumers_.erase(id_);
+}
+
+double MemoryBudget::Consumer::GetShare() const {
+  const MemoryBudget& budget = GetInstance();
+  std::lock_guard<std::mutex> lock(budget.mutex_);
+  if (budget.total_ <= 0.0) return AvailableMemory();
+  return budget.total_ / budget.consumers_.size();
+}
+
+void MemoryBudget::Consumer::SetUsage(double bytes) {
+  MemoryBudget& budget = GetInstance();
+  std::lock_guard<std::mutex> lock(budget.mutex_);
+  Usage& usage = budget.consumers_[id_];
+  usage.current = bytes;
+  usage.peak = std::max(usage.peak, bytes);
+}
+
+bool MemoryBudget::Consumer::Fits(double bytes) const {
+  const MemoryBudget& budget = GetInstance();
+  std::lock_guard<std::mutex> lock(budget.mutex_);
+  if (budget.total_ <= 0.0) return true;
+  double used = 0.0;
+  for (const auto& [id, usage] : budget.consumers_) {
+    if (id != id_) used += usage.current;
+  }
+  return used + bytes <= budget.total_;
+}
+
 }  // namespace common
 }  // namespace dp3
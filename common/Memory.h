@@ -8,6 +8,12 @@
 #ifndef DP3_MEMORY_H
 #define DP3_MEMORY_H
 
+#include <cstddef>
+#include <iosfwd>
+#include <map>
+#include <mutex>
+#include <string>
+
 namespace dp3 {
 namespace common {
 
@@ -37,6 +43,70 @@ double AvailableMemory(const double memory = 0,
                        const double memory_percentage = 0,
                        const bool clip = true);
 
+/**
+ * Divides a total memory budget among the steps that buffer data.
+ *
+ * Buffering steps register themselves by creating a MemoryBudget::Consumer,
+ * and size their buffers using Consumer::GetShare(). When a budget is set,
+ * the share is the budget divided by the number of registered consumers;
+ * otherwise it is AvailableMemory(), such that every step assumes that it
+ * owns the memory, as before.
+ *
+ * Consumers report their usage, which is used to report the peak usage per
+ * step and to apply backpressure: a step that can choose when to process its
+ * buffered data should do so when Consumer::Fits() says that buffering more
+ * data exceeds the budget.
+ */
+class MemoryBudget {
+ public:
+  /// Registration of a step that buffers data. The registration ends when
+  /// the Consumer is destructed.
+  class Consumer {
+   public:
+    explicit Consumer(const std::string& name);
+    ~Consumer();
+
+    Consumer(const Consumer&) = delete;
+    Consumer& operator=(const Consumer&) = delete;
+
+    /// @return The amount of memory in bytes that the step may use.
+    double GetShare() const;
+
+    /// Set the amount of memory in bytes that the step currently uses.
+    void SetUsage(double bytes);
+
+    /// @return True if the step may use the given number of bytes (in total)
+    /// without exceeding the budget, given the usage of the other steps.
+    bool Fits(double bytes) const;
+
+   private:
+    std::size_t id_;
+  };
+
+  static MemoryBudget& GetInstance();
+
+  /// Set the total budget in bytes. Zero means that there is no budget.
+  void SetTotal(double bytes);
+  double GetTotal() const;
+
+  /// Show the peak usage of all consumers that reported their usage.
+  void ShowPeakUsage(std::ostream& os) const;
+
+ private:
+  struct Usage {
+    std::string name;
+    double current = 0.0;
+    double peak = 0.0;
+  };
+
+  MemoryBudget() = default;
+
+  mutable std::mutex mutex_;
+  double total_ = 0.0;
+  std::size_t next_id_ = 0;
+  std::map<std::size_t, Usage> consumers_;
+};
+
 }  // namespace common
 }  // namespace dp3
 
@@ -0,0 +1,125 @@
+// Copyright (C) 2023 ASTRON (Netherlands Institute for Radio Astronomy)
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "Numa.h"
+
+#include <aocommon/threadpool.h>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+namespace dp3 {
+namespace common {
+
+namespace {
+
+bool numa_aware_mode = false;
+
+// The affinities of the thread pool threads before they were pinned, indexed
+// by the StaticFor thread index. Empty when the threads are not pinned.
+std::vector<cpu_set_t> original_affinities;
+
+void RestoreAffinities() {
+  if (original_affinities.empty()) return;
+  aocommon::StaticFor<std::size_t> loop;
+  loop.Run(0, original_affinities.size(),
+           [&](std::size_t thread, std::size_t) {
+             pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t),
+                                    &original_affinities[thread]);
+           });
+  original_affinities.clear();
+}
+
+}  // namespace
+
+std::size_t SetNumaAwareMode(bool enable) {
+  numa_aware_mode = enable;
+  RestoreAffinities();
+  if (!enable) return 1;
+
+  std::size_t n_nodes = 0;
+  const std::vector<int> cpus = GetNumaOrderedCpus(n_nodes);
+  if (cpus.empty()) return 0;
+
+  // Spread the threads evenly over the cpus, such that consecutive threads
+  // share a node. StaticFor gives every thread one of the n_threads indices.
+  const std::size_t n_threads = aocommon::ThreadPool::GetInstance().NThreads();
+  original_affinities.resize(n_threads);
+  aocommon::StaticFor<std::size_t> loop;
+  loop.Run(0, n_threads, [&](std::size_t thread, std::size_t) {
+    pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t),
+                           &original_affinities[thread]);
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpus[thread * cpus.size() / n_threads], &cpu_set);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+  });
+  return n_nodes;
+}
+
+bool IsNumaAwareMode() { return numa_aware_mode; }
+
+std::vector<int> GetNumaOrderedCpus(std::size_t& n_nodes) {
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+    n_nodes = 0;
+    return {};
+  }
+
+  // Nodes are not necessarily numbered consecutively.
+  std::map<int, std::string> cpu_lists;
+  const std::filesystem::path node_directory("/sys/devices/system/node");
+  std::error_code error;
+  for (const std::filesystem::directory_entry& entry :
+       std::filesystem::directory_iterator(node_directory, error)) {
+    const std::string name = entry.path().filename().string();
+    if (name.size() > 4 && name.compare(0, 4, "node") == 0 &&
+        name.find_first_not_of("0123456789", 4) == std::string::npos) {
+      std::ifstream file(entry.path() / "cpulist");
+      std::getline(file, cpu_lists[std::stoi(name.substr(4))]);
+    }
+  }
+
+  std::vector<int> cpus;
+  n_nodes = 0;
+  for (const auto& [node, cpu_list] : cpu_lists) {
+    const std::size_t n_cpus = cpus.size();
+    for (int cpu : ParseCpuList(cpu_list)) {
+      if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+    }
+    if (cpus.size() > n_cpus) ++n_nodes;
+  }
+
+  // Without NUMA information, use the allowed cpus in their normal order.
+  if (cpus.empty()) {
+    n_nodes = 1;
+    for (int cpu = 0; cpu != CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+std::vector<int> ParseCpuList(const std::string& cpu_list) {
+  std::vector<int> cpus;
+  std::istringstream stream(cpu_list);
+  std::string range;
+  while (std::getline(stream, range, ',')) {
+    if (range.empty()) continue;
+    const std::size_t dash = range.find('-');
+    const int first = std::stoi(range.substr(0, dash));
+    const int last =
+        dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+    for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+  }
+  return cpus;
+}
+
+}  // namespace common
+}  // namespace dp3
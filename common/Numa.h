@@ -0,0 +1,73 @@
+// Copyright (C) 2023 ASTRON (Netherlands Institute for Radio Astronomy)
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/// @file
+/// @brief Functions for running on machines with multiple NUMA nodes
+
+#ifndef DP3_COMMON_NUMA_H_
+#define DP3_COMMON_NUMA_H_
+
+#include <aocommon/staticfor.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace dp3 {
+namespace common {
+
+/**
+ * Enables or disables the NUMA-aware mode.
+ *
+ * Enabling it pins the threads of the global thread pool to cpus, such that
+ * consecutive threads run on the same NUMA node. Because StaticFor always
+ * gives a thread the same part of a loop, a baseline-parallel loop then
+ * processes a baseline on the same node in every time slot. Input buffers
+ * that are allocated with NumaResize() are first touched by those threads,
+ * which places their memory on the node that processes it.
+ *
+ * Disabling it restores the affinities that the threads had before they were
+ * pinned.
+ * @return The number of NUMA nodes of the cpus that are used.
+ */
+std::size_t SetNumaAwareMode(bool enable);
+
+bool IsNumaAwareMode();
+
+/**
+ * Gets the cpus that the process may use, ordered by their NUMA node.
+ * @param n_nodes Is set to the number of nodes with usable cpus.
+ */
+std::vector<int> GetNumaOrderedCpus(std::size_t& n_nodes);
+
+/**
+ * Parses a Linux cpu list, like "0-3,8,10-11".
+ */
+std::vector<int> ParseCpuList(const std::string& cpu_list);
+
+/**
+ * Resizes an array with baselines as the first axis. In NUMA-aware mode,
+ * newly allocated storage is initialized by the threads that process the
+ * baselines in a StaticFor loop, instead of by the thread that fills it.
+ */
+template <typename Tensor>
+void NumaResize(Tensor& array, const std::array<std::size_t, 3>& shape) {
+  using T = typename Tensor::value_type;
+  const T* old_data = array.data();
+  array.resize(shape);
+  if (IsNumaAwareMode() && array.data() != old_data) {
+    const std::size_t baseline_size = shape[1] * shape[2];
+    aocommon::StaticFor<std::size_t> loop;
+    loop.Run(0, shape[0], [&](std::size_t start, std::size_t end) {
+      std::fill(array.data() + start * baseline_size,
+                array.data() + end * baseline_size, T());
+    });
+  }
+}
+
+}  // namespace common
+}  // namespace dp3
+
+#endif
@@ -6,7 +6,10 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/test/data/test_case.hpp>
 
+#include <sstream>
+
 using dp3::common::AvailableMemory;
+using dp3::common::MemoryBudget;
 
 namespace {
 constexpr double kGB2BFactor = 1024 * 1024 * 1024;
@@ -57,4 +60,42 @@ BOOST_AUTO_TEST_CASE(mem_too_large) {
   BOOST_CHECK_THROW(AvailableMemory(0, 100.01), std::invalid_argument);
 }
 
+BOOST_AUTO_TEST_CASE(budget_share) {
+  MemoryBudget::GetInstance().SetTotal(0.0);
+  MemoryBudget::Consumer first("first");
+  // Without a budget, every consumer may use the available memory.
+  BOOST_TEST(first.GetShare() == AvailableMemory());
+  BOOST_TEST(first.Fits(kTooMuchMemoryB));
+
+  MemoryBudget::GetInstance().SetTotal(900.0);
+  BOOST_TEST(first.GetShare() == 900.0);
+  {
+    MemoryBudget::Consumer second("second");
+    MemoryBudget::Consumer third("third");
+    BOOST_TEST(first.GetShare() == 300.0);
+    BOOST_TEST(third.GetShare() == 300.0);
+  }
+  BOOST_TEST(first.GetShare() == 900.0);
+  MemoryBudget::GetInstance().SetTotal(0.0);
+}
+
+BOOST_AUTO_TEST_CASE(budget_backpressure) {
+  MemoryBudget::GetInstance().SetTotal(1000.0);
+  MemoryBudget::Consumer first("first");
+  MemoryBudget::Consumer second("second");
+  first.SetUsage(700.0);
+  BOOST_TEST(second.Fits(300.0));
+  BOOST_TEST(!second.Fits(301.0));
+  // A consumer's own usage does not count against itself.
+  BOOST_TEST(first.Fits(1000.0));
+  first.SetUsage(100.0);
+  BOOST_TEST(second.Fits(900.0));
+
+  std::ostringstream os;
+  MemoryBudget::GetInstance().ShowPeakUsage(os);
+  BOOST_TEST(os.str().find("first") != std::string::npos);
+  BOOST_TEST(os.str().find("second") == std::string::npos);
+  MemoryBudget::GetInstance().SetTotal(0.0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
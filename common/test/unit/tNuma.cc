@@ -0,0 +1,54 @@
+// Copyright (C) 2023 ASTRON (Netherlands Institute for Radio Astronomy)
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "../../Numa.h"
+
+#include <sched.h>
+
+#include <xtensor/xtensor.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+using dp3::common::NumaResize;
+using dp3::common::ParseCpuList;
+using dp3::common::SetNumaAwareMode;
+
+BOOST_AUTO_TEST_SUITE(numa)
+
+BOOST_AUTO_TEST_CASE(parse_cpu_list) {
+  BOOST_TEST(ParseCpuList("").empty());
+  BOOST_TEST(ParseCpuList("3") == std::vector<int>{3},
+             boost::test_tools::per_element());
+  BOOST_TEST(ParseCpuList("0-3,8,10-11") ==
+                 (std::vector<int>{0, 1, 2, 3, 8, 10, 11}),
+             boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(resize) {
+  BOOST_TEST(SetNumaAwareMode(true) >= 1);
+  xt::xtensor<float, 3> array;
+  NumaResize(array, {7, 3, 4});
+  BOOST_TEST(array.shape(0) == 7);
+  BOOST_TEST(array.shape(1) == 3);
+  BOOST_TEST(array.shape(2) == 4);
+  // Newly allocated storage is initialized.
+  for (float value : array) BOOST_TEST(value == 0.0f);
+
+  // Resizing to the same shape keeps the values.
+  array.fill(1.0f);
+  NumaResize(array, {7, 3, 4});
+  for (float value : array) BOOST_TEST(value == 1.0f);
+  SetNumaAwareMode(false);
+}
+
+BOOST_AUTO_TEST_CASE(disable_restores_affinity) {
+  cpu_set_t before;
+  BOOST_REQUIRE(sched_getaffinity(0, sizeof(before), &before) == 0);
+  BOOST_TEST(SetNumaAwareMode(true) >= 1);
+  SetNumaAwareMode(false);
+  cpu_set_t after;
+  BOOST_REQUIRE(sched_getaffinity(0, sizeof(after), &after) == 0);
+  BOOST_TEST(CPU_EQUAL(&before, &after));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
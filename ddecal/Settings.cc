@@ -70,6 +70,9 @@ Settings::Settings(const common::ParameterSet& _parset,
           boost::to_lower_copy(GetString("mode", "complexgain")))),
       propagate_solutions(GetBool("propagatesolutions", false)),
       propagate_converged_only(GetBool("propagateconvergedonly", false)),
+      extrapolate_solutions(propagate_solutions
+                                ? GetBool("extrapolatesolutions", false)
+                                : false),
       flag_unconverged(GetBool("flagunconverged", false)),
       flag_diverged_only(GetBool("flagdivergedonly", false)),
       only_predict(GetBool("onlypredict", false)),
@@ -95,6 +98,7 @@ Settings::Settings(const common::ParameterSet& _parset,
       step_size(GetDouble("stepsize", 0.2)),
       detect_stalling(GetBool("detectstalling", true)),
       step_diff_sigma(detect_stalling ? GetDouble("stepsigma", 0.1) : 0.1),
+      freeze_converged_channel_blocks(GetBool("freezeconverged", false)),
       // Only read these settings when needed: If it is defined, but not used,
       // the application will give a warning.
       approximate_tec((mode == CalType::kTec || mode == CalType::kTecAndPhase)
@@ -97,6 +97,7 @@ struct Settings {
   const base::CalType mode;
   const bool propagate_solutions;
   const bool propagate_converged_only;
+  const bool extrapolate_solutions;
   const bool flag_unconverged;
   const bool flag_diverged_only;
   const bool only_predict;
@@ -123,6 +124,7 @@ struct Settings {
   const double step_size;
   const bool detect_stalling;
   const double step_diff_sigma;
+  const bool freeze_converged_channel_blocks;
   const bool approximate_tec;
   const bool phase_reference;
   const double approx_tolerance;
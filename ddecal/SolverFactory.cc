@@ -203,6 +203,8 @@ void InitializeSolver(SolverBase& solver, const Settings& settings) {
   solver.SetConstraintAccuracy(settings.approx_tolerance);
   solver.SetStepSize(settings.step_size);
   solver.SetDetectStalling(settings.detect_stalling, settings.step_diff_sigma);
+  solver.SetFreezeConvergedChannelBlocks(
+      settings.freeze_converged_channel_blocks);
 }
 
 std::unique_ptr<SolverBase> CreateSolver(const Settings& settings,
@@ -4,6 +4,7 @@
 #ifndef DP3_DDECAL_KERNEL_SMOOTHER_H_
 #define DP3_DDECAL_KERNEL_SMOOTHER_H_
 
+#include <algorithm>
 #include <cmath>
 #include <complex>
 #include <stdexcept>
@@ -87,6 +88,40 @@ class KernelSmoother {
     }
   }
 
+  /**
+   * Precomputed kernel values for all output channels, for a fixed kernel
+   * size factor. The kernel values of output channel i are stored in
+   * values[offsets[i]] to values[offsets[i + 1]] and belong to the input
+   * channels starting at starts[i]. Since the kernel has a limited
+   * bandwidth, this forms a banded matrix.
+   */
+  struct Band {
+    std::vector<size_t> starts;
+    std::vector<size_t> offsets;
+    std::vector<NumType> values;
+  };
+
+  /**
+   * Evaluate the kernel once for all channels and the given kernel size
+   * factor, such that @ref SmoothBatch() does not need to evaluate it.
+   */
+  Band MakeBand(NumType kernelSizeFactor) const {
+    Band band;
+    band.starts.reserve(_frequencies.size());
+    band.offsets.reserve(_frequencies.size() + 1);
+    band.offsets.push_back(0);
+    VisitBands(kernelSizeFactor, [&](size_t i, size_t start, size_t end,
+                                     NumType kernelCorrection) {
+      band.starts.push_back(start);
+      for (size_t j = start; j != end; ++j) {
+        band.values.push_back(
+            Kernel((_frequencies[i] - _frequencies[j]) * kernelCorrection));
+      }
+      band.offsets.push_back(band.values.size());
+    });
+    return band;
+  }
+
   /**
    * Replaces the data with a smoothed version of the data.
    * @param data Data array of size @c n (as specified in constructor) that is
@@ -94,6 +129,76 @@ class KernelSmoother {
    * @param weight Associated weights, array of size @c n.
    */
   void Smooth(DataType* data, const NumType* weight, NumType kernelSizeFactor) {
+    VisitBands(kernelSizeFactor, [&](size_t i, size_t start, size_t end,
+                                     NumType kernelCorrection) {
+      DataType sum(0.0);
+      NumType weightSum(0.0);
+      for (size_t j = start; j != end; ++j) {
+        NumType distance = _frequencies[i] - _frequencies[j];
+        double w = Kernel(distance * kernelCorrection) * weight[j];
+        sum += data[j] * w;
+        weightSum += w;
+      }
+      if (weightSum == 0.0)
+        _scratch[i] = quiet_NaN(_scratch[i]);
+      else
+        _scratch[i] = sum / weightSum;
+    });
+    std::copy(_scratch.begin(), _scratch.begin() + _frequencies.size(), data);
+  }
+
+  /**
+   * Smooths multiple series at once with precomputed kernel values. This
+   * gives the same result as calling @ref Smooth() for every series, but
+   * avoids evaluating the kernel and lets the inner loop over the series
+   * vectorize.
+   * @param band Kernel values made by @ref MakeBand().
+   * @param data Data array of size @c n x @c nSeries, with the series as
+   * fastest changing index. It is smoothed on output.
+   * @param weight Associated weights, with the same layout as @c data.
+   */
+  void SmoothBatch(const Band& band, DataType* data, const NumType* weight,
+                   size_t nSeries) {
+    const size_t n = _frequencies.size();
+    _scratch.resize(n * nSeries);
+    _weightedData.resize(n * nSeries);
+    _weightSums.resize(nSeries);
+    for (size_t k = 0; k != n * nSeries; ++k) {
+      _weightedData[k] = data[k] * weight[k];
+    }
+
+    for (size_t i = 0; i != n; ++i) {
+      DataType* sum = &_scratch[i * nSeries];
+      std::fill_n(sum, nSeries, DataType(0.0));
+      std::fill(_weightSums.begin(), _weightSums.end(), NumType(0.0));
+      size_t j = band.starts[i];
+      for (size_t k = band.offsets[i]; k != band.offsets[i + 1]; ++k, ++j) {
+        const NumType kernelValue = band.values[k];
+        const DataType* weightedData = &_weightedData[j * nSeries];
+        const NumType* seriesWeight = &weight[j * nSeries];
+        for (size_t s = 0; s != nSeries; ++s) {
+          sum[s] += weightedData[s] * kernelValue;
+          _weightSums[s] += seriesWeight[s] * kernelValue;
+        }
+      }
+      for (size_t s = 0; s != nSeries; ++s) {
+        if (_weightSums[s] == 0.0)
+          sum[s] = quiet_NaN(sum[s]);
+        else
+          sum[s] /= _weightSums[s];
+      }
+    }
+    std::copy(_scratch.begin(), _scratch.begin() + n * nSeries, data);
+  }
+
+ private:
+  /**
+   * Determines the range of input channels that contribute to each output
+   * channel, and calls @c f(i, start, end, kernelCorrection) for each output
+   * channel i.
+   */
+  template <typename Function>
+  void VisitBands(NumType kernelSizeFactor, Function&& f) const {
     size_t n = _frequencies.size();
 
     size_t bandLeft = 0;
@@ -121,25 +226,11 @@ class KernelSmoother {
       const size_t start = bandLeft > 0 ? bandLeft - 1 : 0;
       const size_t end = bandRight < n ? bandRight + 1 : n;
 
-      DataType sum(0.0);
-      NumType weightSum(0.0);
       const NumType frequencyCorrection = _bandwidth / localBandwidth;
-      const NumType kernelCorrection = frequencyCorrection * kernelSizeFactor;
-      for (size_t j = start; j != end; ++j) {
-        NumType distance = _frequencies[i] - _frequencies[j];
-        double w = Kernel(distance * kernelCorrection) * weight[j];
-        sum += data[j] * w;
-        weightSum += w;
-      }
-      if (weightSum == 0.0)
-        _scratch[i] = quiet_NaN(_scratch[i]);
-      else
-        _scratch[i] = sum / weightSum;
+      f(i, start, end, frequencyCorrection * kernelSizeFactor);
     }
-    std::copy(_scratch.begin(), _scratch.end(), data);
   }
 
- private:
   double quiet_NaN(double) { return std::numeric_limits<double>::quiet_NaN(); }
 
   std::complex<double> quiet_NaN(std::complex<double>) {
@@ -149,6 +240,8 @@ class KernelSmoother {
 
   std::vector<NumType> _frequencies;
   std::vector<DataType> _scratch;
+  std::vector<DataType> _weightedData;
+  std::vector<NumType> _weightSums;
   enum KernelType _kernelType;
   NumType _bandwidth;
   NumType _bandwidthRefFrequency;
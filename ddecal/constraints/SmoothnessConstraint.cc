@@ -3,6 +3,8 @@
 
 #include "SmoothnessConstraint.h"
 
+#include <map>
+
 #include <aocommon/staticfor.h>
 
 namespace dp3 {
@@ -24,9 +26,23 @@ void SmoothnessConstraint::Initialize(
 void SmoothnessConstraint::SetDistanceFactors(
     std::vector<double>&& antenna_distance_factors) {
   antenna_distance_factors_ = std::move(antenna_distance_factors);
+  fit_data_.clear();
   for (size_t i = 0; i != aocommon::ThreadPool::GetInstance().NThreads(); ++i)
     fit_data_.emplace_back(frequencies_, kernel_type_, bandwidth_,
                            bandwidth_ref_frequency_);
+
+  // Antennas with equal distance factors share their kernel values.
+  bands_.clear();
+  antenna_bands_.clear();
+  std::map<double, size_t> band_indices;
+  for (double distance_factor : antenna_distance_factors_) {
+    auto [iterator, is_new] =
+        band_indices.emplace(distance_factor, bands_.size());
+    if (is_new) {
+      bands_.push_back(fit_data_.front().smoother.MakeBand(distance_factor));
+    }
+    antenna_bands_.push_back(iterator->second);
+  }
 }
 
 std::vector<Constraint::Result> SmoothnessConstraint::Apply(
@@ -36,34 +52,45 @@ std::vector<Constraint::Result> SmoothnessConstraint::Apply(
   assert(NAntennas() == solutions.shape(1));
   assert(NSolutions() == solutions.shape(2));
   const size_t n_polarizations = solutions.shape(3);
-  const size_t n_smoothed = NAntennas() * NSolutions() * n_polarizations;
-  auto solutions_view =
-      xt::reshape_view(solutions, {NChannelBlocks(), n_smoothed});
+  // All solutions and polarizations of an antenna use the same weights and
+  // kernel, and are smoothed together.
+  const size_t n_series = NSolutions() * n_polarizations;
+  auto solutions_view = xt::reshape_view(
+      solutions, {NChannelBlocks(), NAntennas() * n_series});
 
   aocommon::StaticFor<size_t> loop;
   loop.Run(
-      0, n_smoothed, [&](size_t begin_index, size_t end_index, size_t thread) {
-        for (size_t smoothing_index = begin_index; smoothing_index < end_index;
-             ++smoothing_index) {
-          size_t ant_index = smoothing_index / (NSolutions() * n_polarizations);
+      0, NAntennas(), [&](size_t begin_index, size_t end_index, size_t thread) {
+        FitData& fit_data = fit_data_[thread];
+        fit_data.data.resize(NChannelBlocks() * n_series);
+        fit_data.weight.resize(NChannelBlocks() * n_series);
+        for (size_t ant_index = begin_index; ant_index < end_index;
+             ++ant_index) {
           for (size_t ch = 0; ch != NChannelBlocks(); ++ch) {
-            // Flag channels where calibration yielded inf or nan
-            if (isfinite(solutions_view(ch, smoothing_index))) {
-              fit_data_[thread].data[ch] = solutions_view(ch, smoothing_index);
-              fit_data_[thread].weight[ch] =
-                  weights_[ant_index * NChannelBlocks() + ch];
-            } else {
-              fit_data_[thread].data[ch] = 0.0;
-              fit_data_[thread].weight[ch] = 0.0;
+            const double weight = weights_[ant_index * NChannelBlocks() + ch];
+            for (size_t s = 0; s != n_series; ++s) {
+              const std::complex<double> value =
+                  solutions_view(ch, ant_index * n_series + s);
+              // Flag channels where calibration yielded inf or nan
+              if (isfinite(value)) {
+                fit_data.data[ch * n_series + s] = value;
+                fit_data.weight[ch * n_series + s] = weight;
+              } else {
+                fit_data.data[ch * n_series + s] = 0.0;
+                fit_data.weight[ch * n_series + s] = 0.0;
+              }
             }
           }
 
-          fit_data_[thread].smoother.Smooth(
-              fit_data_[thread].data.data(), fit_data_[thread].weight.data(),
-              antenna_distance_factors_[ant_index]);
+          fit_data.smoother.SmoothBatch(bands_[antenna_bands_[ant_index]],
+                                        fit_data.data.data(),
+                                        fit_data.weight.data(), n_series);
 
           for (size_t ch = 0; ch != NChannelBlocks(); ++ch) {
-            solutions_view(ch, smoothing_index) = fit_data_[thread].data[ch];
+            for (size_t s = 0; s != n_series; ++s) {
+              solutions_view(ch, ant_index * n_series + s) =
+                  fit_data.data[ch * n_series + s];
+            }
           }
         }
       });
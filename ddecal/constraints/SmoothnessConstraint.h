@@ -51,15 +51,19 @@ class SmoothnessConstraint final : public Constraint {
             Smoother::KernelType kernel_type, double kernel_bandwidth,
             double bandwidth_ref_frequency_hz)
         : smoother(frequencies, kernel_type, kernel_bandwidth,
-                   bandwidth_ref_frequency_hz),
-          data(frequencies.size()),
-          weight(frequencies.size()) {}
+                   bandwidth_ref_frequency_hz) {}
 
     Smoother smoother;
+    /// Data and weights of all series of one antenna, with the series as
+    /// fastest changing index.
     std::vector<std::complex<double>> data;
     std::vector<double> weight;
   };
   std::vector<FitData> fit_data_;
+  /// Precomputed kernel values for each distinct antenna distance factor.
+  std::vector<Smoother::Band> bands_;
+  /// Index into bands_ for each antenna.
+  std::vector<size_t> antenna_bands_;
   std::vector<double> frequencies_;
   std::vector<double> antenna_distance_factors_;
   std::vector<double> weights_;
@@ -53,7 +53,7 @@ float DominantEigenPairNear(const xt::xtensor<std::complex<float>, 2>& matrix,
 DiagonalLowRankSolver::SolveResult DiagonalLowRankSolver::Solve(
     const SolveData& data, std::vector<std::vector<DComplex>>& solutions,
     double time, std::ostream* stat_stream) {
-  PrepareConstraints();
+  PrepareSolve();
 
   const bool subtract_immediately = GetStepSize() > 0.99;
   if (subtract_immediately) {
@@ -91,6 +91,10 @@ DiagonalLowRankSolver::SolveResult DiagonalLowRankSolver::Solve(
 
     aocommon::DynamicFor<size_t> loop;
     loop.Run(0, NChannelBlocks(), [&](size_t ch_block) {
+      if (!IsChannelBlockActive(ch_block)) {
+        KeepSolutions(ch_block, solutions[ch_block], next_solutions);
+        return;
+      }
       PerformIteration(ch_block, data.ChannelBlock(ch_block),
                        v_residual[ch_block], solutions[ch_block],
                        next_solutions, iteration);
@@ -62,6 +62,8 @@ class DiagonalLowRankSolver final : public SolverBase {
 
   size_t NSolutionPolarizations() const override { return 2; }
 
+  bool SupportsFreezingChannelBlocks() const override { return true; }
+
   /**
    * Number of power iterations performed to calculate the eigen value.
    * See also @ref DominantEigenPair().
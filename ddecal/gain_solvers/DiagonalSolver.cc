@@ -24,7 +24,7 @@ DiagonalSolver::SolveResult DiagonalSolver::Solve(
     double time, std::ostream* stat_stream) {
   assert(solutions.size() == NChannelBlocks());
 
-  PrepareConstraints();
+  PrepareSolve();
   SolveResult result;
 
   SolutionTensor next_solutions(
@@ -65,6 +65,10 @@ DiagonalSolver::SolveResult DiagonalSolver::Solve(
         [&](size_t start_block, size_t end_block, size_t thread_index) {
           for (size_t ch_block = start_block; ch_block != end_block;
                ++ch_block) {
+            if (!IsChannelBlockActive(ch_block)) {
+              KeepSolutions(ch_block, solutions[ch_block], next_solutions);
+              continue;
+            }
             const SolveData::ChannelBlockData& channel_block =
                 data.ChannelBlock(ch_block);
 
@@ -177,27 +181,25 @@ void DiagonalSolver::PerformIteration(
   const size_t n = NSolutions();
   const size_t nrhs = 1;
 
-  aocommon::RecursiveFor::NestedRun(0, NAntennas() * 2, [&](size_t i) {
-    const size_t ant = i / 2;
-    const size_t pol = i % 2;
-    const size_t m = cb_data.NAntennaVisibilities(ant) * 2;
-    std::unique_ptr<LLSSolver> solver = CreateLLSSolver(m, n, nrhs);
-    // solve x^H in [g C] x^H  = v
-    std::vector<Complex> x0(NSolutions());
-    for (size_t s = 0; s != NSolutions(); ++s) {
-      x0[s] = solutions[(ant * NSolutions() + s) * 2 + pol];
-    }
-    std::vector<Complex>& x = vs[ant * 2 + pol];
-    bool success =
-        solver->Solve(g_times_cs[ant * 2 + pol].data(), x.data(), x0.data());
-    if (success && x[0] != Complex(0.0, 0.0)) {
-      for (size_t s = 0; s != NSolutions(); ++s)
-        next_solutions(ch_block, ant, s, pol) = x[s];
-    } else {
-      xt::view(next_solutions, ch_block, ant, xt::all(), pol)
-          .fill(std::numeric_limits<double>::quiet_NaN());
-    }
-  });
+  SolveLinearSystems(
+      NAntennas() * 2, n, nrhs,
+      [&](size_t i) {
+        // solve x^H in [g C] x^H  = v
+        const size_t m = cb_data.NAntennaVisibilities(i / 2) * 2;
+        return LinearSystem{m, g_times_cs[i].data(), vs[i].data()};
+      },
+      [&](size_t i, bool success) {
+        const size_t ant = i / 2;
+        const size_t pol = i % 2;
+        const std::vector<Complex>& x = vs[i];
+        if (success && x[0] != Complex(0.0, 0.0)) {
+          for (size_t s = 0; s != NSolutions(); ++s)
+            next_solutions(ch_block, ant, s, pol) = x[s];
+        } else {
+          xt::view(next_solutions, ch_block, ant, xt::all(), pol)
+              .fill(std::numeric_limits<double>::quiet_NaN());
+        }
+      });
 }
 
 // Based on SolverBase::Matrix::Reset.
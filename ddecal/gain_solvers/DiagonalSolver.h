@@ -20,6 +20,8 @@ class DiagonalSolver final : public SolverBase {
 
   size_t NSolutionPolarizations() const override { return 2; }
 
+  bool SupportsFreezingChannelBlocks() const override { return true; }
+
  private:
   void PerformIteration(size_t ch_block,
                         const SolveData::ChannelBlockData& cb_data,
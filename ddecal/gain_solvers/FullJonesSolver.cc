@@ -50,7 +50,7 @@ FullJonesSolver::SolveResult FullJonesSolver::Solve(
 
   assert(solutions.size() == NChannelBlocks());
 
-  PrepareConstraints();
+  PrepareSolve();
   SolveResult result;
 
   SolutionTensor next_solutions(
@@ -89,6 +89,10 @@ FullJonesSolver::SolveResult FullJonesSolver::Solve(
         [&](size_t start_block, size_t end_block, size_t thread_index) {
           for (size_t ch_block = start_block; ch_block != end_block;
                ++ch_block) {
+            if (!IsChannelBlockActive(ch_block)) {
+              KeepSolutions(ch_block, solutions[ch_block], next_solutions);
+              continue;
+            }
             const SolveData::ChannelBlockData& channel_block =
                 data.ChannelBlock(ch_block);
 
@@ -18,6 +18,8 @@ class FullJonesSolver final : public SolverBase {
 
   size_t NSolutionPolarizations() const override { return 4; }
 
+  bool SupportsFreezingChannelBlocks() const override { return true; }
+
  private:
   void PerformIteration(size_t ch_block,
                         const SolveData::ChannelBlockData& cb_data,
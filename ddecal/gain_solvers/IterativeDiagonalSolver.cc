@@ -18,7 +18,7 @@ namespace ddecal {
 IterativeDiagonalSolver::SolveResult IterativeDiagonalSolver::Solve(
     const SolveData& data, std::vector<std::vector<DComplex>>& solutions,
     double time, std::ostream* stat_stream) {
-  PrepareConstraints();
+  PrepareSolve();
 
   SolutionTensor next_solutions(
       {NChannelBlocks(), NAntennas(), NSolutions(), NSolutionPolarizations()});
@@ -51,9 +51,13 @@ IterativeDiagonalSolver::SolveResult IterativeDiagonalSolver::Solve(
 
     loop.Run(0, NChannelBlocks(), [&](size_t start_block, size_t end_block) {
       for (size_t ch_block = start_block; ch_block < end_block; ++ch_block) {
-        PerformIteration(ch_block, data.ChannelBlock(ch_block),
-                         v_residual[ch_block], solutions[ch_block],
-                         next_solutions);
+        if (!IsChannelBlockActive(ch_block)) {
+          KeepSolutions(ch_block, solutions[ch_block], next_solutions);
+        } else {
+          PerformIteration(ch_block, data.ChannelBlock(ch_block),
+                           v_residual[ch_block], solutions[ch_block],
+                           next_solutions);
+        }
       }
     });
 
@@ -87,24 +91,14 @@ void IterativeDiagonalSolver::PerformIteration(
     size_t ch_block, const SolveData::ChannelBlockData& cb_data,
     std::vector<MC2x2F>& v_residual, const std::vector<DComplex>& solutions,
     SolutionTensor& next_solutions) {
-  // Fill v_residual
-  std::copy(cb_data.DataBegin(), cb_data.DataEnd(), v_residual.begin());
-
-  // Subtract all directions with their current solutions
-  for (size_t direction = 0; direction != NDirections(); ++direction)
-    DiagonalAddOrSubtractDirection<false>(cb_data, v_residual, direction,
-                                          NSolutions(), solutions);
-
-  const std::vector<MC2x2F> v_copy = v_residual;
+  // Fill v_residual with the data minus all directions with their current
+  // solutions
+  DiagonalSubtractAllDirections(cb_data, v_residual, NSolutions(), solutions);
 
+  // Be aware that we purposely still use the subtraction with 'old'
+  // solutions, because the new solutions have not been constrained yet.
+  // SolveDirection() adds the direction back to the residual while solving.
   for (size_t direction = 0; direction != NDirections(); ++direction) {
-    // Be aware that we purposely still use the subtraction with 'old'
-    // solutions, because the new solutions have not been constrained yet. Add
-    // this direction back before solving
-    if (direction != 0) v_residual = v_copy;
-    DiagonalAddOrSubtractDirection<true>(cb_data, v_residual, direction,
-                                         NSolutions(), solutions);
-
     SolveDirection(ch_block, cb_data, v_residual, direction, solutions,
                    next_solutions);
   }
@@ -119,6 +113,10 @@ void IterativeDiagonalSolver::SolveDirection(
   //          sum_b data_ab * solutions_b * model_ab^*
   // sol_a =  ----------------------------------------
   //             sum_b norm(model_ab * solutions_b)
+  //
+  // Since the solutions are diagonal, both antennas can use the element-wise
+  // product of data_ab and model_ab^*, and the denominator only needs the
+  // norms of the model elements, weighted by the norms of the solutions.
 
   const uint32_t n_dir_solutions = cb_data.NSolutionsForDirection(direction);
   std::vector<MC2x2FDiag> numerator(NAntennas() * n_dir_solutions,
@@ -136,42 +134,56 @@ void IterativeDiagonalSolver::SolveDirection(
         &solutions[(antenna_1 * NSolutions() + solution_index) * 2];
     const DComplex* solution_ant_2 =
         &solutions[(antenna_2 * NSolutions() + solution_index) * 2];
-    const MC2x2F& data = v_residual[vis_index];
     const MC2x2F& model = cb_data.ModelVisibility(direction, vis_index);
+    // The residual with this direction added back
+    const MC2x2F data = v_residual[vis_index] +
+                        DiagonalContribution(model, solution_ant_1,
+                                             solution_ant_2);
 
     const uint32_t rel_solution_index = solution_index - solution_index0;
-    // Calculate the contribution of this baseline for antenna_1
-    const MC2x2FDiag solution_1{Complex(solution_ant_2[0]),
-                                Complex(solution_ant_2[1])};
-    const MC2x2F cor_model_transp_1(solution_1 * HermTranspose(model));
     const uint32_t full_solution_1_index =
         antenna_1 * n_dir_solutions + rel_solution_index;
-    numerator[full_solution_1_index] += Diagonal(data * cor_model_transp_1);
-    // The indices (0, 2 / 1, 3) are following from the fact that we want
-    // the contribution of antenna2's "X" polarization, and the matrix is
-    // ordered [ XX XY / YX YY ].
+    const uint32_t full_solution_2_index =
+        antenna_2 * n_dir_solutions + rel_solution_index;
+    // The element-wise products of data and model^* are shared by both
+    // antennas.
+    const Complex product[4] = {
+        data[0] * std::conj(model[0]), data[1] * std::conj(model[1]),
+        data[2] * std::conj(model[2]), data[3] * std::conj(model[3])};
+    const float model_norm[4] = {std::norm(model[0]), std::norm(model[1]),
+                                 std::norm(model[2]), std::norm(model[3])};
+
+    // Calculate the contribution of this baseline for antenna_1. The indices
+    // (0, 1 / 2, 3) follow from the matrix being ordered [ XX XY / YX YY ]:
+    // XY is multiplied with the "Y" solution of antenna_2.
+    const Complex solution_2_x(solution_ant_2[0]);
+    const Complex solution_2_y(solution_ant_2[1]);
+    numerator[full_solution_1_index] +=
+        MC2x2FDiag(solution_2_x * product[0] + solution_2_y * product[1],
+                   solution_2_x * product[2] + solution_2_y * product[3]);
+    const float norm_2_x = std::norm(solution_2_x);
+    const float norm_2_y = std::norm(solution_2_y);
     denominator[full_solution_1_index * 2] +=
-        std::norm(cor_model_transp_1[0]) + std::norm(cor_model_transp_1[2]);
+        norm_2_x * model_norm[0] + norm_2_y * model_norm[1];
     denominator[full_solution_1_index * 2 + 1] +=
-        std::norm(cor_model_transp_1[1]) + std::norm(cor_model_transp_1[3]);
+        norm_2_x * model_norm[2] + norm_2_y * model_norm[3];
 
     // Calculate the contribution of this baseline for antenna_2
-    // data_ba = data_ab^H, etc., therefore, numerator and denominator
-    // become:
-    // - num = data_ab^H * solutions_a * model_ab
-    // - den = norm(model_ab^H * solutions_a)
-    const MC2x2FDiag solution_2{Complex(solution_ant_1[0]),
-                                Complex(solution_ant_1[1])};
-    const MC2x2F cor_model_2(solution_2 * model);
-
-    const uint32_t full_solution_2_index =
-        antenna_2 * n_dir_solutions + rel_solution_index;
+    // data_ba = data_ab^H, etc., therefore the products are conjugated and
+    // the indices (0, 2 / 1, 3) are transposed.
+    const Complex solution_1_x(solution_ant_1[0]);
+    const Complex solution_1_y(solution_ant_1[1]);
     numerator[full_solution_2_index] +=
-        Diagonal(HermTranspose(data) * cor_model_2);
+        MC2x2FDiag(solution_1_x * std::conj(product[0]) +
+                       solution_1_y * std::conj(product[2]),
+                   solution_1_x * std::conj(product[1]) +
+                       solution_1_y * std::conj(product[3]));
+    const float norm_1_x = std::norm(solution_1_x);
+    const float norm_1_y = std::norm(solution_1_y);
     denominator[full_solution_2_index * 2] +=
-        std::norm(cor_model_2[0]) + std::norm(cor_model_2[2]);
+        norm_1_x * model_norm[0] + norm_1_y * model_norm[2];
     denominator[full_solution_2_index * 2 + 1] +=
-        std::norm(cor_model_2[1]) + std::norm(cor_model_2[3]);
+        norm_1_x * model_norm[1] + norm_1_y * model_norm[3];
   }
 
   for (size_t ant = 0; ant != NAntennas(); ++ant) {
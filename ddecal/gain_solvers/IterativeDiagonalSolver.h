@@ -20,6 +20,8 @@ class IterativeDiagonalSolver final : public SolverBase {
 
   bool SupportsDdSolutionIntervals() const override { return true; }
 
+  bool SupportsFreezingChannelBlocks() const override { return true; }
+
  private:
   void PerformIteration(size_t ch_block,
                         const SolveData::ChannelBlockData& cb_data,
@@ -27,6 +29,10 @@ class IterativeDiagonalSolver final : public SolverBase {
                         const std::vector<DComplex>& solutions,
                         SolutionTensor& next_solutions);
 
+  /**
+   * Solves one direction. v_residual holds the data minus all directions:
+   * the contribution of this direction is added back per visibility.
+   */
   void SolveDirection(size_t ch_block,
                       const SolveData::ChannelBlockData& cb_data,
                       const std::vector<aocommon::MC2x2F>& v_residual,
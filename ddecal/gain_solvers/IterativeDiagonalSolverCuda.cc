@@ -321,7 +321,7 @@ IterativeDiagonalSolver::SolveResult IterativeDiagonalSolverCuda::Solve(
     const SolveData& data,
     std::vector<std::vector<std::complex<double>>>& solutions, double time,
     std::ostream* stat_stream) {
-  PrepareConstraints();
+  PrepareSolve();
   context_->setCurrent();
 
   const bool phase_only = GetPhaseOnly();
@@ -17,7 +17,7 @@ namespace ddecal {
 IterativeFullJonesSolver::SolveResult IterativeFullJonesSolver::Solve(
     const SolveData& data, std::vector<std::vector<DComplex>>& solutions,
     double time, std::ostream* stat_stream) {
-  PrepareConstraints();
+  PrepareSolve();
 
   SolutionTensor next_solutions(
       {NChannelBlocks(), NAntennas(), NSolutions(), NSolutionPolarizations()});
@@ -50,6 +50,10 @@ IterativeFullJonesSolver::SolveResult IterativeFullJonesSolver::Solve(
 
     loop.Run(0, NChannelBlocks(), [&](size_t ch_block, size_t end_index) {
       for (; ch_block < end_index; ++ch_block) {
+        if (!IsChannelBlockActive(ch_block)) {
+          KeepSolutions(ch_block, solutions[ch_block], next_solutions);
+          continue;
+        }
         PerformIteration(ch_block, data.ChannelBlock(ch_block),
                          v_residual[ch_block], solutions[ch_block],
                          next_solutions);
@@ -18,7 +18,7 @@ namespace ddecal {
 IterativeScalarSolver::SolveResult IterativeScalarSolver::Solve(
     const SolveData& data, std::vector<std::vector<DComplex>>& solutions,
     double time, std::ostream* stat_stream) {
-  PrepareConstraints();
+  PrepareSolve();
 
   SolutionTensor next_solutions(
       {NChannelBlocks(), NAntennas(), NSolutions(), NSolutionPolarizations()});
@@ -51,9 +51,13 @@ IterativeScalarSolver::SolveResult IterativeScalarSolver::Solve(
 
     loop.Run(0, NChannelBlocks(), [&](size_t ch_block, size_t end_index) {
       for (; ch_block < end_index; ++ch_block) {
-        PerformIteration(ch_block, data.ChannelBlock(ch_block),
-                         v_residual[ch_block], solutions[ch_block],
-                         next_solutions);
+        if (!IsChannelBlockActive(ch_block)) {
+          KeepSolutions(ch_block, solutions[ch_block], next_solutions);
+        } else {
+          PerformIteration(ch_block, data.ChannelBlock(ch_block),
+                           v_residual[ch_block], solutions[ch_block],
+                           next_solutions);
+        }
       }
     });
 
@@ -117,6 +121,11 @@ void IterativeScalarSolver::SolveDirection(
   //          sum_b data_ab * solutions_b * model_ab^*
   // sol_a =  ----------------------------------------
   //             sum_b norm(model_ab * solutions_b)
+  //
+  // Since the solutions are scalars, the numerator equals
+  // sum_b solutions_b * trace(data_ab * model_ab^H) and the denominator
+  // sum_b norm(solutions_b) * norm(model_ab). Therefore, a single trace and
+  // model norm per visibility serve both antennas of the baseline.
 
   const uint32_t n_dir_solutions = cb_data.NSolutionsForDirection(direction);
   std::vector<std::complex<double>> numerator(NAntennas() * n_dir_solutions,
@@ -138,20 +147,25 @@ void IterativeScalarSolver::SolveDirection(
     const MC2x2F& model = cb_data.ModelVisibility(direction, vis_index);
 
     const uint32_t rel_solution_index = solution_index - solution_index0;
-    // Calculate the contribution of this baseline for antenna_1
-    const MC2x2F cor_model_herm_1(HermTranspose(model) * solution_ant_2);
     const uint32_t full_solution_1_index =
         antenna_1 * n_dir_solutions + rel_solution_index;
-    numerator[full_solution_1_index] += Trace(data * cor_model_herm_1);
-    denominator[full_solution_1_index] += Norm(cor_model_herm_1);
-
-    // Calculate the contribution of this baseline for antenna2
-    const MC2x2F cor_model_2(model * solution_ant_1);
     const uint32_t full_solution_2_index =
         antenna_2 * n_dir_solutions + rel_solution_index;
-    numerator[full_solution_2_index] +=
-        Trace(HermTranspose(data) * cor_model_2);
-    denominator[full_solution_2_index] += Norm(cor_model_2);
+    // The trace of data * model^H is shared by both antennas.
+    const Complex trace =
+        data[0] * std::conj(model[0]) + data[1] * std::conj(model[1]) +
+        data[2] * std::conj(model[2]) + data[3] * std::conj(model[3]);
+    const float model_norm = Norm(model);
+
+    // Calculate the contribution of this baseline for antenna_1
+    numerator[full_solution_1_index] += solution_ant_2 * trace;
+    denominator[full_solution_1_index] +=
+        std::norm(solution_ant_2) * model_norm;
+
+    // Calculate the contribution of this baseline for antenna_2
+    numerator[full_solution_2_index] += solution_ant_1 * std::conj(trace);
+    denominator[full_solution_2_index] +=
+        std::norm(solution_ant_1) * model_norm;
   }
 
   for (size_t ant = 0; ant != NAntennas(); ++ant) {
@@ -23,6 +23,8 @@ class IterativeScalarSolver final : public SolverBase {
 
   bool SupportsDdSolutionIntervals() const override { return true; }
 
+  bool SupportsFreezingChannelBlocks() const override { return true; }
+
  private:
   void PerformIteration(size_t ch_block,
                         const SolveData::ChannelBlockData& cb_data,
@@ -500,7 +500,7 @@ LBFGSSolver::SolveResult LBFGSSolver::Solve(
 
   std::vector<persistent_data_t> persistent_data(NChannelBlocks());
 
-  PrepareConstraints();
+  PrepareSolve();
 
   SolveResult result;
 
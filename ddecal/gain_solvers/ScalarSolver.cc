@@ -22,7 +22,7 @@ ScalarSolver::SolveResult ScalarSolver::Solve(
     double time, std::ostream* stat_stream) {
   assert(solutions.size() == NChannelBlocks());
 
-  PrepareConstraints();
+  PrepareSolve();
   SolveResult result;
 
   SolutionTensor next_solutions(
@@ -63,6 +63,10 @@ ScalarSolver::SolveResult ScalarSolver::Solve(
         [&](size_t start_block, size_t end_block, size_t thread_index) {
           for (size_t ch_block = start_block; ch_block != end_block;
                ++ch_block) {
+            if (!IsChannelBlockActive(ch_block)) {
+              KeepSolutions(ch_block, solutions[ch_block], next_solutions);
+              continue;
+            }
             const SolveData::ChannelBlockData& channel_block =
                 data.ChannelBlock(ch_block);
 
@@ -171,26 +175,23 @@ void ScalarSolver::PerformIteration(size_t ch_block,
   const size_t n = NSolutions();
   const size_t nrhs = 1;
 
-  aocommon::RecursiveFor::NestedRun(0, NAntennas(), [&](size_t ant) {
-    const size_t m = cb_data.NAntennaVisibilities(ant) * 4;
-    // TODO it would be nice to have a solver resize function to avoid too many
-    // reallocations
-    std::unique_ptr<LLSSolver> solver = CreateLLSSolver(m, n, nrhs);
-    // solve x^H in [g C] x^H  = v
-    std::vector<Complex> x0(NSolutions());
-    for (size_t s = 0; s != NSolutions(); ++s) {
-      x0[s] = solutions[(ant * NSolutions() + s)];
-    }
-    Matrix& x = vs[ant];
-    bool success = solver->Solve(g_times_cs[ant].data(), x.data(), x0.data());
-    if (success && x(0, 0) != Complex(0.0, 0.0)) {
-      for (size_t s = 0; s != NSolutions(); ++s)
-        next_solutions(ch_block, ant, s, 0) = x(s, 0);
-    } else {
-      xt::view(next_solutions, ch_block, ant, xt::all(), 0)
-          .fill(std::numeric_limits<double>::quiet_NaN());
-    }
-  });
+  SolveLinearSystems(
+      NAntennas(), n, nrhs,
+      [&](size_t ant) {
+        // solve x^H in [g C] x^H  = v
+        const size_t m = cb_data.NAntennaVisibilities(ant) * 4;
+        return LinearSystem{m, g_times_cs[ant].data(), vs[ant].data()};
+      },
+      [&](size_t ant, bool success) {
+        Matrix& x = vs[ant];
+        if (success && x(0, 0) != Complex(0.0, 0.0)) {
+          for (size_t s = 0; s != NSolutions(); ++s)
+            next_solutions(ch_block, ant, s, 0) = x(s, 0);
+        } else {
+          xt::view(next_solutions, ch_block, ant, xt::all(), 0)
+              .fill(std::numeric_limits<double>::quiet_NaN());
+        }
+      });
 }
 
 void ScalarSolver::InitializeModelMatrix(
@@ -18,6 +18,8 @@ class ScalarSolver final : public SolverBase {
 
   size_t NSolutionPolarizations() const override { return 1; }
 
+  bool SupportsFreezingChannelBlocks() const override { return true; }
+
  private:
   void PerformIteration(size_t ch_block,
                         const SolveData::ChannelBlockData& cb_data,
@@ -162,34 +162,41 @@ class SolveData {
   std::vector<ChannelBlockData> channel_blocks_;
 };
 
+/**
+ * @returns The contribution of a model visibility to the data, when it is
+ * corrupted by the diagonal solutions of both antennas: solution_1 * model *
+ * solution_2^H. The solutions point to the two polarizations of a solution.
+ */
+inline aocommon::MC2x2F DiagonalContribution(
+    const aocommon::MC2x2F& model, const std::complex<double>* solution_1,
+    const std::complex<double>* solution_2) {
+  using Complex = std::complex<float>;
+  const Complex solution_1_0(solution_1[0]);
+  const Complex solution_1_1(solution_1[1]);
+  const Complex solution_2_0_conj(std::conj(solution_2[0]));
+  const Complex solution_2_1_conj(std::conj(solution_2[1]));
+  return aocommon::MC2x2F(solution_1_0 * model[0] * solution_2_0_conj,
+                          solution_1_0 * model[1] * solution_2_1_conj,
+                          solution_1_1 * model[2] * solution_2_0_conj,
+                          solution_1_1 * model[3] * solution_2_1_conj);
+}
+
 template <bool Add>
 void DiagonalAddOrSubtractDirection(
     const SolveData::ChannelBlockData& cb_data,
     std::vector<aocommon::MC2x2F>& v_residual, size_t direction,
     size_t n_solutions, const std::vector<std::complex<double>>& solutions) {
-  using DComplex = std::complex<double>;
-  using Complex = std::complex<float>;
   using aocommon::MC2x2F;
   const size_t n_visibilities = cb_data.NVisibilities();
   for (size_t vis_index = 0; vis_index != n_visibilities; ++vis_index) {
     const uint32_t antenna_1 = cb_data.Antenna1Index(vis_index);
     const uint32_t antenna_2 = cb_data.Antenna2Index(vis_index);
     const uint32_t solution_index = cb_data.SolutionIndex(direction, vis_index);
-    const DComplex* solution_1 =
-        &solutions[(antenna_1 * n_solutions + solution_index) * 2];
-    const DComplex* solution_2 =
-        &solutions[(antenna_2 * n_solutions + solution_index) * 2];
-    const Complex solution_1_0(solution_1[0]);
-    const Complex solution_1_1(solution_1[1]);
-    const Complex solution_2_0_conj(std::conj(solution_2[0]));
-    const Complex solution_2_1_conj(std::conj(solution_2[1]));
-
     MC2x2F& data = v_residual[vis_index];
-    const MC2x2F& model = cb_data.ModelVisibility(direction, vis_index);
-    const MC2x2F contribution(solution_1_0 * model[0] * solution_2_0_conj,
-                              solution_1_0 * model[1] * solution_2_1_conj,
-                              solution_1_1 * model[2] * solution_2_0_conj,
-                              solution_1_1 * model[3] * solution_2_1_conj);
+    const MC2x2F contribution = DiagonalContribution(
+        cb_data.ModelVisibility(direction, vis_index),
+        &solutions[(antenna_1 * n_solutions + solution_index) * 2],
+        &solutions[(antenna_2 * n_solutions + solution_index) * 2]);
     if constexpr (Add)
       data += contribution;
     else
@@ -197,6 +204,18 @@ void DiagonalAddOrSubtractDirection(
   }
 }
 
+/**
+ * Sets v_residual to the data minus the contributions of all directions.
+ * This gives the same result as subtracting every direction with
+ * DiagonalAddOrSubtractDirection(), but processes the visibilities in blocks
+ * that stay in the cache while all directions are subtracted from them. The
+ * residual is therefore streamed once instead of once per direction.
+ */
+void DiagonalSubtractAllDirections(
+    const SolveData::ChannelBlockData& cb_data,
+    std::vector<aocommon::MC2x2F>& v_residual, size_t n_solutions,
+    const std::vector<std::complex<double>>& solutions);
+
 }  // namespace ddecal
 }  // namespace dp3
 
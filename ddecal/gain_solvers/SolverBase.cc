@@ -4,10 +4,12 @@
 #include "SolverBase.h"
 
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <numeric>
 
 #include <aocommon/matrix2x2.h>
+#include <aocommon/recursivefor.h>
 #include <aocommon/staticfor.h>
 #include <aocommon/xt/span.h>
 
@@ -15,7 +17,14 @@
 
 #include <xtensor/xview.hpp>
 
+#include "../linear_solvers/BatchedNormalEquationsSolver.h"
+
 namespace {
+/// Number of linear systems that are solved together with the normal
+/// equations solver. The interleaved workspace of a batch should fit in the
+/// cache.
+constexpr size_t kLinearSystemBatchSize = 16;
+
 template <typename T>
 bool IsFinite(const std::complex<T>& val) {
   return std::isfinite(val.real()) && std::isfinite(val.imag());
@@ -36,6 +45,8 @@ SolverBase::SolverBase()
       step_size_(0.2),
       detect_stalling_(true),
       step_diff_sigma_(0.1),
+      freeze_converged_channel_blocks_(false),
+      collect_statistics_(false),
       phase_only_(false),
       lls_solver_type_(LLSSolverType::QR) {}
 
@@ -105,6 +116,9 @@ void SolverBase::Step(const std::vector<std::vector<DComplex>>& solutions,
   // when using 4 threads.
   for (size_t ch_block = 0; ch_block < n_channel_blocks_; ++ch_block) {
     assert(solutions[ch_block].size() == solution_size);
+    // Frozen channel blocks already have their current solutions.
+    if (!active_channel_blocks_.empty() && !active_channel_blocks_[ch_block])
+      continue;
     const std::complex<double>* solution = solutions[ch_block].data();
     std::complex<double>* next_solution = &next_solutions(ch_block, 0, 0, 0);
 
@@ -158,6 +172,24 @@ void SolverBase::Step(const std::vector<std::vector<DComplex>>& solutions,
   }
 }
 
+void SolverBase::PrepareSolve() {
+  PrepareConstraints();
+  active_channel_blocks_.assign(NChannelBlocks(), true);
+  frozen_step_sums_.assign(NChannelBlocks(), 0.0);
+  frozen_step_counts_.assign(NChannelBlocks(), 0);
+  constraint_deviations_.clear();
+  iteration_statistics_.clear();
+  iteration_start_ = std::chrono::steady_clock::now();
+}
+
+void SolverBase::KeepSolutions(size_t ch_block,
+                               const std::vector<DComplex>& solutions,
+                               SolutionTensor& next_solutions) {
+  assert(solutions.size() == next_solutions.size() / next_solutions.shape(0));
+  std::copy(solutions.begin(), solutions.end(),
+            &next_solutions(ch_block, 0, 0, 0));
+}
+
 void SolverBase::PrepareConstraints() {
   for (std::unique_ptr<Constraint>& c : constraints_) {
     c->PrepareIteration(false, 0, false);
@@ -168,7 +200,7 @@ bool SolverBase::ApplyConstraints(size_t iteration, double time,
                                   bool has_previously_converged,
                                   SolveResult& result,
                                   SolutionTensor& next_solutions,
-                                  std::ostream* stat_stream) const {
+                                  std::ostream* stat_stream) {
   SolutionSpan next_solutions_span = aocommon::xt::CreateSpan(next_solutions);
   return ApplyConstraints(iteration, time, has_previously_converged, result,
                           next_solutions_span, stat_stream);
@@ -178,9 +210,15 @@ bool SolverBase::ApplyConstraints(size_t iteration, double time,
                                   bool has_previously_converged,
                                   SolveResult& result,
                                   SolutionSpan& next_solutions,
-                                  std::ostream* stat_stream) const {
+                                  std::ostream* stat_stream) {
   bool constraints_satisfied = true;
 
+  std::vector<DComplex> unconstrained;
+  if (collect_statistics_) {
+    unconstrained.assign(next_solutions.data(),
+                         next_solutions.data() + next_solutions.size());
+  }
+
   result.results.resize(constraints_.size());
   auto result_iterator = result.results.begin();
 
@@ -199,13 +237,29 @@ bool SolverBase::ApplyConstraints(size_t iteration, double time,
   // were required.
   if (!constraints_satisfied) result.constraint_iterations = iteration + 1;
 
+  if (collect_statistics_) {
+    const size_t block_size = next_solutions.size() / NChannelBlocks();
+    constraint_deviations_.assign(NChannelBlocks(), 0.0);
+    for (size_t ch_block = 0; ch_block != NChannelBlocks(); ++ch_block) {
+      double difference = 0.0;
+      double norm = 0.0;
+      for (size_t i = ch_block * block_size; i != (ch_block + 1) * block_size;
+           ++i) {
+        difference += std::norm(next_solutions.data()[i] - unconstrained[i]);
+        norm += std::norm(unconstrained[i]);
+      }
+      if (norm != 0.0)
+        constraint_deviations_[ch_block] = std::sqrt(difference / norm);
+    }
+  }
+
   return constraints_satisfied;
 }
 
 bool SolverBase::AssignSolutions(std::vector<std::vector<DComplex>>& solutions,
                                  SolutionSpan& newSolutions,
                                  bool useConstraintAccuracy, double& avgAbsDiff,
-                                 std::vector<double>& stepMagnitudes) const {
+                                 std::vector<double>& stepMagnitudes) {
   assert(newSolutions.shape(0) == NChannelBlocks());
   assert(newSolutions.shape(1) == NAntennas());
   assert(newSolutions.shape(2) == NSolutions());
@@ -218,7 +272,12 @@ bool SolverBase::AssignSolutions(std::vector<std::vector<DComplex>>& solutions,
       newSolutions,
       {newSolutions.shape(0), newSolutions.shape(1) * newSolutions.shape(2),
        newSolutions.shape(3)});
+  std::vector<double> block_step_magnitudes(n_channel_blocks_, 0.0);
+  std::vector<double> block_step_sums(n_channel_blocks_, 0.0);
+  std::vector<size_t> block_step_counts(n_channel_blocks_, 0);
   for (size_t chBlock = 0; chBlock < n_channel_blocks_; ++chBlock) {
+    double block_sum = 0.0;
+    size_t block_n = 0;
     for (size_t i = 0; i != solutions[chBlock].size(); i += n_solution_pols) {
       // A normalized squared difference is calculated between the solutions of
       // this and the previous step:
@@ -233,8 +292,8 @@ bool SolverBase::AssignSolutions(std::vector<std::vector<DComplex>>& solutions,
               (new_solutions_view(chBlock, i, 0) - solutions[chBlock][i]) /
               solutions[chBlock][i]);
           if (std::isfinite(a)) {
-            avgAbsDiff += a;
-            ++n;
+            block_sum += a;
+            ++block_n;
           }
         }
       } else if (n_solution_pols == 2) {
@@ -248,8 +307,8 @@ bool SolverBase::AssignSolutions(std::vector<std::vector<DComplex>>& solutions,
           ns[1] = (ns[1] - s[1]) * sInv[1];
           const double sumabs = std::abs(ns[0]) + std::abs(ns[1]);
           if (std::isfinite(sumabs)) {
-            avgAbsDiff += sumabs;
-            n += 2;
+            block_sum += sumabs;
+            block_n += 2;
           }
         }
       } else {
@@ -263,13 +322,29 @@ bool SolverBase::AssignSolutions(std::vector<std::vector<DComplex>>& solutions,
           const double sumabs = std::abs(ns[0]) + std::abs(ns[1]) +
                                 std::abs(ns[2]) + std::abs(ns[3]);
           if (std::isfinite(sumabs)) {
-            avgAbsDiff += sumabs;
-            n += 4;
+            block_sum += sumabs;
+            block_n += 4;
           }
         }
       }
     }
 
+    if (block_n != 0)
+      block_step_magnitudes[chBlock] = block_sum / step_size_ / block_n;
+
+    // A frozen channel block keeps the contribution it had when it was
+    // frozen. Otherwise, its (zero) step would lower the average step of the
+    // other channel blocks, which could stop the solve prematurely.
+    if (active_channel_blocks_[chBlock]) {
+      avgAbsDiff += block_sum;
+      n += block_n;
+      block_step_sums[chBlock] = block_sum;
+      block_step_counts[chBlock] = block_n;
+    } else {
+      avgAbsDiff += frozen_step_sums_[chBlock];
+      n += frozen_step_counts_[chBlock];
+    }
+
     xt::adapt(solutions[chBlock]) =
         xt::flatten(xt::view(newSolutions, chBlock));
   }
@@ -279,6 +354,33 @@ bool SolverBase::AssignSolutions(std::vector<std::vector<DComplex>>& solutions,
   double stepMagnitude = (n == 0 ? 0 : avgAbsDiff / step_size_ / n);
   stepMagnitudes.emplace_back(stepMagnitude);
 
+  if (collect_statistics_) {
+    const std::chrono::steady_clock::time_point now =
+        std::chrono::steady_clock::now();
+    IterationStatistics& statistics = iteration_statistics_.emplace_back();
+    statistics.duration =
+        std::chrono::duration<double>(now - iteration_start_).count();
+    statistics.step_magnitudes = block_step_magnitudes;
+    statistics.constraint_deviations = std::move(constraint_deviations_);
+    constraint_deviations_.clear();
+    statistics.solved = active_channel_blocks_;
+    iteration_start_ = now;
+  }
+
+  // Channel blocks are only frozen once the constraints are satisfied, since
+  // they are solved with the constraint accuracy before that.
+  if (freeze_converged_channel_blocks_ && SupportsFreezingChannelBlocks() &&
+      !useConstraintAccuracy && stepMagnitudes.size() >= min_iterations_) {
+    for (size_t ch_block = 0; ch_block != n_channel_blocks_; ++ch_block) {
+      if (active_channel_blocks_[ch_block] &&
+          block_step_magnitudes[ch_block] <= accuracy_) {
+        active_channel_blocks_[ch_block] = false;
+        frozen_step_sums_[ch_block] = block_step_sums[ch_block];
+        frozen_step_counts_[ch_block] = block_step_counts[ch_block];
+      }
+    }
+  }
+
   if (useConstraintAccuracy)
     return stepMagnitude <= constraint_accuracy_;
   else {
@@ -288,7 +390,7 @@ bool SolverBase::AssignSolutions(std::vector<std::vector<DComplex>>& solutions,
 bool SolverBase::AssignSolutions(std::vector<std::vector<DComplex>>& solutions,
                                  SolutionTensor& newSolutions,
                                  bool useConstraintAccuracy, double& avgAbsDiff,
-                                 std::vector<double>& stepMagnitudes) const {
+                                 std::vector<double>& stepMagnitudes) {
   SolutionSpan new_solutions_span = aocommon::xt::CreateSpan(newSolutions);
   return AssignSolutions(solutions, new_solutions_span, useConstraintAccuracy,
                          avgAbsDiff, stepMagnitudes);
@@ -398,5 +500,39 @@ std::unique_ptr<LLSSolver> SolverBase::CreateLLSSolver(
   return LLSSolver::Make(lls_solver_type_, m, n, nrhs);
 }
 
+void SolverBase::SolveLinearSystems(
+    size_t n_systems, size_t n, size_t nrhs,
+    const std::function<LinearSystem(size_t)>& get_system,
+    const std::function<void(size_t, bool)>& store_result) const {
+  if (lls_solver_type_ == LLSSolverType::NORMAL_EQUATIONS) {
+    const size_t n_batches =
+        (n_systems + kLinearSystemBatchSize - 1) / kLinearSystemBatchSize;
+    aocommon::RecursiveFor::NestedRun(0, n_batches, [&](size_t batch) {
+      const size_t begin = batch * kLinearSystemBatchSize;
+      const size_t end = std::min(begin + kLinearSystemBatchSize, n_systems);
+      std::vector<int> m;
+      std::vector<Complex*> a;
+      std::vector<Complex*> b;
+      for (size_t i = begin; i != end; ++i) {
+        const LinearSystem system = get_system(i);
+        m.push_back(system.m);
+        a.push_back(system.a);
+        b.push_back(system.b);
+      }
+      BatchedNormalEquationsSolver solver(n, nrhs);
+      const std::vector<bool> success = solver.Solve(m, a, b);
+      for (size_t i = begin; i != end; ++i) {
+        store_result(i, success[i - begin]);
+      }
+    });
+  } else {
+    aocommon::RecursiveFor::NestedRun(0, n_systems, [&](size_t i) {
+      const LinearSystem system = get_system(i);
+      std::unique_ptr<LLSSolver> solver = CreateLLSSolver(system.m, n, nrhs);
+      store_result(i, solver->Solve(system.a, system.b));
+    });
+  }
+}
+
 }  // namespace ddecal
 }  // namespace dp3
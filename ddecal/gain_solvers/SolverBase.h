@@ -6,7 +6,9 @@
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <complex>
+#include <functional>
 #include <iosfwd>
 #include <memory>
 #include <vector>
@@ -62,6 +64,24 @@ class SolverBase {
     std::vector<std::vector<Constraint::Result>> results;
   };
 
+  /**
+   * Statistics of a single iteration of a solve. They are collected when
+   * enabled with SetCollectStatistics().
+   */
+  struct IterationStatistics {
+    /// Wall-clock duration of the iteration, in seconds.
+    double duration = 0.0;
+    /// For each channel block, the step magnitude that is compared with the
+    /// accuracy.
+    std::vector<double> step_magnitudes;
+    /// For each channel block, the relative change of the solutions by the
+    /// constraints: |constrained - unconstrained| / |unconstrained|.
+    std::vector<double> constraint_deviations;
+    /// For each channel block, whether it was solved in this iteration, i.e.,
+    /// whether it was not frozen.
+    std::vector<bool> solved;
+  };
+
   SolverBase();
 
   virtual ~SolverBase() = default;
@@ -166,6 +186,42 @@ class SolverBase {
   bool GetDetectStalling() const { return detect_stalling_; }
   /** @} */
 
+  /**
+   * If enabled, channel blocks whose step magnitude has reached the required
+   * accuracy are frozen: they are not solved anymore in the remaining
+   * iterations of the solve, while the other channel blocks continue. The
+   * constraints are still applied to frozen channel blocks. This saves time
+   * when a few channel blocks converge much slower than the others.
+   * Solvers that do not support freezing (see
+   * SupportsFreezingChannelBlocks()) ignore this setting.
+   * @{
+   */
+  void SetFreezeConvergedChannelBlocks(bool freeze) {
+    freeze_converged_channel_blocks_ = freeze;
+  }
+  bool GetFreezeConvergedChannelBlocks() const {
+    return freeze_converged_channel_blocks_;
+  }
+  /** @} */
+
+  /**
+   * Whether to collect IterationStatistics during Solve().
+   * @{
+   */
+  void SetCollectStatistics(bool collect_statistics) {
+    collect_statistics_ = collect_statistics;
+  }
+  bool GetCollectStatistics() const { return collect_statistics_; }
+  /** @} */
+
+  /**
+   * @returns The statistics of each iteration of the last call to Solve(),
+   * if collecting them is enabled.
+   */
+  const std::vector<IterationStatistics>& GetIterationStatistics() const {
+    return iteration_statistics_;
+  }
+
   /**
    * Output timing information to a stream.
    */
@@ -182,6 +238,12 @@ class SolverBase {
    */
   virtual bool SupportsDdSolutionIntervals() const { return false; }
 
+  /**
+   * True if the solver skips frozen channel blocks. See
+   * SetFreezeConvergedChannelBlocks().
+   */
+  virtual bool SupportsFreezingChannelBlocks() const { return false; }
+
   /**
    * Returns a list of solvers that this solver uses and for which
    * constraints should be set up. The @ref HybridSolver overrides
@@ -206,6 +268,28 @@ class SolverBase {
                             double time, std::ostream* statStream) = 0;
 
  protected:
+  /**
+   * Prepares the constraints and resets the state of a solve. Solvers call
+   * this function at the start of Solve().
+   */
+  void PrepareSolve();
+
+  /**
+   * @returns false if a channel block is frozen. Solvers that support
+   * freezing then call KeepSolutions() instead of solving the channel block.
+   */
+  bool IsChannelBlockActive(size_t ch_block) const {
+    return active_channel_blocks_[ch_block];
+  }
+
+  /**
+   * Sets the next solutions of a frozen channel block to its current
+   * solutions, such that the step does not change them.
+   */
+  static void KeepSolutions(size_t ch_block,
+                            const std::vector<DComplex>& solutions,
+                            SolutionTensor& next_solutions);
+
   void Step(const std::vector<std::vector<DComplex>>& solutions,
             SolutionTensor& next_solutions) const;
 
@@ -221,29 +305,29 @@ class SolverBase {
   static void MakeSolutionsFinite4Pol(
       std::vector<std::vector<DComplex>>& solutions);
 
-  void PrepareConstraints();
-
   bool ApplyConstraints(size_t iteration, double time,
                         bool has_previously_converged, SolveResult& result,
                         SolutionTensor& next_solutions,
-                        std::ostream* stat_stream) const;
+                        std::ostream* stat_stream);
   bool ApplyConstraints(size_t iteration, double time,
                         bool has_previously_converged, SolveResult& result,
                         SolutionSpan& next_solutions,
-                        std::ostream* stat_stream) const;
+                        std::ostream* stat_stream);
   /**
    * Assign the solutions in nextSolutions to the solutions.
+   * Also freezes converged channel blocks and records the iteration
+   * statistics, when enabled.
    * @returns whether the solutions have converged. Appends the current step
    * magnitude to step_magnitudes
    */
   bool AssignSolutions(std::vector<std::vector<DComplex>>& solutions,
                        SolutionTensor& new_solutions,
                        bool use_constraint_accuracy, double& avg_abs_diff,
-                       std::vector<double>& step_magnitudes) const;
+                       std::vector<double>& step_magnitudes);
   bool AssignSolutions(std::vector<std::vector<DComplex>>& solutions,
                        SolutionSpan& new_solutions,
                        bool use_constraint_accuracy, double& avg_abs_diff,
-                       std::vector<double>& step_magnitudes) const;
+                       std::vector<double>& step_magnitudes);
 
   bool ReachedStoppingCriterion(size_t iteration, bool has_converged,
                                 bool constraints_satisfied,
@@ -282,7 +366,33 @@ class SolverBase {
   std::unique_ptr<LLSSolver> CreateLLSSolver(size_t m, size_t n,
                                              size_t nrhs) const;
 
+  /**
+   * A linear least-squares problem A*X = B, as accepted by the LLSSolver
+   * classes.
+   */
+  struct LinearSystem {
+    size_t m;    ///< Number of rows in A.
+    Complex* a;  ///< The column-major m-by-n matrix A.
+    Complex* b;  ///< Matrix B, on return the solution.
+  };
+
+  /**
+   * Solve many independent linear least-squares problems with n unknowns and
+   * nrhs right-hand sides, in parallel. With the normal equations solver
+   * type, the problems are solved in batches by a
+   * BatchedNormalEquationsSolver. Otherwise, each problem is solved by its
+   * own LLSSolver.
+   * @param get_system Returns problem i.
+   * @param store_result Called with (i, success) after problem i is solved.
+   */
+  void SolveLinearSystems(
+      size_t n_systems, size_t n, size_t nrhs,
+      const std::function<LinearSystem(size_t)>& get_system,
+      const std::function<void(size_t, bool)>& store_result) const;
+
  private:
+  void PrepareConstraints();
+
   size_t n_antennas_;
   size_t n_directions_;
   size_t n_channel_blocks_;
@@ -299,6 +409,8 @@ class SolverBase {
   double step_size_;
   bool detect_stalling_;
   double step_diff_sigma_;
+  bool freeze_converged_channel_blocks_;
+  bool collect_statistics_;
 
   bool phase_only_;
   std::vector<std::unique_ptr<Constraint>> constraints_;
@@ -313,6 +425,21 @@ class SolverBase {
   double step_mean_;
   double step_var_;
   /** @} */
+
+  /**
+   * State of the current solve.
+   * @{
+   */
+  std::vector<bool> active_channel_blocks_;
+  /// Sum and count of the relative differences of each channel block in the
+  /// iteration it was frozen, which AssignSolutions() keeps using for the
+  /// stopping criterion.
+  std::vector<double> frozen_step_sums_;
+  std::vector<size_t> frozen_step_counts_;
+  std::vector<double> constraint_deviations_;
+  std::chrono::steady_clock::time_point iteration_start_;
+  std::vector<IterationStatistics> iteration_statistics_;
+  /** @} */
 };
 
 }  // namespace ddecal
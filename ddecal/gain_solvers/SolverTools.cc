@@ -4,6 +4,7 @@
 #include "SolverTools.h"
 
 #include <cassert>
+#include <cmath>
 
 #include <xsimd/xsimd.hpp>
 
@@ -159,4 +160,28 @@ void AssignAndWeight(
   }
 }
 
+void ExtrapolateSolutions(
+    const std::vector<std::vector<std::complex<double>>>& before_last,
+    const std::vector<std::vector<std::complex<double>>>& last,
+    size_t n_polarizations,
+    std::vector<std::vector<std::complex<double>>>& next) {
+  assert(before_last.size() == last.size());
+  next = last;
+  for (size_t ch_block = 0; ch_block != last.size(); ++ch_block) {
+    assert(before_last[ch_block].size() == last[ch_block].size());
+    for (size_t i = 0; i != last[ch_block].size(); ++i) {
+      // Off-diagonal elements of full Jones solutions have no meaningful phase.
+      const size_t polarization = i % n_polarizations;
+      if (n_polarizations == 4 && (polarization == 1 || polarization == 2))
+        continue;
+      // The phase difference between the two intervals, as a unit phasor.
+      const std::complex<double> rotation =
+          last[ch_block][i] * std::conj(before_last[ch_block][i]);
+      const double amplitude = std::abs(rotation);
+      if (std::isfinite(amplitude) && amplitude != 0.0)
+        next[ch_block][i] *= rotation / amplitude;
+    }
+  }
+}
+
 }  // namespace dp3::ddecal
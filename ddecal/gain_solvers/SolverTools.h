@@ -4,6 +4,7 @@
 #ifndef DDECAL_SOLVER_TOOLS_H_
 #define DDECAL_SOLVER_TOOLS_H_
 
+#include <complex>
 #include <memory>
 #include <vector>
 
@@ -58,6 +59,30 @@ void AssignAndWeight(
     std::vector<base::DPBuffer>& weighted_buffers,
     bool keep_unweighted_model_data, bool linear_weighting_mode);
 
+/**
+ * Extrapolates the solutions of two successive solution intervals to the
+ * next interval, for use as initial values of its solve. The phases are
+ * extrapolated linearly, which follows a linearly changing phase (or TEC)
+ * exactly. The amplitudes of the last solutions are kept, since extrapolating
+ * them is less stable.
+ *
+ * Solutions are copied from the last solutions when they can not be
+ * extrapolated, because a previous solution is zero or not finite. With four
+ * polarizations, only the diagonal elements are extrapolated.
+ *
+ * @param before_last Solutions of the interval before the last interval,
+ * with the same shape as @p last.
+ * @param last Solutions of the last interval, indexed by channel block.
+ * @param n_polarizations The number of polarizations per solution.
+ * @param next Output: the extrapolated solutions. May not refer to
+ * @p before_last or @p last.
+ */
+void ExtrapolateSolutions(
+    const std::vector<std::vector<std::complex<double>>>& before_last,
+    const std::vector<std::vector<std::complex<double>>>& last,
+    size_t n_polarizations,
+    std::vector<std::vector<std::complex<double>>>& next);
+
 }  // namespace dp3::ddecal
 
 #endif  // DDECAL_SOLVER_TOOLS_H
@@ -0,0 +1,161 @@
+// Copyright (C) 2023 ASTRON (Netherlands Institute for Radio Astronomy)
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "BatchedNormalEquationsSolver.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "QRSolver.h"
+
+namespace dp3 {
+namespace ddecal {
+
+namespace {
+/// A problem is considered ill-conditioned, and solved with QR instead, when
+/// a pivot of the Cholesky decomposition loses this fraction of its value.
+constexpr float kPivotTolerance = 1.0e-6f;
+}  // namespace
+
+std::vector<bool> BatchedNormalEquationsSolver::Solve(
+    const std::vector<int>& m, const std::vector<complex*>& a,
+    const std::vector<complex*>& b) {
+  assert(a.size() == m.size() && b.size() == m.size());
+  n_problems_ = m.size();
+  normal_matrices_.resize(n_ * n_ * n_problems_);
+  normal_rhs_.resize(n_ * n_rhs_ * n_problems_);
+  diagonal_.resize(n_ * n_problems_);
+  failed_.assign(n_problems_, false);
+
+  for (size_t p = 0; p != n_problems_; ++p) {
+    FormNormalEquations(p, m[p], a[p], b[p]);
+  }
+  Decompose();
+  Substitute();
+
+  std::vector<bool> success(n_problems_);
+  for (size_t p = 0; p != n_problems_; ++p) {
+    if (failed_[p]) {
+      QRSolver solver(m[p], n_, n_rhs_);
+      success[p] = solver.Solve(a[p], b[p]);
+    } else {
+      const size_t ldb = std::max(m[p], n_);
+      for (int column = 0; column != n_rhs_; ++column) {
+        for (int row = 0; row != n_; ++row) {
+          b[p][row + column * ldb] = normal_rhs_[Index(row, column, p)];
+        }
+      }
+      success[p] = true;
+    }
+  }
+  return success;
+}
+
+void BatchedNormalEquationsSolver::FormNormalEquations(size_t p, int m,
+                                                       const complex* a,
+                                                       const complex* b) {
+  if (m < n_) {
+    // The normal equations are singular.
+    failed_[p] = true;
+    return;
+  }
+  // Compute a^dagger a, upper triangle only
+  for (int column = 0; column != n_; ++column) {
+    for (int row = 0; row <= column; ++row) {
+      complex sum(0.0, 0.0);
+      for (int i = 0; i != m; ++i) {
+        sum += std::conj(a[i + row * m]) * a[i + column * m];
+      }
+      normal_matrices_[Index(row, column, p)] = sum;
+    }
+  }
+  // Compute a^dagger b
+  const size_t ldb = std::max(m, n_);
+  for (int column = 0; column != n_rhs_; ++column) {
+    for (int row = 0; row != n_; ++row) {
+      complex sum(0.0, 0.0);
+      for (int i = 0; i != m; ++i) {
+        sum += std::conj(a[i + row * m]) * b[i + column * ldb];
+      }
+      normal_rhs_[Index(row, column, p)] = sum;
+    }
+  }
+}
+
+void BatchedNormalEquationsSolver::Decompose() {
+  for (int j = 0; j != n_; ++j) {
+    float* pivots = &diagonal_[j * n_problems_];
+    complex* column_j = &normal_matrices_[Index(0, j, 0)];
+    for (size_t p = 0; p != n_problems_; ++p) {
+      pivots[p] = column_j[j * n_problems_ + p].real();
+    }
+    for (int k = 0; k != j; ++k) {
+      for (size_t p = 0; p != n_problems_; ++p) {
+        pivots[p] -= std::norm(column_j[k * n_problems_ + p]);
+      }
+    }
+    for (size_t p = 0; p != n_problems_; ++p) {
+      const float original = column_j[j * n_problems_ + p].real();
+      // The negated comparison also catches NaN values.
+      if (!(pivots[p] > original * kPivotTolerance) ||
+          !std::isfinite(pivots[p])) {
+        failed_[p] = true;
+        // Continue with a harmless value: the result is not used.
+        pivots[p] = 1.0f;
+      }
+      pivots[p] = std::sqrt(pivots[p]);
+    }
+
+    for (int i = j + 1; i != n_; ++i) {
+      complex* column_i = &normal_matrices_[Index(0, i, 0)];
+      for (int k = 0; k != j; ++k) {
+        for (size_t p = 0; p != n_problems_; ++p) {
+          column_i[j * n_problems_ + p] -=
+              std::conj(column_j[k * n_problems_ + p]) *
+              column_i[k * n_problems_ + p];
+        }
+      }
+      for (size_t p = 0; p != n_problems_; ++p) {
+        column_i[j * n_problems_ + p] /= pivots[p];
+      }
+    }
+  }
+}
+
+void BatchedNormalEquationsSolver::Substitute() {
+  for (int column = 0; column != n_rhs_; ++column) {
+    complex* x = &normal_rhs_[Index(0, column, 0)];
+    // Solve U^H y = A^H B
+    for (int j = 0; j != n_; ++j) {
+      const complex* u_column = &normal_matrices_[Index(0, j, 0)];
+      for (int k = 0; k != j; ++k) {
+        for (size_t p = 0; p != n_problems_; ++p) {
+          x[j * n_problems_ + p] -=
+              std::conj(u_column[k * n_problems_ + p]) * x[k * n_problems_ + p];
+        }
+      }
+      const float* pivots = &diagonal_[j * n_problems_];
+      for (size_t p = 0; p != n_problems_; ++p) {
+        x[j * n_problems_ + p] /= pivots[p];
+      }
+    }
+    // Solve U x = y
+    for (int j = n_ - 1; j >= 0; --j) {
+      for (int k = j + 1; k != n_; ++k) {
+        const complex* u_column = &normal_matrices_[Index(0, k, 0)];
+        for (size_t p = 0; p != n_problems_; ++p) {
+          x[j * n_problems_ + p] -=
+              u_column[j * n_problems_ + p] * x[k * n_problems_ + p];
+        }
+      }
+      const float* pivots = &diagonal_[j * n_problems_];
+      for (size_t p = 0; p != n_problems_; ++p) {
+        x[j * n_problems_ + p] /= pivots[p];
+      }
+    }
+  }
+}
+
+}  // namespace ddecal
+}  // namespace dp3
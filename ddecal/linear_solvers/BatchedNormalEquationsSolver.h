@@ -0,0 +1,83 @@
+// Copyright (C) 2023 ASTRON (Netherlands Institute for Radio Astronomy)
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DDECAL_BATCHED_NORMAL_EQUATIONS_SOLVER_H
+#define DDECAL_BATCHED_NORMAL_EQUATIONS_SOLVER_H
+
+#include <complex>
+#include <vector>
+
+namespace dp3 {
+namespace ddecal {
+
+/**
+ * Solves many independent linear least-squares problems that all have the
+ * same number of unknowns and right-hand sides, but possibly a different
+ * number of rows. Every problem is reduced to its normal equations, which
+ * are solved with a Cholesky decomposition. The normal equations of all
+ * problems are stored interleaved, such that the decomposition and the
+ * substitutions run over all problems in the innermost loop instead of
+ * calling LAPACK for every small problem.
+ *
+ * Problems for which the decomposition fails or is ill-conditioned are
+ * solved with a QR decomposition instead.
+ *
+ * Solve() stores the normal equations in members of the object, so an object
+ * may not be used by multiple threads at once.
+ */
+class BatchedNormalEquationsSolver {
+ public:
+  using complex = std::complex<float>;
+
+  /**
+   * @param n Number of columns in each matrix A (number of unknowns).
+   * @param n_rhs Number of columns in each matrix B.
+   */
+  BatchedNormalEquationsSolver(int n, int n_rhs) : n_(n), n_rhs_(n_rhs) {}
+
+  /**
+   * For every problem i, find X that minimizes || B - A*X ||. Inputs are
+   * ordered column-major, like for the LLSSolver classes.
+   * @param m Number of rows of A, for each problem.
+   * @param a The m[i]-by-N matrix A, for each problem. It is only modified
+   * when the problem falls back to a QR decomposition.
+   * @param b For each problem, on entry: input matrix of size m[i] x NRHS,
+   * with leading dimension max(m[i], N). On successful exit: the solution
+   * vectors, stored in the first N rows of each column.
+   * @returns For each problem, whether it was solved.
+   */
+  std::vector<bool> Solve(const std::vector<int>& m,
+                          const std::vector<complex*>& a,
+                          const std::vector<complex*>& b);
+
+ private:
+  /// Forms A^H A and A^H B for problem p.
+  void FormNormalEquations(size_t p, int m, const complex* a, const complex* b);
+  /// Decomposes A^H A = U^H U for all problems at once. Marks the problems
+  /// that can not be decomposed as failed.
+  void Decompose();
+  /// Solves U^H U X = A^H B for all problems at once.
+  void Substitute();
+
+  /// Index of element (row, column) of problem p in the interleaved storage.
+  size_t Index(size_t row, size_t column, size_t p) const {
+    return (row + column * n_) * n_problems_ + p;
+  }
+
+  int n_;
+  int n_rhs_;
+  size_t n_problems_ = 0;
+  /// A^H A for all problems, overwritten by U. Only the upper triangle is
+  /// used.
+  std::vector<complex> normal_matrices_;
+  /// A^H B for all problems, overwritten by the solutions.
+  std::vector<complex> normal_rhs_;
+  /// Diagonal of U for all problems, which is real.
+  std::vector<float> diagonal_;
+  std::vector<bool> failed_;
+};
+
+}  // namespace ddecal
+}  // namespace dp3
+
+#endif
@@ -344,6 +344,12 @@ void SolverTester::SetDiagonalSolutions(bool use_dd_intervals) {
   }
 }
 
+void SolverTester::SetPhaseOnlyInputSolutions() {
+  for (std::complex<float>& solution : input_solutions_) {
+    solution /= std::abs(solution);
+  }
+}
+
 void SolverTester::CheckScalarResults(double tolerance) {
   for (size_t ch = 0; ch != kNChannelBlocks; ++ch) {
     for (size_t ant = 0; ant != kNAntennas; ++ant) {
@@ -57,6 +57,13 @@ class SolverTester {
   void SetDiagonalSolutions(bool use_dd_intervals);
   /** @} */
 
+  /**
+   * Sets the amplitudes of the input solutions to one, for testing phase-only
+   * solvers. Call it after @ref SetScalarSolutions() or
+   * @ref SetDiagonalSolutions(), and before generating the data.
+   */
+  void SetPhaseOnlyInputSolutions();
+
   /**
    * Get the solution data that can be passed to the solver as initial values.
    * and that will contain the solve result after running the solver.
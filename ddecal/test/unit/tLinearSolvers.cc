@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "../../linear_solvers/NormalEquationsSolver.h"
+#include "../../linear_solvers/BatchedNormalEquationsSolver.h"
 
 #include <boost/test/unit_test.hpp>
 #include <boost/test/data/test_case.hpp>
@@ -22,4 +23,48 @@ BOOST_AUTO_TEST_CASE(normaleq_solver) {
   BOOST_CHECK_CLOSE(b[1].real(), 2.79757662, 1.0E-3);
 }
 
+BOOST_AUTO_TEST_CASE(batched_normaleq_solver) {
+  using complex = std::complex<float>;
+  const int n = 2;
+  // The first problem is the one of the normaleq_solver test. The second
+  // problem has more rows. The third problem is underdetermined, which the
+  // Cholesky decomposition can not solve.
+  std::vector<int> m{4, 5, 1};
+  std::vector<std::vector<complex>> a{{1.0, 1.5, 3.5, 2.0, 0.5, 0.7, 0.8, 0.4},
+                                      {1.0, 1.5, 3.5, 2.0, 1.0, 0.5, 0.7, 0.8,
+                                       0.4, 0.0},
+                                      {1.0, 2.0}};
+  std::vector<std::vector<complex>> b{{1.0, 2.0, 1.5, 1.2},
+                                      {1.0, 2.0, 1.5, 1.2, 1.0},
+                                      {1.0, 0.0}};
+
+  std::vector<complex*> a_pointers;
+  std::vector<complex*> b_pointers;
+  for (size_t i = 0; i != m.size(); ++i) {
+    a_pointers.push_back(a[i].data());
+    b_pointers.push_back(b[i].data());
+  }
+
+  dp3::ddecal::BatchedNormalEquationsSolver solver(n, 1);
+  const std::vector<bool> success = solver.Solve(m, a_pointers, b_pointers);
+
+  BOOST_REQUIRE_EQUAL(success.size(), 3u);
+  BOOST_CHECK(success[0]);
+  BOOST_CHECK_CLOSE(b[0][0].real(), -0.14141126, 1.0E-3);
+  BOOST_CHECK_CLOSE(b[0][1].real(), 2.79757662, 1.0E-3);
+  BOOST_CHECK_SMALL(b[0][0].imag(), 1.0E-6f);
+
+  // Compare with the unbatched solver.
+  std::vector<complex> a1{1.0, 1.5, 3.5, 2.0, 1.0, 0.5, 0.7, 0.8, 0.4, 0.0};
+  std::vector<complex> b1{1.0, 2.0, 1.5, 1.2, 1.0};
+  dp3::ddecal::NormalEquationsSolver reference(5, n, 1);
+  BOOST_CHECK(reference.Solve(a1.data(), b1.data()));
+  BOOST_CHECK(success[1]);
+  BOOST_CHECK_CLOSE(b[1][0].real(), b1[0].real(), 1.0E-3);
+  BOOST_CHECK_CLOSE(b[1][1].real(), b1[1].real(), 1.0E-3);
+
+  // The underdetermined problem falls back to QR, which reports the failure.
+  BOOST_CHECK(!success[2]);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -1,8 +1,9 @@
 // Copyright (C) 2021 ASTRON (Netherlands Institute for Radio Astronomy)
 // SPDX-License-Identifier: GPL-3.0-or-later
 
-#include <vector>
+#include <cmath>
 #include <complex>
+#include <vector>
 
 #include "../../constraints/SmoothnessConstraint.h"
 
@@ -12,6 +13,7 @@
 #include <xtensor/xview.hpp>
 
 using dp3::ddecal::SmoothnessConstraint;
+using Smoother = dp3::ddecal::KernelSmoother<std::complex<double>, double>;
 
 namespace {
 // We use slightly more than 2 MHz as bandwidth, to make sure the kernel
@@ -119,4 +121,53 @@ BOOST_AUTO_TEST_CASE(flagged_channels) {
   BOOST_CHECK(xt::allclose(solutions, reference_solutions));
 }
 
+BOOST_DATA_TEST_CASE(smooth_batch,
+                     boost::unit_test::data::make({0.0, 3.0e6}), ref_frequency) {
+  const size_t kNChannels = 40;
+  const size_t kNSeries = 3;
+  std::vector<double> frequencies;
+  for (size_t ch = 0; ch != kNChannels; ++ch) {
+    // Irregular channel spacing
+    frequencies.push_back(1.0e6 + ch * 1.0e5 + (ch % 3) * 2.0e4);
+  }
+  Smoother smoother(frequencies, Smoother::GaussianKernel, 1.0e6,
+                    ref_frequency);
+  const double kKernelSizeFactor = 1.5;
+  const Smoother::Band band = smoother.MakeBand(kKernelSizeFactor);
+
+  std::vector<std::complex<double>> batch_data(kNChannels * kNSeries);
+  std::vector<double> batch_weights(kNChannels * kNSeries);
+  for (size_t ch = 0; ch != kNChannels; ++ch) {
+    for (size_t s = 0; s != kNSeries; ++s) {
+      batch_data[ch * kNSeries + s] = {std::sin(ch * 0.3 + s),
+                                       std::cos(ch * 0.7 * s)};
+      // The last series is entirely flagged.
+      batch_weights[ch * kNSeries + s] =
+          (s + 1 == kNSeries) ? 0.0 : 1.0 + (ch + s) % 4;
+    }
+  }
+  std::vector<std::complex<double>> input = batch_data;
+  smoother.SmoothBatch(band, batch_data.data(), batch_weights.data(),
+                       kNSeries);
+
+  for (size_t s = 0; s != kNSeries; ++s) {
+    std::vector<std::complex<double>> data(kNChannels);
+    std::vector<double> weights(kNChannels);
+    for (size_t ch = 0; ch != kNChannels; ++ch) {
+      data[ch] = input[ch * kNSeries + s];
+      weights[ch] = batch_weights[ch * kNSeries + s];
+    }
+    smoother.Smooth(data.data(), weights.data(), kKernelSizeFactor);
+    for (size_t ch = 0; ch != kNChannels; ++ch) {
+      const std::complex<double> batch_value = batch_data[ch * kNSeries + s];
+      if (s + 1 == kNSeries) {
+        BOOST_CHECK(std::isnan(batch_value.real()));
+        BOOST_CHECK(std::isnan(data[ch].real()));
+      } else {
+        BOOST_CHECK_SMALL(std::abs(batch_value - data[ch]), 1.0e-12);
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
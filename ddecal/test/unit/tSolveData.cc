@@ -329,4 +329,60 @@ BOOST_AUTO_TEST_CASE(bda) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(subtract_all_directions) {
+  // Use enough time steps to get several blocks of visibilities.
+  const size_t kNTimes = 100;
+  const std::vector<std::string> kDirectionNames{"foo_direction", "bar_dir"};
+  const std::vector<size_t> kNSolutionsPerDirection{1, 2};
+  const size_t kNSolutions = 3;
+
+  std::vector<std::unique_ptr<DPBuffer>> unweighted_buffers;
+  std::vector<DPBuffer> weighted_buffers(kNTimes);
+  for (size_t time = 0; time < kNTimes; ++time) {
+    unweighted_buffers.emplace_back(std::make_unique<DPBuffer>(time, 1.0));
+    unweighted_buffers.back()->GetData().resize(kShape);
+    FillRegularData(unweighted_buffers.back()->GetData(""));
+    for (const std::string& name : kDirectionNames) {
+      unweighted_buffers.back()->AddData(name);
+      FillRegularData(unweighted_buffers.back()->GetData(name));
+    }
+    unweighted_buffers.back()->GetWeights().resize(kShape);
+    unweighted_buffers.back()->GetWeights().fill(1.0f);
+    unweighted_buffers.back()->GetFlags().resize(kShape);
+    unweighted_buffers.back()->GetFlags().fill(false);
+  }
+  dp3::ddecal::AssignAndWeight(unweighted_buffers, kDirectionNames,
+                               weighted_buffers, false, false);
+  const dp3::ddecal::SolveData data(
+      weighted_buffers, kDirectionNames, kNChannelBlocks, kNAntennas,
+      kNSolutionsPerDirection, kAntennas1, kAntennas2);
+
+  std::vector<std::complex<float>> float_solutions;
+  FillRandomData(float_solutions, kNAntennas * kNSolutions * 2);
+  const std::vector<std::complex<double>> solutions(float_solutions.begin(),
+                                                    float_solutions.end());
+
+  for (size_t ch_block = 0; ch_block < kNChannelBlocks; ++ch_block) {
+    const ChannelBlockData& cb_data = data.ChannelBlock(ch_block);
+    BOOST_TEST_REQUIRE(cb_data.NVisibilities() > 256u);
+
+    std::vector<aocommon::MC2x2F> expected(cb_data.DataBegin(),
+                                           cb_data.DataEnd());
+    for (size_t direction = 0; direction < kDirectionNames.size();
+         ++direction) {
+      dp3::ddecal::DiagonalAddOrSubtractDirection<false>(
+          cb_data, expected, direction, kNSolutions, solutions);
+    }
+
+    std::vector<aocommon::MC2x2F> result(cb_data.NVisibilities());
+    dp3::ddecal::DiagonalSubtractAllDirections(cb_data, result, kNSolutions,
+                                               solutions);
+    for (size_t v = 0; v < cb_data.NVisibilities(); ++v) {
+      for (size_t p = 0; p < kNPolarizations; ++p) {
+        BOOST_TEST(result[v][p] == expected[v][p]);
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -3,6 +3,7 @@
 
 #include "../../gain_solvers/SolverTools.h"
 
+#include <cmath>
 #include <limits>
 
 #include <boost/test/unit_test.hpp>
@@ -256,4 +257,51 @@ BOOST_FIXTURE_TEST_CASE(assign_and_weight_flags, AssignAndWeightFixture<3>) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(extrapolate_solutions) {
+  using Solutions = std::vector<std::vector<std::complex<double>>>;
+  const double kNaN = std::numeric_limits<double>::quiet_NaN();
+  // Two channel blocks with two solutions of two polarizations.
+  const Solutions before_last{
+      {std::polar(1.0, 0.1), std::polar(2.0, 3.0), {0.0, 0.0}, {1.0, 0.0}},
+      {std::polar(1.0, -3.0), {kNaN, 0.0}, std::polar(0.5, 0.0), {1.0, 0.0}}};
+  const Solutions last{
+      {std::polar(1.0, 0.3), std::polar(3.0, -3.0), {2.0, 1.0}, {1.0, 0.0}},
+      {std::polar(1.0, 3.0), {3.0, 4.0}, std::polar(0.4, 0.5), {kNaN, kNaN}}};
+  Solutions next;
+  dp3::ddecal::ExtrapolateSolutions(before_last, last, 2, next);
+
+  const Solutions expected{
+      {std::polar(1.0, 0.5), std::polar(3.0, -3.0 + (2.0 * M_PI - 6.0)),
+       {2.0, 1.0}, {1.0, 0.0}},
+      {std::polar(1.0, 3.0 - (2.0 * M_PI - 6.0)), {3.0, 4.0},
+       std::polar(0.4, 1.0), {kNaN, kNaN}}};
+  BOOST_REQUIRE_EQUAL(next.size(), expected.size());
+  for (size_t ch_block = 0; ch_block != expected.size(); ++ch_block) {
+    BOOST_REQUIRE_EQUAL(next[ch_block].size(), expected[ch_block].size());
+    for (size_t i = 0; i != expected[ch_block].size(); ++i) {
+      const std::complex<double> value = next[ch_block][i];
+      const std::complex<double> reference = expected[ch_block][i];
+      if (std::isnan(reference.real())) {
+        BOOST_CHECK(std::isnan(value.real()));
+      } else {
+        BOOST_CHECK_SMALL(std::abs(value - reference), 1.0e-12);
+      }
+    }
+  }
+
+  // With four polarizations, the off-diagonal elements are copied.
+  const Solutions full_before_last{{std::polar(1.0, 0.1), std::polar(1.0, 0.1),
+                                    std::polar(1.0, 0.1),
+                                    std::polar(1.0, 0.1)}};
+  const Solutions full_last{{std::polar(1.0, 0.2), std::polar(1.0, 0.2),
+                             std::polar(1.0, 0.2), std::polar(1.0, 0.2)}};
+  dp3::ddecal::ExtrapolateSolutions(full_before_last, full_last, 4, next);
+  BOOST_REQUIRE_EQUAL(next.size(), 1u);
+  BOOST_REQUIRE_EQUAL(next[0].size(), 4u);
+  BOOST_CHECK_SMALL(std::abs(next[0][0] - std::polar(1.0, 0.3)), 1.0e-12);
+  BOOST_CHECK_EQUAL(next[0][1], full_last[0][1]);
+  BOOST_CHECK_EQUAL(next[0][2], full_last[0][2]);
+  BOOST_CHECK_SMALL(std::abs(next[0][3] - std::polar(1.0, 0.3)), 1.0e-12);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
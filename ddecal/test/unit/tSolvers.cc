@@ -165,6 +165,109 @@ BOOST_FIXTURE_TEST_CASE(iterative_scalar_dd_intervals, SolverTester,
   CheckScalarResults(1.0e-3);
 }
 
+BOOST_FIXTURE_TEST_CASE(iterative_scalar_freeze_converged, SolverTester,
+                        *boost::unit_test::label("slow")) {
+  // A lower accuracy than the default of the tester makes sure that the
+  // solve converges, and thus that channel blocks are frozen.
+  constexpr double kFreezeAccuracy = 1.0e-5;
+  SetScalarSolutions(false);
+  dp3::ddecal::IterativeScalarSolver solver;
+  InitializeSolver(solver);
+  solver.SetAccuracy(kFreezeAccuracy);
+  solver.SetCollectStatistics(true);
+  solver.SetFreezeConvergedChannelBlocks(true);
+  BOOST_CHECK(solver.SupportsFreezingChannelBlocks());
+
+  const dp3::ddecal::BdaSolverBuffer& solver_buffer = FillBDAData();
+  const SolveData data(solver_buffer, kNChannelBlocks, kNDirections, kNAntennas,
+                       Antennas1(), Antennas2(), false);
+  std::vector<std::vector<std::complex<double>>> unfrozen_solutions =
+      GetSolverSolutions();
+
+  dp3::ddecal::SolverBase::SolveResult result =
+      solver.Solve(data, GetSolverSolutions(), 0.0, nullptr);
+
+  CheckScalarResults(1.0E-2);
+
+  // Solve the same data without freezing.
+  dp3::ddecal::IterativeScalarSolver unfrozen_solver;
+  InitializeSolver(unfrozen_solver);
+  unfrozen_solver.SetAccuracy(kFreezeAccuracy);
+  const dp3::ddecal::SolverBase::SolveResult unfrozen_result =
+      unfrozen_solver.Solve(data, unfrozen_solutions, 0.0, nullptr);
+
+  const std::vector<dp3::ddecal::SolverBase::IterationStatistics>& statistics =
+      solver.GetIterationStatistics();
+  BOOST_REQUIRE(!statistics.empty());
+  BOOST_CHECK_LE(statistics.size(), kMaxIterations);
+  for (size_t i = 0; i != statistics.size(); ++i) {
+    BOOST_CHECK_GE(statistics[i].duration, 0.0);
+    BOOST_REQUIRE_EQUAL(statistics[i].step_magnitudes.size(), kNChannelBlocks);
+    BOOST_REQUIRE_EQUAL(statistics[i].constraint_deviations.size(),
+                        kNChannelBlocks);
+    BOOST_REQUIRE_EQUAL(statistics[i].solved.size(), kNChannelBlocks);
+    for (size_t ch_block = 0; ch_block != kNChannelBlocks; ++ch_block) {
+      // Without constraints, the constraint deviations are zero.
+      BOOST_CHECK_EQUAL(statistics[i].constraint_deviations[ch_block], 0.0);
+      if (i == 0) {
+        BOOST_CHECK(statistics[i].solved[ch_block]);
+      } else if (!statistics[i - 1].solved[ch_block]) {
+        // A frozen channel block stays frozen and keeps its solutions.
+        BOOST_CHECK(!statistics[i].solved[ch_block]);
+        BOOST_CHECK_EQUAL(statistics[i].step_magnitudes[ch_block], 0.0);
+      }
+    }
+  }
+  BOOST_CHECK_LE(result.iterations, kMaxIterations);
+
+  // Without constraints, the channel blocks are solved independently. A block
+  // is frozen in the iteration after its step magnitude reached the accuracy.
+  size_t n_frozen = 0;
+  for (size_t ch_block = 0; ch_block != kNChannelBlocks; ++ch_block) {
+    bool frozen = false;
+    for (size_t i = 0; i != statistics.size(); ++i) {
+      BOOST_CHECK_EQUAL(statistics[i].solved[ch_block], !frozen);
+      frozen = frozen ||
+               statistics[i].step_magnitudes[ch_block] <= kFreezeAccuracy;
+    }
+    if (frozen) ++n_frozen;
+  }
+  // The solve converges once the average step magnitude reached the accuracy,
+  // which requires that at least one channel block reached it.
+  BOOST_CHECK_GE(n_frozen, 1u);
+
+  // A frozen channel block keeps contributing the step magnitude it was frozen
+  // with, which is at least the step it would have made when solving
+  // further. Therefore, freezing should not stop the solve earlier.
+  BOOST_CHECK_GE(result.iterations, unfrozen_result.iterations);
+  for (size_t ch_block = 0; ch_block != kNChannelBlocks; ++ch_block) {
+    for (size_t i = 0; i != unfrozen_solutions[ch_block].size(); ++i) {
+      BOOST_CHECK_SMALL(std::abs(GetSolverSolutions()[ch_block][i] -
+                                 unfrozen_solutions[ch_block][i]),
+                        1.0e-3);
+    }
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE(iterative_scalar_phase_only, SolverTester,
+                        *boost::unit_test::label("slow")) {
+  SetScalarSolutions(false);
+  SetPhaseOnlyInputSolutions();
+  dp3::ddecal::IterativeScalarSolver solver;
+  InitializeSolver(solver);
+  solver.SetPhaseOnly(true);
+
+  const dp3::ddecal::BdaSolverBuffer& solver_buffer = FillBDAData();
+  const SolveData data(solver_buffer, kNChannelBlocks, kNDirections, kNAntennas,
+                       Antennas1(), Antennas2(), false);
+
+  dp3::ddecal::SolverBase::SolveResult result =
+      solver.Solve(data, GetSolverSolutions(), 0.0, nullptr);
+
+  CheckScalarResults(1.0E-2);
+  BOOST_CHECK_LE(result.iterations, kMaxIterations + 1);
+}
+
 BOOST_FIXTURE_TEST_CASE(hybrid, SolverTester,
                         *boost::unit_test::label("slow")) {
   auto direction_solver = std::make_unique<dp3::ddecal::ScalarSolver>();
@@ -227,6 +330,25 @@ BOOST_FIXTURE_TEST_CASE(iterative_diagonal, SolverTester,
   TestIterativeDiagonal(*this, solver);
 }
 
+BOOST_FIXTURE_TEST_CASE(iterative_diagonal_phase_only, SolverTester,
+                        *boost::unit_test::label("slow")) {
+  SetDiagonalSolutions(false);
+  SetPhaseOnlyInputSolutions();
+  dp3::ddecal::IterativeDiagonalSolver solver;
+  InitializeSolver(solver);
+  solver.SetPhaseOnly(true);
+
+  const dp3::ddecal::BdaSolverBuffer& solver_buffer = FillBDAData();
+  const SolveData data(solver_buffer, kNChannelBlocks, kNDirections, kNAntennas,
+                       Antennas1(), Antennas2(), false);
+
+  dp3::ddecal::SolverBase::SolveResult result =
+      solver.Solve(data, GetSolverSolutions(), 0.0, nullptr);
+
+  CheckDiagonalResults(1.0E-2);
+  BOOST_CHECK_LE(result.iterations, kMaxIterations + 1);
+}
+
 #if defined(HAVE_CUDA_SOLVER)
 BOOST_FIXTURE_TEST_CASE(iterative_diagonal_cuda, SolverTester,
                         *boost::unit_test::label("slow")) {
@@ -29,6 +29,11 @@ std::shared_ptr<steps::Step> MakeSingleStep(const std::string& type,
                                             const std::string& prefix,
                                             steps::Step::MsType input_type);
 
+/// Returns the type of a step in lower case. It defaults to the name of the
+/// step without trailing digits.
+std::string GetStepType(const common::ParameterSet& parset,
+                        const std::string& step_name);
+
 /// Create a chain of step objects that are connected together.
 /// A writer will be added to the steps if it is not defined,
 /// and a terminating NullStep is added.
@@ -208,6 +208,14 @@ class DPBuffer {
   void MoveData(DPBuffer& source, const std::string& source_name,
                 const std::string& target_name);
 
+  /// Restricts the data, including the extra data, flags and weights to a
+  /// contiguous range of channels. Since the channels of a baseline are
+  /// contiguous, it copies a single block per baseline.
+  /// UVW coordinates and row numbers do not depend on channel and are kept.
+  /// @param start_channel Index of the first channel to keep.
+  /// @param n_channels Number of channels to keep.
+  void SelectChannels(std::size_t start_channel, std::size_t n_channels);
+
   /// Accesses the flags for the data (visibilities) in the DPBuffer.
   ///
   /// @return An XTensor object with the flags.
@@ -9,6 +9,7 @@
 #ifndef DP3_STEPS_STEP_H_
 #define DP3_STEPS_STEP_H_
 
+#include <cstddef>
 #include <iosfwd>
 #include <memory>
 #include <string>
@@ -142,6 +143,23 @@ class Step {
   /// Boolean if this step can process this type of data.
   virtual bool accepts(MsType dt) const { return dt == MsType::kRegular; }
 
+  /// Steps that modify each baseline independently of the other baselines
+  /// can process regular data in tiles of baselines. Consecutive steps that
+  /// support this can be fused, such that they process a tile while it is in
+  /// the cache (see FusedStep). Such steps should return true and implement
+  /// StartBaselineTiles() and ProcessBaselines().
+  virtual bool SupportsBaselineTiles() const { return false; }
+
+  /// Prepare processing the baseline tiles of a buffer, e.g. by reading the
+  /// solutions for its time. It is called once per buffer, before
+  /// ProcessBaselines() is called for the tiles of that buffer.
+  virtual void StartBaselineTiles(base::DPBuffer&) {}
+
+  /// Process baselines [first_baseline, end_baseline) of the buffer in place.
+  /// It can be called concurrently for different baseline ranges.
+  virtual void ProcessBaselines(base::DPBuffer&, std::size_t first_baseline,
+                                std::size_t end_baseline) {}
+
   /**
    * Prevents that the first Step constructor will initialize the thread pool
    * with the system's number of cpus. This mechanism makes sure that individual
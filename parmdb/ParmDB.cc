@@ -6,6 +6,7 @@
 #include "ParmDB.h"
 #include "ParmDBCasa.h"
 #include "ParmDBBlob.h"
+#include "ParmDBMemory.h"
 
 #include <casacore/casa/Utilities/Regex.h>
 
@@ -21,6 +22,17 @@ using namespace casacore;
 namespace dp3 {
 namespace parmdb {
 
+namespace {
+/// The name under which an opened ParmDB is registered. A table that is read
+/// into memory is registered separately, because it can not be written.
+string registryName(const ParmDBMeta& ptm) {
+  if (ptm.getType() == "casamemory") {
+    return "memory:" + ptm.getTableName();
+  }
+  return ptm.getTableName();
+}
+}  // namespace
+
 map<string, int> ParmDB::theirDBNames;
 vector<ParmDBRep*> ParmDB::theirParmDBs;
 
@@ -97,7 +109,7 @@ void ParmDBRep::getValuesPattern(ParmMap& result,
 
 ParmDB::ParmDB(const ParmDBMeta& ptm, bool forceNew) {
   // Attach to existing one if already opened.
-  map<string, int>::iterator pos = theirDBNames.find(ptm.getTableName());
+  map<string, int>::iterator pos = theirDBNames.find(registryName(ptm));
   if (pos != theirDBNames.end()) {
     itsRep = theirParmDBs[pos->second];
     itsRep->link();
@@ -106,6 +118,8 @@ ParmDB::ParmDB(const ParmDBMeta& ptm, bool forceNew) {
   // Open the correct ParmDB.
   if (ptm.getType() == "casa") {
     itsRep = new ParmDBCasa(ptm.getTableName(), forceNew);
+  } else if (ptm.getType() == "casamemory") {
+    itsRep = new ParmDBMemory(ptm.getTableName());
   } else if (ptm.getType() == "blob") {
     itsRep = new ParmDBBlob(ptm.getTableName(), forceNew);
     ///  } else if (ptm.getType() == "bdb") {
@@ -140,7 +154,7 @@ ParmDB::ParmDB(const ParmDBMeta& ptm, bool forceNew) {
     }
   }
   itsRep->setParmDBSeqNr(dbnr);
-  theirDBNames.insert(make_pair(ptm.getTableName(), dbnr));
+  theirDBNames.insert(make_pair(registryName(ptm), dbnr));
 }
 
 ParmDB::ParmDB(ParmDBRep* rep) : itsRep(rep) { itsRep->link(); }
@@ -158,7 +172,7 @@ ParmDB& ParmDB::operator=(const ParmDB& that) {
 
 void ParmDB::decrCount() {
   if (itsRep->unlink() == 0) {
-    string tabName = itsRep->getParmDBMeta().getTableName();
+    string tabName = registryName(itsRep->getParmDBMeta());
     map<string, int>::iterator pos = theirDBNames.find(tabName);
     if (pos == theirDBNames.end())
       throw std::runtime_error("~ParmDB " + tabName + " not found in map");
@@ -92,6 +92,12 @@ class ParmDBCasa : public ParmDBRep {
   /// Clear database or table
   void clearTables() override;
 
+  /// Form an axis from the interval array in the given row.
+  /// If no interval array, return a regular axis made from (st,end,n).
+  static Axis::ShPtr getInterval(casacore::ROArrayColumn<double>& col,
+                                 unsigned int rownr, double st, double end,
+                                 unsigned int n);
+
  private:
   /// Fill the map with default values.
   void fillDefMap(ParmMap& defMap) override;
@@ -146,12 +152,6 @@ class ParmDBCasa : public ParmDBRep {
   void putInterval(const Axis& axis, casacore::ArrayColumn<double>& col,
                    unsigned int rownr);
 
-  /// Form an axis from the interval array in the given row.
-  /// If no interval array, return a regular axis made from (st,end,n).
-  Axis::ShPtr getInterval(casacore::ROArrayColumn<double>& col,
-                          unsigned int rownr, double st, double end,
-                          unsigned int n);
-
   /// Find the table subset containing the parameter values for the
   /// requested domain.
   casacore::Table find(const std::string& parmName, const Box& domain);
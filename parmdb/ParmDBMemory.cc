@@ -0,0 +1,336 @@
+// ParmDBMemory.cc: Read-only copy of a Casa parameter table in memory
+//
+// Copyright (C) 2023 ASTRON (Netherlands Institute for Radio Astronomy)
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "ParmDBMemory.h"
+#include "ParmDBCasa.h"
+
+#include <casacore/casa/Arrays/Vector.h>
+#include <casacore/casa/BasicMath/Math.h>
+#include <casacore/casa/Utilities/Regex.h>
+#include <casacore/tables/Tables/ArrayColumn.h>
+#include <casacore/tables/Tables/ScalarColumn.h>
+#include <casacore/tables/Tables/Table.h>
+#include <casacore/tables/Tables/TableRecord.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+using casacore::ArrayColumn;
+using casacore::Regex;
+using casacore::ScalarColumn;
+using casacore::Table;
+
+namespace dp3 {
+namespace parmdb {
+
+namespace {
+
+/// Returns true if the interval [start, end] overlaps with the interval
+/// [lower, upper], using the same tolerance as ParmDBCasa.
+bool Overlaps(double lower, double upper, double start, double end) {
+  return lower < end && !casacore::near(lower, end, 1e-12) && upper > start &&
+         !casacore::near(upper, start, 1e-12);
+}
+
+/// Returns the part of a file name pattern before the first special
+/// character.
+std::string LiteralPrefix(const std::string& pattern) {
+  return pattern.substr(0, pattern.find_first_of("*?[{\\"));
+}
+
+}  // namespace
+
+ParmDBMemory::ParmDBMemory(const std::string& tableName)
+    : itsTableName(tableName) {
+  if (!Table::isReadable(tableName)) {
+    throw std::runtime_error("ParmDB " + tableName + " does not exist");
+  }
+  {
+    // The default values are few, so they are read with ParmDBCasa.
+    ParmDBCasa casaTable(tableName);
+    casaTable.getDefValues(itsDefValues, "*");
+    setDefStep(0, casaTable.getDefaultSteps()[0]);
+    setDefStep(1, casaTable.getDefaultSteps()[1]);
+  }
+  readTables(tableName);
+}
+
+ParmDBMemory::~ParmDBMemory() {}
+
+void ParmDBMemory::readTables(const std::string& tableName) {
+  const Table table(tableName);
+  const Table nameTable = table.keywordSet().asTable("NAMES");
+
+  ScalarColumn<casacore::String> nameCol(nameTable, "NAME");
+  ScalarColumn<int> typeCol(nameTable, "FUNKLETTYPE");
+  ScalarColumn<double> pertCol(nameTable, "PERTURBATION");
+  ScalarColumn<bool> prelCol(nameTable, "PERT_REL");
+  ArrayColumn<bool> maskCol(nameTable, "SOLVABLE");
+  const unsigned int nNames = nameTable.nrow();
+  itsNames.reserve(nNames);
+  itsParameters.resize(nNames);
+  for (unsigned int id = 0; id < nNames; ++id) {
+    itsNames.push_back(nameCol(id));
+    itsNameIndex.emplace(itsNames.back(), id);
+    Parameter& parameter = itsParameters[id];
+    parameter.type = ParmValue::FunkletType(typeCol(id));
+    parameter.perturbation = pertCol(id);
+    parameter.pert_rel = prelCol(id);
+    if (maskCol.ndim(id) > 0) {
+      parameter.solvable_mask = maskCol(id);
+    }
+  }
+
+  const casacore::Vector<unsigned int> nameIds =
+      ScalarColumn<unsigned int>(table, "NAMEID").getColumn();
+  const casacore::Vector<double> sx =
+      ScalarColumn<double>(table, "STARTX").getColumn();
+  const casacore::Vector<double> ex =
+      ScalarColumn<double>(table, "ENDX").getColumn();
+  const casacore::Vector<double> sy =
+      ScalarColumn<double>(table, "STARTY").getColumn();
+  const casacore::Vector<double> ey =
+      ScalarColumn<double>(table, "ENDY").getColumn();
+  ArrayColumn<double> ivxCol(table, "INTERVALSX");
+  ArrayColumn<double> ivyCol(table, "INTERVALSY");
+  ArrayColumn<double> valCol(table, "VALUES");
+  ArrayColumn<double> errCol(table, "ERRORS");
+
+  // Visit the rows per parameter, in order of their start time.
+  std::vector<unsigned int> order(table.nrow());
+  std::iota(order.begin(), order.end(), 0u);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](unsigned int left, unsigned int right) {
+                     return nameIds[left] < nameIds[right] ||
+                            (nameIds[left] == nameIds[right] &&
+                             sy[left] < sy[right]);
+                   });
+  for (unsigned int row : order) {
+    if (nameIds[row] >= nNames) {
+      throw std::runtime_error("Invalid NAMEID in ParmDB " + tableName);
+    }
+    Parameter& parameter = itsParameters[nameIds[row]];
+    auto pval = std::make_shared<ParmValue>();
+    if (parameter.type != ParmValue::Scalar) {
+      pval->setCoeff(valCol(row));
+    } else {
+      casacore::Array<double> values = valCol(row);
+      const unsigned int nx = values.shape()[0];
+      const unsigned int ny = values.shape()[1];
+      pval->setScalars(
+          Grid(ParmDBCasa::getInterval(ivxCol, row, sx[row], ex[row], nx),
+               ParmDBCasa::getInterval(ivyCol, row, sy[row], ey[row], ny)),
+          values);
+    }
+    if (errCol.isDefined(row)) {
+      pval->setErrors(errCol(row));
+    }
+    pval->setRowId(row);
+    parameter.start_x.push_back(sx[row]);
+    parameter.end_x.push_back(ex[row]);
+    parameter.start_y.push_back(sy[row]);
+    parameter.end_y.push_back(ey[row]);
+    parameter.end_y_max.push_back(
+        parameter.end_y_max.empty()
+            ? ey[row]
+            : std::max(parameter.end_y_max.back(), ey[row]));
+    parameter.rows.push_back(row);
+    parameter.values.push_back(std::move(pval));
+  }
+}
+
+std::vector<unsigned int> ParmDBMemory::findNameIds(
+    const std::string& pattern) const {
+  std::vector<unsigned int> ids;
+  if (pattern.empty() || pattern == "*") {
+    ids.resize(itsNames.size());
+    std::iota(ids.begin(), ids.end(), 0u);
+    return ids;
+  }
+  const std::string prefix = LiteralPrefix(pattern);
+  if (prefix == pattern) {
+    const auto iter = itsNameIndex.find(pattern);
+    if (iter != itsNameIndex.end()) ids.push_back(iter->second);
+    return ids;
+  }
+  // Only the names that start with the literal prefix can match.
+  const Regex regex(Regex::fromPattern(pattern));
+  for (auto iter = itsNameIndex.lower_bound(prefix);
+       iter != itsNameIndex.end() &&
+       iter->first.compare(0, prefix.size(), prefix) == 0;
+       ++iter) {
+    if (casacore::String(iter->first).matches(regex)) {
+      ids.push_back(iter->second);
+    }
+  }
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+void ParmDBMemory::extendRange(const Parameter& parameter, double& sx,
+                               double& ex, double& sy, double& ey) const {
+  for (size_t i = 0; i < parameter.start_x.size(); ++i) {
+    sx = std::min(sx, parameter.start_x[i]);
+    ex = std::max(ex, parameter.end_x[i]);
+    sy = std::min(sy, parameter.start_y[i]);
+    ey = std::max(ey, parameter.end_y[i]);
+  }
+}
+
+Box ParmDBMemory::getRange(const std::string& parmNamePattern) const {
+  double sx = std::numeric_limits<double>::max();
+  double sy = std::numeric_limits<double>::max();
+  double ex = std::numeric_limits<double>::lowest();
+  double ey = std::numeric_limits<double>::lowest();
+  for (unsigned int id : findNameIds(parmNamePattern)) {
+    extendRange(itsParameters[id], sx, ex, sy, ey);
+  }
+  if (sx > ex) {
+    return Box();
+  }
+  return Box(Point(sx, sy), Point(ex, ey));
+}
+
+Box ParmDBMemory::getRange(const std::vector<std::string>& parmNames) const {
+  if (parmNames.empty()) {
+    return getRange(std::string());
+  }
+  double sx = std::numeric_limits<double>::max();
+  double sy = std::numeric_limits<double>::max();
+  double ex = std::numeric_limits<double>::lowest();
+  double ey = std::numeric_limits<double>::lowest();
+  for (const std::string& name : parmNames) {
+    const auto iter = itsNameIndex.find(name);
+    if (iter != itsNameIndex.end()) {
+      extendRange(itsParameters[iter->second], sx, ex, sy, ey);
+    }
+  }
+  if (sx > ex) {
+    return Box();
+  }
+  return Box(Point(sx, sy), Point(ex, ey));
+}
+
+void ParmDBMemory::getValues(std::vector<ParmValueSet>& psets,
+                             const std::vector<unsigned int>& nameIds,
+                             const std::vector<ParmId>& parmIds,
+                             const Box& domain) {
+  const bool selectX = domain.lowerX() < domain.upperX();
+  const bool selectY = domain.lowerY() < domain.upperY();
+  for (size_t inx = 0; inx < nameIds.size(); ++inx) {
+    ParmValueSet& pvset = psets[parmIds[inx]];
+    const unsigned int id = nameIds[inx];
+    const Parameter& parameter = itsParameters[id];
+
+    // Only the domains between these indices can overlap in time.
+    size_t first = 0;
+    size_t last = parameter.start_y.size();
+    if (selectY) {
+      first = std::upper_bound(parameter.end_y_max.begin(),
+                               parameter.end_y_max.end(), domain.lowerY()) -
+              parameter.end_y_max.begin();
+      last = std::lower_bound(parameter.start_y.begin(),
+                              parameter.start_y.end(), domain.upperY()) -
+             parameter.start_y.begin();
+    }
+    std::vector<size_t> selection;
+    for (size_t i = first; i < last; ++i) {
+      if ((!selectY || Overlaps(domain.lowerY(), domain.upperY(),
+                                parameter.start_y[i], parameter.end_y[i])) &&
+          (!selectX || Overlaps(domain.lowerX(), domain.upperX(),
+                                parameter.start_x[i], parameter.end_x[i]))) {
+        selection.push_back(i);
+      }
+    }
+
+    if (!selection.empty()) {
+      // Return the values in the order of the table, like ParmDBCasa.
+      std::sort(selection.begin(), selection.end(),
+                [&parameter](size_t left, size_t right) {
+                  return parameter.rows[left] < parameter.rows[right];
+                });
+      std::vector<ParmValue::ShPtr> values;
+      std::vector<Box> domains;
+      values.reserve(selection.size());
+      domains.reserve(selection.size());
+      for (size_t i : selection) {
+        // Return copies, because the caller may change the values.
+        values.push_back(std::make_shared<ParmValue>(*parameter.values[i]));
+        domains.push_back(Box(Point(parameter.start_x[i], parameter.start_y[i]),
+                              Point(parameter.end_x[i], parameter.end_y[i])));
+      }
+      pvset = ParmValueSet(domains, values, ParmValue(), parameter.type,
+                           parameter.perturbation, parameter.pert_rel);
+    } else {
+      // No matching values, so get default value.
+      ParmValueSet pvdef = getDefValue(itsNames[id], ParmValue());
+      pvset = ParmValueSet(pvdef.getFirstParmValue(), parameter.type,
+                           parameter.perturbation, parameter.pert_rel);
+    }
+    if (parameter.solvable_mask.ndim() > 0) {
+      pvset.setSolvableMask(parameter.solvable_mask);
+    }
+  }
+}
+
+void ParmDBMemory::getDefValues(ParmMap& result,
+                                const std::string& parmNamePattern) {
+  const Regex regex(Regex::fromPattern(parmNamePattern));
+  for (const ParmMap::valueType& value : itsDefValues) {
+    if (casacore::String(value.first).matches(regex)) {
+      result.define(value.first, value.second);
+    }
+  }
+}
+
+void ParmDBMemory::fillDefMap(ParmMap& defMap) {
+  defMap.clear();
+  for (const ParmMap::valueType& value : itsDefValues) {
+    defMap.define(value.first, value.second);
+  }
+}
+
+std::vector<std::string> ParmDBMemory::getNames(const std::string& pattern) {
+  std::vector<std::string> names;
+  for (unsigned int id : findNameIds(pattern)) {
+    names.push_back(itsNames[id]);
+  }
+  return names;
+}
+
+int ParmDBMemory::getNameId(const std::string& parmName) {
+  const auto iter = itsNameIndex.find(parmName);
+  return iter == itsNameIndex.end() ? -1 : int(iter->second);
+}
+
+void ParmDBMemory::throwReadOnly() const {
+  throw std::runtime_error("ParmDB " + itsTableName +
+                           " is opened read-only in memory");
+}
+
+void ParmDBMemory::setDefaultSteps(const std::vector<double>&) {
+  throwReadOnly();
+}
+
+void ParmDBMemory::putValues(const std::string&, int&, ParmValueSet&) {
+  throwReadOnly();
+}
+
+void ParmDBMemory::deleteValues(const std::string&, const Box&) {
+  throwReadOnly();
+}
+
+void ParmDBMemory::putDefValue(const std::string&, const ParmValueSet&, bool) {
+  throwReadOnly();
+}
+
+void ParmDBMemory::deleteDefValues(const std::string&) { throwReadOnly(); }
+
+void ParmDBMemory::clearTables() { throwReadOnly(); }
+
+}  // namespace parmdb
+}  // namespace dp3
@@ -0,0 +1,145 @@
+// ParmDBMemory.h: Read-only copy of a Casa parameter table in memory
+//
+// Copyright (C) 2023 ASTRON (Netherlands Institute for Radio Astronomy)
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/// @file
+/// @brief Read-only copy of a Casa parameter table in memory
+
+#ifndef LOFAR_PARMDB_PARMDBMEMORY_H
+#define LOFAR_PARMDB_PARMDBMEMORY_H
+
+#include "ParmDB.h"
+
+#include <casacore/casa/Arrays/Array.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace dp3 {
+namespace parmdb {
+
+/// @ingroup ParmDB
+/// @{
+
+/// @brief Read-only copy of a Casa parameter table in memory
+
+/// ParmDBMemory reads all names, values and default values of a ParmDBCasa
+/// table once, when it is constructed. Afterwards, lookups do not access the
+/// table anymore: names are found with a binary search in a sorted name
+/// index, which also limits pattern matching to the names that share the
+/// literal prefix of the pattern. The domains of each parameter are kept in
+/// arrays sorted on their start time, such that domain selections are binary
+/// searches as well.
+///
+/// All functions that modify the table throw an exception.
+class ParmDBMemory : public ParmDBRep {
+ public:
+  explicit ParmDBMemory(const std::string& tableName);
+
+  ~ParmDBMemory() override;
+
+  /// Get the domain range (time,freq) of the given parameters in the table.
+  /// This is the minimum and maximum value of these axes for all parameters.
+  /// An empty name pattern is the same as * (all parms).
+  ///@{
+  Box getRange(const std::string& parmNamePattern) const override;
+  Box getRange(const std::vector<std::string>& parmNames) const override;
+  ///@}
+
+  /// Set the default step values.
+  /// It throws an exception, because the table is read-only.
+  void setDefaultSteps(const std::vector<double>&) override;
+
+  /// Get the parameter values for the given parameters and domain.
+  /// The parmids form the indices in the result vector.
+  void getValues(std::vector<ParmValueSet>& values,
+                 const std::vector<unsigned int>& nameIds,
+                 const std::vector<ParmId>& parmIds,
+                 const Box& domain) override;
+
+  /// Put the values for the given parameter name and id.
+  /// It throws an exception, because the table is read-only.
+  void putValues(const std::string& parmName, int& nameId,
+                 ParmValueSet& values) override;
+
+  /// Delete the value records for the given parameters and domain.
+  /// It throws an exception, because the table is read-only.
+  void deleteValues(const std::string& parmNamePattern,
+                    const Box& domain) override;
+
+  /// Get the default value for the given parameters.
+  /// Only * and ? should be used in the pattern (no [] and {}).
+  void getDefValues(ParmMap& result,
+                    const std::string& parmNamePattern) override;
+
+  /// Put the default value.
+  /// It throws an exception, because the table is read-only.
+  void putDefValue(const std::string& name, const ParmValueSet& value,
+                   bool check = true) override;
+
+  /// Delete the default value records for the given parameters.
+  /// It throws an exception, because the table is read-only.
+  void deleteDefValues(const std::string& parmNamePattern) override;
+
+  /// Get the names of all parms matching the given (filename like) pattern.
+  /// The names are returned in the order of the NAMES table.
+  std::vector<std::string> getNames(const std::string& pattern) override;
+
+  /// Get the id of a parameter.
+  /// If not found in the Names table, it returns -1.
+  int getNameId(const std::string& parmName) override;
+
+  /// Clear database or table.
+  /// It throws an exception, because the table is read-only.
+  void clearTables() override;
+
+ private:
+  /// The information of a row in the NAMES table, and the values of that
+  /// parameter, sorted on the start time of their domain.
+  struct Parameter {
+    ParmValue::FunkletType type;
+    double perturbation;
+    bool pert_rel;
+    casacore::Array<bool> solvable_mask;
+    std::vector<double> start_x;
+    std::vector<double> end_x;
+    std::vector<double> start_y;
+    std::vector<double> end_y;
+    /// end_y_max[i] is the maximum of end_y[0..i], which is ascending.
+    std::vector<double> end_y_max;
+    /// Row number in the main table, which determines the order of the
+    /// values in the result.
+    std::vector<int> rows;
+    std::vector<ParmValue::ShPtr> values;
+  };
+
+  /// Fill the map with default values.
+  void fillDefMap(ParmMap& defMap) override;
+
+  /// Read the NAMES table and the main table.
+  void readTables(const std::string& tableName);
+
+  /// Get the name ids of the names matching the pattern, in ascending order.
+  std::vector<unsigned int> findNameIds(const std::string& pattern) const;
+
+  /// Extend the box with the domains of a parameter.
+  void extendRange(const Parameter& parameter, double& sx, double& ex,
+                   double& sy, double& ey) const;
+
+  [[noreturn]] void throwReadOnly() const;
+
+  std::string itsTableName;
+  std::vector<std::string> itsNames;  ///< indexed by name id
+  std::vector<Parameter> itsParameters;  ///< indexed by name id
+  std::map<std::string, unsigned int> itsNameIndex;
+  ParmMap itsDefValues;
+};
+
+/// @}
+
+}  // namespace parmdb
+}  // namespace dp3
+
+#endif
@@ -20,14 +20,14 @@ using namespace casacore;
 namespace dp3 {
 namespace parmdb {
 
-ParmFacade::ParmFacade(const string& tableName, bool create) {
+ParmFacade::ParmFacade(const string& tableName, bool create, bool inMemory) {
   // If create, only a local ParmDB can be done.
   // If it is an existing table, open it directly.
   // Otherwise it is a distributed ParmDB.
   if (create) {
     itsRep = std::make_shared<ParmFacadeLocal>(tableName, create);
   } else if (Table::isReadable(tableName)) {
-    itsRep = std::make_shared<ParmFacadeLocal>(tableName);
+    itsRep = std::make_shared<ParmFacadeLocal>(tableName, false, inMemory);
   } else {
     // itsRep = std::make_shared<ParmFacadeDistr>(tableName);
     throw std::runtime_error("distributed parm facade not available");
@@ -40,7 +40,10 @@ class ParmFacade {
   /// Otherwise the local or distributed ParmTable must exist.
   /// A distributed ParmTable should be given by means of the VDS-file as
   /// created by the scripts setupparmdb and setupsourcedb.
-  ParmFacade(const string& tableName, bool create = false);
+  /// If inMemory=true, an existing local ParmTable is read into memory once,
+  /// which makes lookups faster, but the table can not be changed.
+  ParmFacade(const string& tableName, bool create = false,
+             bool inMemory = false);
 
   /// The destructor closes the parm table.
   ~ParmFacade();
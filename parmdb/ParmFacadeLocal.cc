@@ -29,8 +29,10 @@ using namespace casacore;
 namespace dp3 {
 namespace parmdb {
 
-ParmFacadeLocal::ParmFacadeLocal(const string& tableName, bool create)
-    : itsPDB(ParmDBMeta("casa", tableName), create) {}
+ParmFacadeLocal::ParmFacadeLocal(const string& tableName, bool create,
+                                 bool inMemory)
+    : itsPDB(ParmDBMeta(inMemory && !create ? "casamemory" : "casa", tableName),
+             create) {}
 
 ParmFacadeLocal::~ParmFacadeLocal() {}
 
@@ -41,7 +41,9 @@ namespace parmdb {
 class ParmFacadeLocal : public ParmFacadeRep {
  public:
   /// Make a connection to a new or existing ParmTable.
-  ParmFacadeLocal(const string& tableName, bool create = false);
+  /// If inMemory=true, the existing ParmTable is read into memory.
+  ParmFacadeLocal(const string& tableName, bool create = false,
+                  bool inMemory = false);
 
   /// The destructor disconnects.
   ~ParmFacadeLocal() override;
@@ -0,0 +1,171 @@
+// SkymodelCache.cc: Compiled binary cache of a .skymodel text file
+//
+// Copyright (C) 2023 ASTRON (Netherlands Institute for Radio Astronomy)
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "SkymodelCache.h"
+
+#include <unistd.h>
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+
+#include "../blob/BlobIBufStream.h"
+#include "../blob/BlobIStream.h"
+#include "../blob/BlobOBufStream.h"
+#include "../blob/BlobOStream.h"
+
+namespace dp3 {
+namespace parmdb {
+namespace skymodel_cache {
+
+namespace {
+
+const std::string kObjectType = "skymodelcache";
+/// Increment this version when the layout of the cache changes, which
+/// invalidates all existing cache files.
+constexpr int kVersion = 2;
+
+/// Identifies the contents of a sky model file.
+struct FileKey {
+  std::string path;
+  int64_t modification_time;
+  uint64_t size;
+};
+
+FileKey GetFileKey(const std::string& filename) {
+  const std::filesystem::path path = std::filesystem::absolute(filename);
+  return FileKey{
+      path.string(),
+      static_cast<int64_t>(
+          std::filesystem::last_write_time(path).time_since_epoch().count()),
+      static_cast<uint64_t>(std::filesystem::file_size(path))};
+}
+
+/// Computes a 64-bit FNV-1a hash of the contents of a file.
+uint64_t HashFile(const std::string& filename) {
+  std::ifstream file(filename, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error("File " + filename +
+                             " could not be opened for reading.");
+  }
+  uint64_t hash = 14695981039346656037ull;
+  std::array<char, 1 << 16> chunk;
+  while (file) {
+    file.read(chunk.data(), chunk.size());
+    const std::streamsize n_read = file.gcount();
+    for (std::streamsize i = 0; i != n_read; ++i) {
+      hash ^= static_cast<unsigned char>(chunk[i]);
+      hash *= 1099511628211ull;
+    }
+  }
+  return hash;
+}
+
+}  // namespace
+
+std::string CacheFilename(const std::string& skymodel_filename) {
+  return skymodel_filename + ".dp3cache";
+}
+
+void Write(const SourceDBSkymodel& source_db,
+           const std::string& skymodel_filename, const std::string& format,
+           const std::string& cache_filename) {
+  const FileKey key = GetFileKey(skymodel_filename);
+  const uint64_t hash = HashFile(skymodel_filename);
+
+  // Write to a temporary file first: Renaming it is atomic, so jobs that
+  // read the cache concurrently never see a partially written file. The
+  // process id keeps concurrent writers from sharing a temporary file.
+  const std::string temporary_filename =
+      cache_filename + ".tmp" + std::to_string(getpid());
+  {
+    std::ofstream file(temporary_filename, std::ios::binary | std::ios::trunc);
+    if (!file) {
+      throw std::runtime_error("Sky model cache " + temporary_filename +
+                               " cannot be created");
+    }
+    blob::BlobOBufStream buffer(file);
+    blob::BlobOStream stream(buffer);
+    stream.putStart(kObjectType, kVersion);
+    stream << key.path << key.modification_time << key.size << hash << format;
+
+    const std::vector<PatchInfo>& patches = source_db.GetPatches();
+    stream << static_cast<uint64_t>(patches.size());
+    for (const PatchInfo& patch : patches) stream << patch;
+
+    const std::vector<SourceData>& sources = source_db.GetSources();
+    stream << static_cast<uint64_t>(sources.size());
+    for (const SourceData& source : sources) source.writeSource(stream);
+    stream.putEnd();
+
+    file.flush();
+    if (!file) {
+      throw std::runtime_error("Error writing sky model cache " +
+                               temporary_filename);
+    }
+  }
+  std::filesystem::rename(temporary_filename, cache_filename);
+}
+
+std::optional<SourceDBSkymodel> Read(const std::string& cache_filename,
+                                     const std::string& skymodel_filename,
+                                     const std::string& format) {
+  std::ifstream file(cache_filename, std::ios::binary);
+  if (!file) return std::nullopt;
+
+  try {
+    blob::BlobIBufStream buffer(file);
+    blob::BlobIStream stream(buffer);
+    if (stream.getNextType() != kObjectType) return std::nullopt;
+    if (stream.getStart(kObjectType) != kVersion) return std::nullopt;
+
+    FileKey cached_key;
+    uint64_t cached_hash;
+    std::string cached_format;
+    stream >> cached_key.path >> cached_key.modification_time >>
+        cached_key.size >> cached_hash >> cached_format;
+    if (cached_format != format) return std::nullopt;
+
+    // A matching path and modification time identifies the sky model without
+    // reading it. Otherwise, e.g. when the files were copied, fall back to
+    // comparing the contents.
+    const FileKey key = GetFileKey(skymodel_filename);
+    if (key.size != cached_key.size) return std::nullopt;
+    if ((key.path != cached_key.path ||
+         key.modification_time != cached_key.modification_time) &&
+        HashFile(skymodel_filename) != cached_hash) {
+      return std::nullopt;
+    }
+
+    SourceDBSkymodel source_db;
+    uint64_t n_patches;
+    stream >> n_patches;
+    for (uint64_t i = 0; i != n_patches; ++i) {
+      PatchInfo patch;
+      stream >> patch;
+      source_db.addPatch(patch.getName(), patch.getCategory(),
+                         patch.apparentBrightness(), patch.getRa(),
+                         patch.getDec(), false);
+    }
+
+    uint64_t n_sources;
+    stream >> n_sources;
+    source_db.ReserveSources(n_sources);
+    for (uint64_t i = 0; i != n_sources; ++i) {
+      SourceData source;
+      source.readSource(stream);
+      source_db.AddSource(std::move(source));
+    }
+    stream.getEnd();
+    return source_db;
+  } catch (std::exception&) {
+    // A corrupt cache is not fatal: The sky model is parsed instead.
+    return std::nullopt;
+  }
+}
+
+}  // namespace skymodel_cache
+}  // namespace parmdb
+}  // namespace dp3
@@ -0,0 +1,55 @@
+// SkymodelCache.h: Compiled binary cache of a .skymodel text file
+//
+// Copyright (C) 2023 ASTRON (Netherlands Institute for Radio Astronomy)
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/// @file
+/// @brief Compiled binary cache of a .skymodel text file.
+///
+/// Parsing a large text sky model takes a long time. A cache file contains
+/// the parsed patches and sources of a sky model, together with the path,
+/// modification time, size and hash of the sky model it was made from, and
+/// the format string it was parsed with. When the sky model or the format
+/// changes, the cache becomes stale and is not used.
+
+#ifndef DP3_PARMDB_SKYMODELCACHE_H_
+#define DP3_PARMDB_SKYMODELCACHE_H_
+
+#include <optional>
+#include <string>
+
+#include "SourceDBSkymodel.h"
+
+namespace dp3 {
+namespace parmdb {
+namespace skymodel_cache {
+
+/// @return The name of the cache file that SourceDBWrapper uses for the given
+/// sky model file.
+std::string CacheFilename(const std::string& skymodel_filename);
+
+/// Writes a cache file for a sky model. The file is written atomically, such
+/// that concurrent readers never see a partially written cache.
+/// @param source_db The parsed contents of the sky model file.
+/// @param skymodel_filename Name of the sky model file that was parsed.
+/// @param format The format string that the sky model was parsed with.
+/// @param cache_filename Name of the cache file to write.
+void Write(const SourceDBSkymodel& source_db,
+           const std::string& skymodel_filename, const std::string& format,
+           const std::string& cache_filename);
+
+/// Reads a cache file.
+/// @param format The format string that the caller would parse the sky model
+/// with.
+/// @return The cached sky model, or an empty optional if the cache file does
+/// not exist, has an unsupported version, is corrupt, was parsed with another
+/// format, or does not match the current contents of the sky model file.
+std::optional<SourceDBSkymodel> Read(const std::string& cache_filename,
+                                     const std::string& skymodel_filename,
+                                     const std::string& format);
+
+}  // namespace skymodel_cache
+}  // namespace parmdb
+}  // namespace dp3
+
+#endif
@@ -33,6 +33,10 @@ class SourceDBSkymodel final : public SourceDBBase {
   void updatePatch(unsigned patch_id, double apparent_brightness, double ra,
                    double dec) override;
 
+  /// Add an already complete source, without checking its name or patch.
+  void AddSource(SourceData&& source) { sources_.push_back(std::move(source)); }
+  void ReserveSources(std::size_t n_sources) { sources_.reserve(n_sources); }
+
   std::vector<std::string> FindPatches(const std::string& pattern) const;
   const std::vector<PatchInfo>& GetPatches() const { return patches_; }
 
@@ -106,6 +106,7 @@
 // See the various test/tmakesourcedb files for an example.
 
 #include "SkymodelToSourceDB.h"
+#include "SkymodelCache.h"
 
 #include <boost/algorithm/string/case_conv.hpp>
 
@@ -116,7 +117,11 @@ int main(int argc, char* argv[]) {
     inputs.version("GvD 2013-May-16");
     inputs.create("in", "", "Input file name", "string");
     inputs.create("out", "", "Output sourcedb name", "string");
-    inputs.create("outtype", "casa", "Output type (casa or blob)", "string");
+    inputs.create("outtype", "casa",
+                  "Output type (casa, blob or skymodelcache). A skymodelcache "
+                  "is used by DP3 instead of parsing the input skymodel if "
+                  "its name is the skymodel name followed by .dp3cache",
+                  "string");
     inputs.create("format", "<",
                   "Format of the input lines or name of file containing format",
                   "string");
@@ -173,6 +178,16 @@ int main(int argc, char* argv[]) {
           dp3::parmdb::skymodel_to_source_db::ReadFormat(format.substr(st), in);
     }
 
+    if (outType == "skymodelcache") {
+      // The cache should hold exactly what DP3 obtains when parsing the
+      // skymodel, thus the patch and search options do not apply.
+      dp3::parmdb::skymodel_cache::Write(
+          dp3::parmdb::skymodel_to_source_db::MakeSourceDBSkymodel(in, format),
+          in, format, out);
+      std::cout << "Wrote skymodel cache " << out << " for " << in << '\n';
+      return 0;
+    }
+
     dp3::parmdb::skymodel_to_source_db::MakeSourceDb(
         in, out, outType, format, prefix, suffix, append, average, check,
         dp3::parmdb::skymodel_to_source_db::GetSearchInfo(center, radius,
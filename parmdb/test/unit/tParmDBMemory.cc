@@ -0,0 +1,110 @@
+// Copyright (C) 2023 ASTRON (Netherlands Institute for Radio Astronomy)
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "../../ParmFacade.h"
+
+#include <casacore/casa/Arrays/Matrix.h>
+#include <casacore/casa/Arrays/Vector.h>
+#include <casacore/casa/Containers/Record.h>
+
+#include <boost/test/unit_test.hpp>
+
+using dp3::parmdb::ParmFacade;
+
+namespace {
+
+const std::string kParmDBName = "tParmDBMemory_tmp.parmdb";
+
+void AddValue(ParmFacade& parmdb, const std::string& name, double start_time,
+              double offset) {
+  const size_t kNFreqs = 3;
+  const size_t kNTimes = 4;
+  casacore::Matrix<double> values(kNFreqs, kNTimes);
+  casacore::Vector<double> freqs(kNFreqs);
+  casacore::Vector<double> times(kNTimes);
+  for (size_t f = 0; f < kNFreqs; ++f) {
+    freqs[f] = 100.0e6 + f * 1.0e6;
+    for (size_t t = 0; t < kNTimes; ++t) {
+      times[t] = start_time + t * 10.0;
+      values(f, t) = offset + f + 0.1 * t;
+    }
+  }
+  casacore::Record value;
+  value.define("values", values);
+  value.define("freqs", freqs);
+  value.define("freqwidths", casacore::Vector<double>(kNFreqs, 1.0e6));
+  value.define("times", times);
+  value.define("timewidths", casacore::Vector<double>(kNTimes, 10.0));
+  casacore::Record record;
+  record.defineRecord(name, value);
+  parmdb.addValues(record);
+}
+
+void CreateParmDB() {
+  ParmFacade parmdb(kParmDBName, true);
+  for (const std::string& antenna : {"CS001", "CS002", "RS106"}) {
+    // Two domains in time, added in reverse order.
+    AddValue(parmdb, "Gain:0:0:Real:" + antenna, 1040.0, 2.0);
+    AddValue(parmdb, "Gain:0:0:Real:" + antenna, 1000.0, 1.0);
+    AddValue(parmdb, "Gain:1:1:Real:" + antenna, 1000.0, 3.0);
+  }
+  casacore::Record default_value;
+  default_value.define("value", 0.5);
+  casacore::Record record;
+  record.defineRecord("Gain:0:0:Imag", default_value);
+  parmdb.addDefValues(record);
+  parmdb.flush();
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(parmdb_memory)
+
+BOOST_AUTO_TEST_CASE(same_as_casa_table) {
+  CreateParmDB();
+  ParmFacade casa_table(kParmDBName);
+  ParmFacade memory_table(kParmDBName, false, true);
+
+  for (const std::string& pattern :
+       {"*", "Gain:0:0:Real*", "Gain:?:?:Real:CS00*", "Gain:1:1:Real:RS106",
+        "{Common,}Gain:0:0:*", "Gain:0:0:Imag*", "NoSuchParm*"}) {
+    BOOST_TEST(memory_table.getNames(pattern) == casa_table.getNames(pattern),
+               boost::test_tools::per_element());
+    BOOST_TEST(memory_table.getNames(pattern, true) ==
+                   casa_table.getNames(pattern, true),
+               boost::test_tools::per_element());
+    BOOST_TEST(memory_table.getRange(pattern) == casa_table.getRange(pattern),
+               boost::test_tools::per_element());
+    BOOST_TEST(memory_table.getDefNames(pattern) ==
+                   casa_table.getDefNames(pattern),
+               boost::test_tools::per_element());
+
+    // Domains within one time domain, spanning both and outside all values.
+    for (const std::pair<double, double>& times :
+         {std::make_pair(1005.0, 1025.0), std::make_pair(1015.0, 1065.0),
+          std::make_pair(2000.0, 2020.0)}) {
+      const std::map<std::string, std::vector<double>> expected =
+          casa_table.getValuesMap(pattern, 99.5e6, 102.5e6, 0.5e6, times.first,
+                                  times.second, 5.0, true, true);
+      const std::map<std::string, std::vector<double>> result =
+          memory_table.getValuesMap(pattern, 99.5e6, 102.5e6, 0.5e6,
+                                    times.first, times.second, 5.0, true, true);
+      BOOST_REQUIRE_EQUAL(result.size(), expected.size());
+      for (const auto& [name, values] : expected) {
+        BOOST_REQUIRE(result.count(name));
+        BOOST_TEST(result.at(name) == values, boost::test_tools::per_element());
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(read_only) {
+  CreateParmDB();
+  ParmFacade memory_table(kParmDBName, false, true);
+  BOOST_CHECK_THROW(AddValue(memory_table, "Gain:0:0:Real:CS003", 1000.0, 0.0),
+                    std::runtime_error);
+  BOOST_CHECK_THROW(memory_table.deleteDefValues("*"), std::runtime_error);
+  BOOST_CHECK_THROW(memory_table.clearTables(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
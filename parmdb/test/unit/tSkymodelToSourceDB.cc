@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "../../SkymodelToSourceDB.h"
+#include "../../SkymodelCache.h"
 
 #include "../../SourceDB.h"
 #include "../../../common/test/unit/fixtures/fDirectory.h"
@@ -11,6 +12,7 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <filesystem>
 #include <iostream>
 #include <fstream>
 
@@ -152,4 +154,52 @@ BOOST_AUTO_TEST_CASE(read_skymodel) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(skymodel_cache) {
+  namespace cache = dp3::parmdb::skymodel_cache;
+  const std::string skymodel_name = "cached.skymodel";
+  const std::string cache_name = cache::CacheFilename(skymodel_name);
+  std::filesystem::copy_file(kSkymodelName, skymodel_name);
+
+  const std::string format =
+      dp3::parmdb::skymodel_to_source_db::ReadFormat("", skymodel_name);
+  BOOST_CHECK(!cache::Read(cache_name, skymodel_name, format));
+
+  cache::Write(dp3::parmdb::skymodel_to_source_db::MakeSourceDBSkymodel(
+                   skymodel_name, format),
+               skymodel_name, format, cache_name);
+  // The temporary file is renamed to the cache file.
+  for (const auto& entry : std::filesystem::directory_iterator(".")) {
+    BOOST_CHECK(entry.path().filename().string().rfind(cache_name + ".tmp",
+                                                       0) != 0);
+  }
+
+  // A cache of a sky model that was parsed with another format is not used.
+  BOOST_CHECK(!cache::Read(cache_name, skymodel_name, format + ", Extra"));
+
+  const std::optional<dp3::parmdb::SourceDBSkymodel> source_db =
+      cache::Read(cache_name, skymodel_name, format);
+  BOOST_REQUIRE(source_db);
+  BOOST_REQUIRE_EQUAL(source_db->GetPatches().size(), 3u);
+  const std::vector<std::string> patch_list =
+      dp3::base::MakePatchList(*source_db, std::vector<std::string>{});
+  const std::vector<std::shared_ptr<dp3::base::Patch>> patches =
+      dp3::base::MakePatches(*source_db, patch_list);
+  BOOST_REQUIRE_EQUAL(patches.size(), 3u);
+  CheckEqual(*patches[0], test_source_db::Expected[0]);
+  CheckEqual(*patches[1], test_source_db::Expected[1]);
+  CheckEqual(*patches[2], test_source_db::Expected[2]);
+
+  // SourceDBWrapper should use the cache.
+  dp3::base::SourceDBWrapper wrapper(skymodel_name);
+  wrapper.Filter({"*"}, dp3::base::SourceDBWrapper::FilterMode::kPattern);
+  BOOST_CHECK_EQUAL(wrapper.MakePatchList().size(), 3u);
+
+  // Changing the skymodel makes the cache stale.
+  {
+    std::ofstream skymodel(skymodel_name, std::ios::app);
+    skymodel << "\n";
+  }
+  BOOST_CHECK(!cache::Read(cache_name, skymodel_name, format));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -38,6 +38,29 @@ std::array<std::size_t, 3> ConvertShape(const pybind11::ssize_t* shape) {
           static_cast<std::size_t>(shape[2])};
 }
 
+/// Copies a numpy array into a DPBuffer tensor. When the array is a view on
+/// the tensor itself, e.g., because it was obtained using get_data(), the
+/// tensor already holds the values and copying is skipped.
+template <typename T, typename Tensor>
+void AssignFromNumpy(const py::array_t<T, py::array::c_style>& array,
+                     const typename Tensor::shape_type& shape,
+                     Tensor& tensor) {
+  tensor.resize(shape);
+  if (array.data() != tensor.data()) {
+    std::copy_n(array.data(), tensor.size(), tensor.data());
+  }
+}
+
+/// Creates a Python list with a span for each buffer in a batch.
+template <typename GetTensor>
+py::list CreateSpanList(PyDpBufferBatch& batch, GetTensor get_tensor) {
+  py::list spans;
+  for (PyDpBuffer& buffer : batch.buffers) {
+    spans.append(py::cast(aocommon::xt::CreateSpan(get_tensor(*buffer))));
+  }
+  return spans;
+}
+
 }  // namespace
 
 void WrapDpBuffer(py::module& m) {
@@ -113,10 +136,8 @@ void WrapDpBuffer(py::module& m) {
                   "n_channels, n_correlations); the input provided contains " +
                   std::to_string(numpy_data.ndim()) + " dimensions.");
             }
-            DPBuffer& buffer = *self;
-            buffer.GetData().resize(ConvertShape(numpy_data.shape()));
-            std::copy_n(numpy_data.data(), buffer.GetData().size(),
-                        buffer.GetData().data());
+            AssignFromNumpy(numpy_data, ConvertShape(numpy_data.shape()),
+                            self->GetData());
           },
           "Set buffer data from a 3-D numpy array of complex float type.")
       .def(
@@ -129,9 +150,8 @@ void WrapDpBuffer(py::module& m) {
                   "n_channels, n_correlations); the input provided contains " +
                   std::to_string(numpy_data.ndim()) + " dimensions.");
             }
-            self->GetData(name).resize(ConvertShape(numpy_data.shape()));
-            std::copy_n(numpy_data.data(), self->GetData(name).size(),
-                        self->GetData(name).data());
+            AssignFromNumpy(numpy_data, ConvertShape(numpy_data.shape()),
+                            self->GetData(name));
           },
           "Set buffer data with the given name from a 3-D numpy array of "
           "complex float type.")
@@ -152,10 +172,9 @@ void WrapDpBuffer(py::module& m) {
                   "Provided array should have three dimensions (n_baselines, "
                   "n_channels, n_correlations).");
             }
-            DPBuffer& buffer = *self;
-            buffer.GetWeights().resize(ConvertShape(numpy_weights.shape()));
-            std::copy_n(numpy_weights.data(), buffer.GetWeights().size(),
-                        buffer.GetWeights().data());
+            AssignFromNumpy(numpy_weights,
+                            ConvertShape(numpy_weights.shape()),
+                            self->GetWeights());
           },
           "Set buffer weights from a 3-D numpy array of float type.")
       .def(
@@ -167,10 +186,8 @@ void WrapDpBuffer(py::module& m) {
                   "Provided array should have three dimensions (n_baselines, "
                   "n_channels, n_correlations).");
             }
-            DPBuffer& buffer = *self;
-            buffer.GetFlags().resize(ConvertShape(numpy_flags.shape()));
-            std::copy_n(numpy_flags.data(), buffer.GetFlags().size(),
-                        buffer.GetFlags().data());
+            AssignFromNumpy(numpy_flags, ConvertShape(numpy_flags.shape()),
+                            self->GetFlags());
           },
           "Set buffer flags from a 3-D numpy array of boolean type.")
       .def(
@@ -186,13 +203,58 @@ void WrapDpBuffer(py::module& m) {
               throw std::runtime_error(
                   "Each baseline should have 3 uvw values.");
             }
-            DPBuffer& buffer = *self;
-            buffer.GetUvw().resize(
-                {static_cast<std::size_t>(numpy_uvw.shape(0)), 3u});
-            std::copy_n(numpy_uvw.data(), buffer.GetUvw().size(),
-                        buffer.GetUvw().data());
+            AssignFromNumpy(
+                numpy_uvw, {static_cast<std::size_t>(numpy_uvw.shape(0)), 3u},
+                self->GetUvw());
           },
           "Set buffer uvw from a 2-D numpy array of double type.");
+
+  py::class_<PyDpBufferBatch>(m, "DPBufferBatch")
+      .def("__len__",
+           [](const PyDpBufferBatch& self) { return self.buffers.size(); })
+      .def(
+          "__getitem__",
+          [](PyDpBufferBatch& self, std::size_t index) -> PyDpBuffer& {
+            if (index >= self.buffers.size()) throw py::index_error();
+            return self.buffers[index];
+          },
+          py::return_value_policy::reference_internal,
+          "Get the buffer for the time slot with the given index.")
+      .def(
+          "get_data",
+          [](PyDpBufferBatch& self, const std::string& name) {
+            for (PyDpBuffer& buffer : self.buffers) {
+              if (!buffer->HasData(name)) {
+                throw std::runtime_error("Buffer has no data named '" + name +
+                                         "'");
+              }
+            }
+            return CreateSpanList(self, [&name](DPBuffer& buffer) -> auto& {
+              return buffer.GetData(name);
+            });
+          },
+          "Get a list with a data buffer for each time slot, which can be "
+          "used as numpy arrays without copying the data. See "
+          "DPBuffer.get_data().",
+          py::arg("name") = "")
+      .def(
+          "get_flags",
+          [](PyDpBufferBatch& self) {
+            return CreateSpanList(self, [](DPBuffer& buffer) -> auto& {
+              return buffer.GetFlags();
+            });
+          },
+          "Get a list with a flags buffer for each time slot, which can be "
+          "used as numpy arrays without copying the data.")
+      .def(
+          "get_weights",
+          [](PyDpBufferBatch& self) {
+            return CreateSpanList(self, [](DPBuffer& buffer) -> auto& {
+              return buffer.GetWeights();
+            });
+          },
+          "Get a list with a weights buffer for each time slot, which can be "
+          "used as numpy arrays without copying the data.");
 }
 
 }  // namespace pythondp3
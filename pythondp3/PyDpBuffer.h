@@ -1,6 +1,8 @@
 // Copyright (C) 2023 ASTRON (Netherlands Institute for Radio Astronomy)
 // SPDX-License-Identifier: GPL-3.0-or-later
 
+#include <vector>
+
 #include <aocommon/py/uniqueptr.h>
 
 #include <dp3/base/DPBuffer.h>
@@ -12,5 +14,11 @@ namespace pythondp3 {
 /// std::unique_ptr<DPBuffer> to Step::process().
 using PyDpBuffer = aocommon::py::PyUniquePointer<dp3::base::DPBuffer>;
 
+/// A batch of consecutive time slots, which PyStep passes to a Python step
+/// in a single call when batch processing is enabled.
+struct PyDpBufferBatch {
+  std::vector<PyDpBuffer> buffers;
+};
+
 }  // namespace pythondp3
 }  // namespace dp3
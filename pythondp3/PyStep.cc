@@ -50,12 +50,21 @@ void PyStep::finish() {
   // Python steps that can be used as end point of a pipeline
   // like for example the QueueOutput step.
   // Ticket AST-1105 aims to be bring the C++ and Python behaviour more in line.
+  if (!pending_buffers_.empty()) ProcessBatch();
   pybind11::function finish_override = pybind11::get_override(this, "finish");
   if (finish_override) finish_override();  // Call the Python function.
   if (getNextStep()) getNextStep()->finish();
 }
 
 bool PyStep::process(std::unique_ptr<DPBuffer> buffer) {
+  if (batch_size_ <= 1) return ProcessSingle(std::move(buffer));
+
+  pending_buffers_.push_back(std::move(buffer));
+  if (pending_buffers_.size() == batch_size_) ProcessBatch();
+  return true;
+}
+
+bool PyStep::ProcessSingle(std::unique_ptr<DPBuffer> buffer) {
   PYBIND11_OVERRIDE_PURE(
       bool,    /* Return type */
       Step,    /* Parent class */
@@ -64,6 +73,32 @@ bool PyStep::process(std::unique_ptr<DPBuffer> buffer) {
   );
 }
 
+void PyStep::ProcessBatch() {
+  pybind11::gil_scoped_acquire gil;  // Acquire the GIL once for all buffers.
+
+  pybind11::function batch_override =
+      pybind11::get_override(this, "process_batch");
+  if (batch_override) {
+    PyDpBufferBatch batch;
+    batch.buffers.reserve(pending_buffers_.size());
+    for (std::unique_ptr<DPBuffer>& buffer : pending_buffers_) {
+      batch.buffers.emplace_back(std::move(buffer));
+    }
+    pending_buffers_.clear();
+    batch_override(std::move(batch));
+  } else {
+    pybind11::function process_override =
+        pybind11::get_override(this, "process");
+    if (!process_override) {
+      throw std::runtime_error("Python step does not implement process()");
+    }
+    for (std::unique_ptr<DPBuffer>& buffer : pending_buffers_) {
+      process_override(PyDpBuffer(std::move(buffer)));
+    }
+    pending_buffers_.clear();
+  }
+}
+
 common::Fields PyStep::getRequiredFields() const {
   PYBIND11_OVERRIDE_PURE_NAME(
       common::Fields, Step, "get_required_fields", getRequiredFields,
@@ -92,6 +127,8 @@ std::shared_ptr<PyStep> PyStep::create_instance(
     const common::ParameterSet& parset, const string& prefix) {
   std::string module_name = parset.getString(prefix + "python.module");
   std::string class_name = parset.getString(prefix + "python.class");
+  const std::size_t batch_size =
+      parset.getUint(prefix + "python.batchsize", 1);
 
   try {
     pybind11::initialize_interpreter();
@@ -117,6 +154,7 @@ std::shared_ptr<PyStep> PyStep::create_instance(
   auto pystep = std::shared_ptr<PyStep>(
       pyobject_step->cast<PyStep*>(),
       [pyobject_step](PyStep*) { delete pyobject_step; });
+  pystep->SetBatchSize(batch_size);
 
   return pystep;
 }
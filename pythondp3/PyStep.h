@@ -4,6 +4,8 @@
 #ifndef DP3_STEPS_PYDPSTEP_H_
 #define DP3_STEPS_PYDPSTEP_H_
 
+#include <vector>
+
 #include <dp3/steps/Step.h>
 #include "../common/ParameterSet.h"
 
@@ -25,9 +27,25 @@ class PyStep final : public steps::Step {
 
   void updateInfo(const base::DPInfo&) override;
 
+  /// When the batch size is larger than one, the buffers are collected until
+  /// a batch is complete. The whole batch is then passed to the
+  /// process_batch() method of the Python step, while holding the GIL only
+  /// once. If the Python step does not override process_batch(), its
+  /// process() method is called for each buffer in the batch.
   bool process(std::unique_ptr<base::DPBuffer>) override;
 
   void finish() override;
+
+  void SetBatchSize(std::size_t batch_size) { batch_size_ = batch_size; }
+  std::size_t GetBatchSize() const { return batch_size_; }
+
+ private:
+  bool ProcessSingle(std::unique_ptr<base::DPBuffer> buffer);
+  /// Passes all pending buffers to the Python step.
+  void ProcessBatch();
+
+  std::size_t batch_size_ = 1;
+  std::vector<std::unique_ptr<base::DPBuffer>> pending_buffers_;
 };
 
 }  // namespace pythondp3
@@ -122,6 +122,18 @@ PYBIND11_MODULE(pydp3, m) {
             return step.process(buffer.take());
           },
           "process buffer")
+      .def(
+          "process_batch",
+          [](dp3::steps::Step &step, PyDpBufferBatch &batch) {
+            bool result = true;
+            for (PyDpBuffer &buffer : batch.buffers) {
+              result = step.process(buffer.take()) && result;
+            }
+            return result;
+          },
+          "Process all buffers in a batch. Python steps may override this "
+          "method to handle all time slots in a batch at once, which requires "
+          "setting the python.batchsize parameter.")
       .def("finish", &Step::finish,
            "Finish processing (nextstep->finish will be called automatically")
       .def("get_next_step", &Step::getNextStep,
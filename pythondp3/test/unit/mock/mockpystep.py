@@ -68,3 +68,24 @@ class MockPyStep(Step):
         step accumulates multiple time slots.
         """
         pass
+
+
+class MockPyBatchStep(MockPyStep):
+    """Example python DPStep that processes a batch of time slots at once.
+    This requires setting the python.batchsize parameter."""
+
+    def process_batch(self, batch):
+        """
+        Process a batch of time slots. This function MUST call
+        self.get_next_step().process_batch
+
+        Args:
+          batch: DPBufferBatch object with a DPBuffer for each time slot.
+        """
+
+        for data in batch.get_data():
+            np.array(data, copy=False)[:] *= self.datafactor
+        for weights in batch.get_weights():
+            np.array(weights, copy=False)[:] *= self.weightsfactor
+
+        self.get_next_step().process_batch(batch)
@@ -7,6 +7,7 @@
 #include <sstream>
 
 #include <boost/test/unit_test.hpp>
+#include <boost/test/data/test_case.hpp>
 
 #include <xtensor/xtensor.hpp>
 
@@ -110,6 +111,8 @@ class TestOutput final : public dp3::steps::test::ThrowStep {
   void finish() override {}
   void updateInfo(const DPInfo&) override {}
 
+  int GetCount() const { return count_; }
+
  private:
   int count_;
 };
@@ -163,6 +166,27 @@ BOOST_AUTO_TEST_CASE(simple_pystep) {
   BOOST_TEST(py_step_weak_ptr.expired());
 }
 
+BOOST_DATA_TEST_CASE(batch_pystep,
+                     boost::unit_test::data::make({"MockPyStep",
+                                                   "MockPyBatchStep"}),
+                     class_name) {
+  auto in_step = std::make_shared<TestInput>();
+  // Requires mockpystep to be on the PYTHONPATH!
+  ParameterSet parset;
+  parset.add("mock.python.module", "mockpystep");
+  parset.add("mock.python.class", class_name);
+  parset.add("mock.python.batchsize", "3");
+  parset.add("mock.datafactor", "2");
+  parset.add("mock.weightsfactor", "0.5");
+  std::shared_ptr<PyStep> py_step = PyStep::create_instance(parset, "mock.");
+  BOOST_CHECK_EQUAL(py_step->GetBatchSize(), 3);
+  auto out_step = std::make_shared<TestOutput>();
+
+  dp3::steps::test::Execute({in_step, py_step, out_step});
+  // The last, incomplete, batch is processed in finish().
+  BOOST_CHECK_EQUAL(out_step->GetCount(), kNTimes);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }  // namespace pythondp3
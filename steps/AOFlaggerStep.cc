@@ -36,6 +36,7 @@ AOFlaggerStep::AOFlaggerStep(const common::ParameterSet& parset,
       buffer_index_(0),
       n_times_(0),
       memory_needed_(0),
+      memory_budget_("AOFlagger " + prefix),
       flag_counter_(parset, prefix + "count."),
       move_time_(0),
       flag_time_(0),
@@ -99,8 +100,12 @@ void AOFlaggerStep::updateInfo(const DPInfo& infoIn) {
   info() = infoIn;
   // Determine available memory.
   double availMemory = casacore::HostInfo::memoryTotal() * 1024.;
-  // Determine how much memory can be used.
-  double memory = common::AvailableMemory(memory_, memory_percentage_, false);
+  // Determine how much memory can be used. Without explicit limits, use the
+  // share of the memory budget.
+  const double memory =
+      (memory_ > 0 || memory_percentage_ > 0)
+          ? common::AvailableMemory(memory_, memory_percentage_, false)
+          : memory_budget_.GetShare();
 
   // Determine how much buffer space is needed per time slot.
   // The flagger needs 3 extra work buffers (data+flags) per thread.
@@ -152,6 +157,7 @@ void AOFlaggerStep::updateInfo(const DPInfo& infoIn) {
         " too large for available memory " + std::to_string(availMemory));
   // Size the buffer (need overlap on both sides).
   buffer_.resize(window_size_ + 2 * overlap_);
+  memory_budget_.SetUsage(memory_needed_);
   // Initialize the flag counters.
   flag_counter_.init(getInfo());
 
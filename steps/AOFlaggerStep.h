@@ -14,6 +14,7 @@
 
 #include <dp3/base/DPBuffer.h>
 #include "../base/FlagCounter.h"
+#include "../common/Memory.h"
 
 #include <memory>
 #include <mutex>
@@ -120,6 +121,7 @@ class AOFlaggerStep : public Step {
   double memory_;  ///< Usable memory in GBytes
   double memory_percentage_;
   double memory_needed_;  ///< Memory needed for data/flags
+  common::MemoryBudget::Consumer memory_budget_;
   bool flag_auto_correlations_;
   bool collect_statistics_;
   std::vector<std::unique_ptr<base::DPBuffer>> buffer_;
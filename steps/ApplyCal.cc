@@ -7,6 +7,7 @@
 #include "ApplyCal.h"
 
 #include <stddef.h>
+#include <algorithm>
 #include <string>
 #include <sstream>
 #include <utility>
@@ -18,6 +19,7 @@
 #include "../common/ParameterValue.h"
 #include "../common/Timer.h"
 
+using dp3::base::BDABuffer;
 using dp3::base::DPBuffer;
 using dp3::base::DPInfo;
 
@@ -37,6 +39,77 @@ inline void CheckBuffer(const DPBuffer& buffer, std::size_t baseline,
   assert(buffer.GetFlags().shape(1) == buffer.GetData().shape(1));
 }
 
+inline void CheckRow(const BDABuffer::Row& row, std::size_t channel) {
+  assert(channel < row.n_channels);
+  assert(4 == row.n_correlations);
+  assert(row.data);
+  assert(row.flags);
+}
+
+/// Flags the four correlations of a visibility, because its gains are not
+/// finite. Only the first correlation is considered for the flag counter.
+void FlagVisibility(bool* flags, std::size_t baseline, std::size_t channel,
+                    dp3::base::FlagCounter& flag_counter) {
+  if (!flags[0]) {
+    flag_counter.incrChannel(channel);
+    flag_counter.incrBaseline(baseline);
+  }
+  std::fill_n(flags, 4, true);
+}
+
+/// Applies diagonal gains to the 2x2 visibilities at 'data'. The regular and
+/// BDA versions of ApplyCal::ApplyDiag only differ in how they find 'data',
+/// 'flags' and 'weights'. 'weights' may be null if update_weights is false.
+void ApplyDiagToVisibility(const aocommon::MC2x2FDiag& gain_a,
+                           const aocommon::MC2x2FDiag& gain_b,
+                           std::complex<float>* data, bool* flags,
+                           float* weights, std::size_t baseline,
+                           std::size_t channel, bool update_weights,
+                           dp3::base::FlagCounter& flag_counter) {
+  // If parameter is NaN or inf, do not apply anything and flag the data
+  if (!(isfinite(gain_a[0]) && isfinite(gain_b[0]) && isfinite(gain_a[1]) &&
+        isfinite(gain_b[1]))) {
+    FlagVisibility(flags, baseline, channel, flag_counter);
+    return;
+  }
+
+  aocommon::MC2x2F visibilities(data);
+  visibilities = gain_a * visibilities * gain_b.HermTranspose();
+  visibilities.AssignTo(data);
+
+  if (update_weights) {
+    weights[0] /= std::norm(gain_a[0]) * std::norm(gain_b[0]);
+    weights[1] /= std::norm(gain_a[0]) * std::norm(gain_b[1]);
+    weights[2] /= std::norm(gain_a[1]) * std::norm(gain_b[0]);
+    weights[3] /= std::norm(gain_a[1]) * std::norm(gain_b[1]);
+  }
+}
+
+/// Applies full Jones gains to the 2x2 visibilities at 'data'.
+/// @see ApplyDiagToVisibility.
+void ApplyFullToVisibility(const aocommon::MC2x2F& gain_a,
+                           const aocommon::MC2x2F& gain_b,
+                           std::complex<float>* data, bool* flags,
+                           float* weights, std::size_t baseline,
+                           std::size_t channel, bool update_weights,
+                           dp3::base::FlagCounter& flag_counter) {
+  // If parameter is NaN or inf, do not apply anything and flag the data
+  for (unsigned int corr = 0; corr < 4; ++corr) {
+    if (!(isfinite(gain_a[corr]) && isfinite(gain_b[corr]))) {
+      FlagVisibility(flags, baseline, channel, flag_counter);
+      return;
+    }
+  }
+
+  aocommon::MC2x2F visibilities(data);
+  visibilities = gain_a * visibilities.MultiplyHerm(gain_b);
+  visibilities.AssignTo(data);
+
+  if (update_weights) {
+    dp3::steps::ApplyCal::ApplyWeights(gain_a, gain_b, weights);
+  }
+}
+
 }  // namespace
 
 namespace dp3 {
@@ -44,8 +117,8 @@ namespace steps {
 
 ApplyCal::ApplyCal(const common::ParameterSet& parset,
                    const std::string& prefix, bool substep,
-                   std::string predictDirection)
-    : is_sub_step_(substep) {
+                   std::string predictDirection, MsType input_type)
+    : is_sub_step_(substep), input_type_(input_type) {
   std::vector<std::string> subStepNames;
   common::ParameterValue namesPar(parset.getString(prefix + "steps", ""));
 
@@ -68,7 +141,8 @@ ApplyCal::ApplyCal(const common::ParameterSet& parset,
       subStepPrefix = prefix + subStepName + ".";
     }
     apply_cals_.push_back(std::make_shared<OneApplyCal>(
-        parset, subStepPrefix, prefix, substep, predictDirection));
+        parset, subStepPrefix, prefix, substep, predictDirection,
+        input_type));
   }
 
   Step::setNextStep(apply_cals_.front());
@@ -104,6 +178,11 @@ bool ApplyCal::process(std::unique_ptr<DPBuffer> buffer) {
   return true;
 }
 
+bool ApplyCal::process(std::unique_ptr<BDABuffer> buffer) {
+  getNextStep()->process(std::move(buffer));
+  return true;
+}
+
 void ApplyCal::finish() {
   // Let the next steps finish.
   getNextStep()->finish();
@@ -114,34 +193,22 @@ void ApplyCal::ApplyDiag(const aocommon::MC2x2FDiag& gain_a,
                          unsigned int baseline, unsigned int channel,
                          bool update_weights, base::FlagCounter& flag_counter) {
   CheckBuffer(buffer, baseline, channel);
+  ApplyDiagToVisibility(
+      gain_a, gain_b, &buffer.GetData()(baseline, channel, 0),
+      &buffer.GetFlags()(baseline, channel, 0),
+      update_weights ? &buffer.GetWeights()(baseline, channel, 0) : nullptr,
+      baseline, channel, update_weights, flag_counter);
+}
 
-  // If parameter is NaN or inf, do not apply anything and flag the data
-  if (!(isfinite(gain_a[0]) && isfinite(gain_b[0]) && isfinite(gain_a[1]) &&
-        isfinite(gain_b[1]))) {
-    // Only update flagcounter for first correlation
-    if (!buffer.GetFlags()(baseline, channel, 0)) {
-      flag_counter.incrChannel(channel);
-      flag_counter.incrBaseline(baseline);
-    }
-    xt::view(buffer.GetFlags(), baseline, channel, xt::all()).fill(true);
-    return;
-  }
-
-  aocommon::MC2x2F visibilities(&buffer.GetData()(baseline, channel, 0));
-  visibilities = gain_a * visibilities * gain_b.HermTranspose();
-  visibilities.AssignTo(&buffer.GetData()(baseline, channel, 0));
-
-  if (update_weights) {
-    DPBuffer::WeightsType& weights = buffer.GetWeights();
-    weights(baseline, channel, 0) /=
-        std::norm(gain_a[0]) * std::norm(gain_b[0]);
-    weights(baseline, channel, 1) /=
-        std::norm(gain_a[0]) * std::norm(gain_b[1]);
-    weights(baseline, channel, 2) /=
-        std::norm(gain_a[1]) * std::norm(gain_b[0]);
-    weights(baseline, channel, 3) /=
-        std::norm(gain_a[1]) * std::norm(gain_b[1]);
-  }
+void ApplyCal::ApplyDiag(const aocommon::MC2x2FDiag& gain_a,
+                         const aocommon::MC2x2FDiag& gain_b,
+                         BDABuffer::Row& row, unsigned int channel,
+                         bool update_weights, base::FlagCounter& flag_counter) {
+  CheckRow(row, channel);
+  const std::size_t offset = channel * row.n_correlations;
+  ApplyDiagToVisibility(gain_a, gain_b, row.data + offset, row.flags + offset,
+                        update_weights ? row.weights + offset : nullptr,
+                        row.baseline_nr, channel, update_weights, flag_counter);
 }
 
 void ApplyCal::ApplyScalar(const std::complex<float>& gain_a,
@@ -198,32 +265,22 @@ void ApplyCal::ApplyFull(const aocommon::MC2x2F& gain_a,
                          unsigned int baseline, unsigned int channel,
                          bool update_weights, base::FlagCounter& flag_counter) {
   CheckBuffer(buffer, baseline, channel);
+  ApplyFullToVisibility(
+      gain_a, gain_b, &buffer.GetData()(baseline, channel, 0),
+      &buffer.GetFlags()(baseline, channel, 0),
+      update_weights ? &buffer.GetWeights()(baseline, channel, 0) : nullptr,
+      baseline, channel, update_weights, flag_counter);
+}
 
-  // If parameter is NaN or inf, do not apply anything and flag the data
-  bool anyinfnan = false;
-  for (unsigned int corr = 0; corr < 4; ++corr) {
-    if (!(isfinite(gain_a[corr]) && isfinite(gain_b[corr]))) {
-      anyinfnan = true;
-      break;
-    }
-  }
-  if (anyinfnan) {
-    // Only update flag counter for first correlation
-    if (!buffer.GetFlags()(baseline, channel, 0)) {
-      flag_counter.incrChannel(channel);
-      flag_counter.incrBaseline(baseline);
-    }
-    xt::view(buffer.GetFlags(), baseline, channel, xt::all()).fill(true);
-    return;
-  }
-
-  aocommon::MC2x2F visibilities(&buffer.GetData()(baseline, channel, 0));
-  visibilities = gain_a * visibilities.MultiplyHerm(gain_b);
-  visibilities.AssignTo(&buffer.GetData()(baseline, channel, 0));
-
-  if (update_weights) {
-    ApplyWeights(gain_a, gain_b, &buffer.GetWeights()(baseline, channel, 0));
-  }
+void ApplyCal::ApplyFull(const aocommon::MC2x2F& gain_a,
+                         const aocommon::MC2x2F& gain_b, BDABuffer::Row& row,
+                         unsigned int channel, bool update_weights,
+                         base::FlagCounter& flag_counter) {
+  CheckRow(row, channel);
+  const std::size_t offset = channel * row.n_correlations;
+  ApplyFullToVisibility(gain_a, gain_b, row.data + offset, row.flags + offset,
+                        update_weights ? row.weights + offset : nullptr,
+                        row.baseline_nr, channel, update_weights, flag_counter);
 }
 
 void ApplyCal::ApplyWeights(const aocommon::MC2x2F& gain_a,
@@ -14,6 +14,7 @@
 #include <aocommon/matrix2x2.h>
 #include <aocommon/matrix2x2diag.h>
 
+#include <dp3/base/BDABuffer.h>
 #include <dp3/base/DPBuffer.h>
 #include "OneApplyCal.h"
 
@@ -33,8 +34,10 @@ class ApplyCal : public Step {
  public:
   /// Construct the object.
   /// Parameters are obtained from the parset using the given prefix.
+  /// @param input_type Input type, Regular (default) or Bda.
   ApplyCal(const common::ParameterSet&, const string& prefix,
-           bool substep = false, std::string predictDirection = "");
+           bool substep = false, std::string predictDirection = "",
+           MsType input_type = MsType::kRegular);
 
   ApplyCal() = default;
 
@@ -55,6 +58,21 @@ class ApplyCal : public Step {
   /// When processed, it invokes the process function of the next step.
   bool process(std::unique_ptr<base::DPBuffer> buffer) override;
 
+  /// Process the BDA data.
+  /// It keeps the data.
+  /// When processed, it invokes the process function of the next step.
+  bool process(std::unique_ptr<base::BDABuffer> buffer) override;
+
+  /// ApplyCal does not modify the data, so it can be part of a series of
+  /// fused steps, together with the OneApplyCal steps that follow it.
+  bool SupportsBaselineTiles() const override {
+    return input_type_ == MsType::kRegular;
+  }
+
+  bool accepts(MsType dt) const override { return dt == input_type_; }
+
+  MsType outputs() const override { return input_type_; }
+
   /// Finish the processing of this step and subsequent steps.
   void finish() override;
 
@@ -83,6 +101,13 @@ class ApplyCal : public Step {
                         unsigned int channel, bool update_weights,
                         base::FlagCounter& flag_counter);
 
+  /// Apply a diagonal Jones matrix to the 2x2 visibilities matrix of a
+  /// channel in a BDA row: A.V.B^H
+  static void ApplyDiag(const aocommon::MC2x2FDiag& gain_a,
+                        const aocommon::MC2x2FDiag& gain_b,
+                        base::BDABuffer::Row& row, unsigned int channel,
+                        bool update_weights, base::FlagCounter& flag_counter);
+
   /// Apply a diagonal Jones matrix to the 2x2 visibilities matrix: A.V.B^H,
   /// where the solution is equal for both polarizations
   static void ApplyScalar(const std::complex<float>& gain_a,
@@ -101,6 +126,13 @@ class ApplyCal : public Step {
                         unsigned int baseline, unsigned int channel,
                         bool update_weights, base::FlagCounter& flag_counter);
 
+  /// Apply a full Jones matrix to the 2x2 visibilities matrix of a channel
+  /// in a BDA row: A.V.B^H
+  static void ApplyFull(const aocommon::MC2x2F& gain_a,
+                        const aocommon::MC2x2F& gain_b,
+                        base::BDABuffer::Row& row, unsigned int channel,
+                        bool update_weights, base::FlagCounter& flag_counter);
+
   /// Do the same as the combination of BBS + python script
   /// covariance2weight.py (cookbook), except it stores weights per freq.
   /// The diagonal of covariance matrix is transferred to the weights.
@@ -114,6 +146,7 @@ class ApplyCal : public Step {
 
  private:
   bool is_sub_step_{false};
+  MsType input_type_{MsType::kRegular};
   std::vector<std::shared_ptr<OneApplyCal>> apply_cals_;
 };
 
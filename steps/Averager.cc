@@ -6,6 +6,9 @@
 
 #include "Averager.h"
 
+#include <algorithm>
+#include <array>
+#include <cassert>
 #include <iomanip>
 
 #include <boost/algorithm/string/trim.hpp>
@@ -19,6 +22,7 @@
 #include "../common/ParameterSet.h"
 #include "../common/StringTools.h"
 
+using dp3::base::BDABuffer;
 using dp3::base::DPBuffer;
 using dp3::base::DPInfo;
 
@@ -29,8 +33,10 @@ const common::Fields Averager::kRequiredFields =
     kDataField | kFlagsField | kWeightsField | kUvwField;
 const common::Fields Averager::kProvidedFields = kRequiredFields;
 
-Averager::Averager(const common::ParameterSet& parset, const string& prefix)
-    : itsName(prefix),
+Averager::Averager(const common::ParameterSet& parset, const string& prefix,
+                   MsType input_type)
+    : itsInputType(input_type),
+      itsName(prefix),
       itsMinNPoint(parset.getUint(prefix + "minpoints", 1)),
       itsMinPerc(parset.getFloat(prefix + "minperc", 0.) / 100.),
       itsNTimes(0),
@@ -55,7 +61,8 @@ Averager::Averager(const common::ParameterSet& parset, const string& prefix)
 
 Averager::Averager(const string& stepName, unsigned int nchanAvg,
                    unsigned int ntimeAvg)
-    : itsName(stepName),
+    : itsInputType(MsType::kRegular),
+      itsName(stepName),
       itsFreqResolution(0),
       itsTimeResolution(0),
       itsNChanAvg(nchanAvg == 0 ? 1 : nchanAvg),
@@ -68,7 +75,8 @@ Averager::Averager(const string& stepName, unsigned int nchanAvg,
 
 Averager::Averager(const string& stepName, double freq_resolution,
                    double time_resolution)
-    : itsName(stepName),
+    : itsInputType(MsType::kRegular),
+      itsName(stepName),
       itsFreqResolution(freq_resolution),
       itsTimeResolution(time_resolution),
       itsNChanAvg(0),
@@ -106,9 +114,89 @@ void Averager::updateInfo(const base::DPInfo& infoIn) {
 
   itsNoAvg = (itsNChanAvg == 1 && itsNTimeAvg == 1);
 
+  if (itsInputType == MsType::kBda) {
+    updateBdaInfo(infoIn);
+    return;
+  }
+
   // Adapt averaging to available nr of channels and times.
   itsNTimeAvg = std::min(itsNTimeAvg, infoIn.ntime());
   itsNChanAvg = info().update(itsNChanAvg, itsNTimeAvg);
+
+  switch (infoIn.ncorr()) {
+    case 1:
+      itsAverageBaselines = &Averager::averageBaselines<1>;
+      break;
+    case 2:
+      itsAverageBaselines = &Averager::averageBaselines<2>;
+      break;
+    case 4:
+      itsAverageBaselines = &Averager::averageBaselines<4>;
+      break;
+    default:
+      itsAverageBaselines = &Averager::averageBaselinesGeneric;
+  }
+}
+
+void Averager::updateBdaInfo(const DPInfo& infoIn) {
+  if (itsNTimeAvg != 1) {
+    throw std::invalid_argument(
+        "Averager " + itsName +
+        " only supports averaging in frequency for BDA data");
+  }
+
+  const size_t n_baselines = infoIn.nbaselines();
+  std::vector<std::vector<double>> freqs(n_baselines);
+  std::vector<std::vector<double>> widths(n_baselines);
+  std::vector<std::vector<double>> resolutions(n_baselines);
+  std::vector<std::vector<double>> effective_bw(n_baselines);
+  itsBdaChannelIndices.assign(n_baselines, {});
+  itsNoAvg = true;
+  for (size_t bl = 0; bl < n_baselines; ++bl) {
+    const std::vector<double>& freqs_in = infoIn.chanFreqs(bl);
+    const std::vector<double>& widths_in = infoIn.chanWidths(bl);
+    const std::vector<double>& resolutions_in = infoIn.resolutions(bl);
+    const std::vector<double>& effective_bw_in = infoIn.effectiveBW(bl);
+    const unsigned int n_chan_in = freqs_in.size();
+
+    // With a frequency resolution, baselines that were already averaged
+    // more get a smaller averaging factor.
+    unsigned int factor = itsNChanAvg;
+    if (itsFreqResolution > 0) {
+      factor = std::max(1, int(itsFreqResolution / widths_in[0] + 0.5));
+    }
+    factor = std::min(factor, n_chan_in);
+    const unsigned int n_chan_out = (n_chan_in + factor - 1) / factor;
+    if (n_chan_out != n_chan_in) itsNoAvg = false;
+
+    // Like BDAAverager, spread the input channels evenly over the output
+    // channels, such that the number of channels need not divide integrally.
+    std::vector<unsigned int>& indices = itsBdaChannelIndices[bl];
+    indices.reserve(n_chan_out + 1);
+    for (unsigned int ch = 0; ch <= n_chan_out; ++ch) {
+      indices.push_back((ch * n_chan_in) / n_chan_out);
+    }
+
+    for (unsigned int ch = 0; ch < n_chan_out; ++ch) {
+      const unsigned int begin = indices[ch];
+      const unsigned int end = indices[ch + 1];
+      freqs[bl].push_back(0.5 * (freqs_in[begin] + freqs_in[end - 1]));
+      double width = 0.0;
+      double resolution = 0.0;
+      double bandwidth = 0.0;
+      for (unsigned int ch_in = begin; ch_in < end; ++ch_in) {
+        width += widths_in[ch_in];
+        resolution += resolutions_in[ch_in];
+        bandwidth += effective_bw_in[ch_in];
+      }
+      widths[bl].push_back(width);
+      resolutions[bl].push_back(resolution);
+      effective_bw[bl].push_back(bandwidth);
+    }
+  }
+  info().setChannels(std::move(freqs), std::move(widths),
+                     std::move(resolutions), std::move(effective_bw),
+                     infoIn.refFreq(), infoIn.spectralWindow());
 }
 
 void Averager::show(std::ostream& os) const {
@@ -229,6 +317,92 @@ bool Averager::process(std::unique_ptr<base::DPBuffer> buffer) {
   return true;
 }
 
+bool Averager::process(std::unique_ptr<BDABuffer> buffer) {
+  if (itsNoAvg) {
+    getNextStep()->process(std::move(buffer));
+    return true;
+  }
+  itsTimer.start();
+
+  const std::vector<BDABuffer::Row>& rows_in = buffer->GetRows();
+  std::size_t pool_size = 0;
+  for (const BDABuffer::Row& row : rows_in) {
+    pool_size += (itsBdaChannelIndices[row.baseline_nr].size() - 1) *
+                 row.n_correlations;
+  }
+  BDABuffer::Fields fields;
+  fields.full_res_flags = false;
+  auto output = std::make_unique<BDABuffer>(pool_size, fields);
+  for (const BDABuffer::Row& row : rows_in) {
+    output->AddRow(row.time, row.interval, row.exposure, row.baseline_nr,
+                   itsBdaChannelIndices[row.baseline_nr].size() - 1,
+                   row.n_correlations, nullptr, nullptr, nullptr, nullptr,
+                   row.uvw);
+  }
+  if (!rows_in.empty()) output->SetBaseRowNr(rows_in.front().row_nr);
+
+  std::vector<BDABuffer::Row>& rows_out = output->GetRows();
+  aocommon::StaticFor<size_t> loop;
+  loop.Run(0, rows_in.size(), [&](size_t begin, size_t end) {
+    for (size_t row = begin; row < end; ++row) {
+      averageBdaRow(rows_in[row], rows_out[row]);
+    }
+  });
+
+  itsTimer.stop();
+  getNextStep()->process(std::move(output));
+  return true;
+}
+
+void Averager::averageBdaRow(const BDABuffer::Row& row_in,
+                             BDABuffer::Row& row_out) const {
+  const std::vector<unsigned int>& indices =
+      itsBdaChannelIndices[row_in.baseline_nr];
+  assert(row_in.n_channels == indices.back());
+  const size_t n_corr = row_in.n_correlations;
+
+  for (size_t chan_out = 0; chan_out < row_out.n_channels; ++chan_out) {
+    const unsigned int chan_in_begin = indices[chan_out];
+    const unsigned int chan_in_end = indices[chan_out + 1];
+    const unsigned int n_averaged_chan = chan_in_end - chan_in_begin;
+    for (size_t corr = 0; corr < n_corr; ++corr) {
+      std::complex<float> sum_data;
+      std::complex<float> sum_all_data;
+      float sum_weights = 0;
+      float sum_all_weights = 0;
+      unsigned int sum_n_points = 0;
+      for (unsigned int chan_in = chan_in_begin; chan_in < chan_in_end;
+           ++chan_in) {
+        const size_t index = chan_in * n_corr + corr;
+        const float weight = row_in.weights ? row_in.weights[index] : 1.0f;
+        const std::complex<float> weighted_data = row_in.data[index] * weight;
+        sum_all_data += weighted_data;
+        sum_all_weights += weight;
+        if (!row_in.flags || !row_in.flags[index]) {
+          sum_data += weighted_data;
+          sum_weights += weight;
+          ++sum_n_points;
+        }
+      }
+
+      const size_t index_out = chan_out * n_corr + corr;
+      // Flag the point if insufficient unflagged data.
+      if (sum_weights == 0 || sum_n_points < itsMinNPoint ||
+          sum_n_points < n_averaged_chan * itsMinPerc) {
+        row_out.data[index_out] =
+            (sum_all_weights == 0 ? std::complex<float>()
+                                  : sum_all_data / sum_all_weights);
+        row_out.flags[index_out] = true;
+        row_out.weights[index_out] = sum_all_weights;
+      } else {
+        row_out.data[index_out] = sum_data / sum_weights;
+        row_out.flags[index_out] = false;
+        row_out.weights[index_out] = sum_weights;
+      }
+    }
+  }
+}
+
 void Averager::finish() {
   // Average remaining entries.
   if (itsNTimes > 0) {
@@ -246,8 +420,8 @@ void Averager::average() {
   // Resizing the data and weights of itsBuf destroys the data. Since a
   // non-destructive resize is needed the values are moved here and restored
   // after the resize.
-  xt::xtensor<std::complex<float>, 3> data_in = itsBuf->TakeData();
-  xt::xtensor<float, 3> weights_in = itsBuf->TakeWeights();
+  const DPBuffer::DataType data_in = itsBuf->TakeData();
+  const DPBuffer::WeightsType weights_in = itsBuf->TakeWeights();
 
   const unsigned int n_bl = data_in.shape(0);
   const unsigned int n_chan_in = data_in.shape(1);
@@ -257,61 +431,136 @@ void Averager::average() {
   itsBuf->GetData().resize(out_shape);
   itsBuf->GetWeights().resize(out_shape);
   itsBuf->GetFlags().resize(out_shape);
-  base::DPBuffer::DataType& data_out = itsBuf->GetData();
-  base::DPBuffer::WeightsType& weights_out = itsBuf->GetWeights();
-  base::DPBuffer::FlagsType& flags_out = itsBuf->GetFlags();
-  assert(data_in.data() != data_out.data());
-  assert(weights_in.data() != weights_out.data());
+  assert(data_in.data() != itsBuf->GetData().data());
+  assert(weights_in.data() != itsBuf->GetWeights().data());
 
   aocommon::StaticFor<size_t> loop;
   loop.Run(0, n_bl, [&](size_t bl_begin, size_t bl_end) {
-    for (unsigned int bl = bl_begin; bl < bl_end; ++bl) {
-      for (unsigned int corr = 0; corr < n_corr; ++corr) {
-        for (unsigned int chan_out = 0; chan_out < n_chan_out; ++chan_out) {
-          const unsigned int chan_in_begin = chan_out * itsNChanAvg;
-          const unsigned int n_averaged_chan =
-              std::min(itsNChanAvg, n_chan_in - chan_in_begin);
-          const unsigned int chan_in_end = chan_in_begin + n_averaged_chan;
-          const unsigned int n_averaged_all = n_averaged_chan * itsNTimes;
-
-          std::complex<float> sum_data;
-          std::complex<float> sum_all_data;
-          float sum_weights = 0;
-          float sum_all_weights = 0;
-          unsigned int sum_n_points = 0;
-
-          for (unsigned int chan_in = chan_in_begin; chan_in < chan_in_end;
-               ++chan_in) {
-            // Note: weight is accounted for in process().
-            sum_data += data_in(bl, chan_in, corr);
-            sum_all_data += itsAvgAll(bl, chan_in, corr);
-            sum_weights += weights_in(bl, chan_in, corr);
-            sum_all_weights += itsWeightAll(bl, chan_in, corr);
-            sum_n_points += itsNPoints(bl, chan_in, corr);
-          }
-
-          // Flag the point if insufficient unflagged data.
-          if (sum_weights == 0 || sum_n_points < itsMinNPoint ||
-              sum_n_points < n_averaged_all * itsMinPerc) {
-            data_out(bl, chan_out, corr) =
-                (sum_all_weights == 0 ? std::complex<float>()
-                                      : sum_all_data / sum_all_weights);
-            flags_out(bl, chan_out, corr) = true;
-            weights_out(bl, chan_out, corr) = sum_all_weights;
-          } else {
-            data_out(bl, chan_out, corr) = sum_data / sum_weights;
-            flags_out(bl, chan_out, corr) = false;
-            weights_out(bl, chan_out, corr) = sum_weights;
-          }
-        }
-      }
-    }
+    (this->*itsAverageBaselines)(data_in, weights_in, bl_begin, bl_end);
   });
   // The result UVWs are the average of the input.
   // If ever needed, UVWCalculator can be used to calculate the UVWs.
   itsBuf->GetUvw() /= double(itsNTimes);
 }
 
+void Averager::averageBaselinesGeneric(const DPBuffer::DataType& data_in,
+                                       const DPBuffer::WeightsType& weights_in,
+                                       size_t bl_begin, size_t bl_end) {
+  const unsigned int n_chan_in = data_in.shape(1);
+  const unsigned int n_corr = data_in.shape(2);
+  base::DPBuffer::DataType& data_out = itsBuf->GetData();
+  base::DPBuffer::WeightsType& weights_out = itsBuf->GetWeights();
+  base::DPBuffer::FlagsType& flags_out = itsBuf->GetFlags();
+  const unsigned int n_chan_out = data_out.shape(1);
+
+  for (unsigned int bl = bl_begin; bl < bl_end; ++bl) {
+    for (unsigned int corr = 0; corr < n_corr; ++corr) {
+      for (unsigned int chan_out = 0; chan_out < n_chan_out; ++chan_out) {
+        const unsigned int chan_in_begin = chan_out * itsNChanAvg;
+        const unsigned int n_averaged_chan =
+            std::min(itsNChanAvg, n_chan_in - chan_in_begin);
+        const unsigned int chan_in_end = chan_in_begin + n_averaged_chan;
+        const unsigned int n_averaged_all = n_averaged_chan * itsNTimes;
+
+        std::complex<float> sum_data;
+        std::complex<float> sum_all_data;
+        float sum_weights = 0;
+        float sum_all_weights = 0;
+        unsigned int sum_n_points = 0;
+
+        for (unsigned int chan_in = chan_in_begin; chan_in < chan_in_end;
+             ++chan_in) {
+          // Note: weight is accounted for in process().
+          sum_data += data_in(bl, chan_in, corr);
+          sum_all_data += itsAvgAll(bl, chan_in, corr);
+          sum_weights += weights_in(bl, chan_in, corr);
+          sum_all_weights += itsWeightAll(bl, chan_in, corr);
+          sum_n_points += itsNPoints(bl, chan_in, corr);
+        }
+
+        // Flag the point if insufficient unflagged data.
+        if (sum_weights == 0 || sum_n_points < itsMinNPoint ||
+            sum_n_points < n_averaged_all * itsMinPerc) {
+          data_out(bl, chan_out, corr) =
+              (sum_all_weights == 0 ? std::complex<float>()
+                                    : sum_all_data / sum_all_weights);
+          flags_out(bl, chan_out, corr) = true;
+          weights_out(bl, chan_out, corr) = sum_all_weights;
+        } else {
+          data_out(bl, chan_out, corr) = sum_data / sum_weights;
+          flags_out(bl, chan_out, corr) = false;
+          weights_out(bl, chan_out, corr) = sum_weights;
+        }
+      }
+    }
+  }
+}
+
+template <size_t NCorr>
+void Averager::averageBaselines(const DPBuffer::DataType& data_in,
+                                const DPBuffer::WeightsType& weights_in,
+                                size_t bl_begin, size_t bl_end) {
+  assert(data_in.shape(2) == NCorr);
+  const unsigned int n_chan_in = data_in.shape(1);
+  const unsigned int n_chan_out = itsBuf->GetData().shape(1);
+
+  for (size_t bl = bl_begin; bl < bl_end; ++bl) {
+    const std::complex<float>* data = &data_in(bl, 0, 0);
+    const std::complex<float>* all_data = &itsAvgAll(bl, 0, 0);
+    const float* weights = &weights_in(bl, 0, 0);
+    const float* all_weights = &itsWeightAll(bl, 0, 0);
+    const int* n_points = &itsNPoints(bl, 0, 0);
+    std::complex<float>* data_out = &itsBuf->GetData()(bl, 0, 0);
+    float* weights_out = &itsBuf->GetWeights()(bl, 0, 0);
+    bool* flags_out = &itsBuf->GetFlags()(bl, 0, 0);
+
+    for (unsigned int chan_out = 0; chan_out < n_chan_out; ++chan_out) {
+      const unsigned int chan_in_begin = chan_out * itsNChanAvg;
+      const unsigned int n_averaged_chan =
+          std::min(itsNChanAvg, n_chan_in - chan_in_begin);
+      const unsigned int chan_in_end = chan_in_begin + n_averaged_chan;
+      const unsigned int n_averaged_all = n_averaged_chan * itsNTimes;
+
+      std::array<std::complex<float>, NCorr> sum_data{};
+      std::array<std::complex<float>, NCorr> sum_all_data{};
+      std::array<float, NCorr> sum_weights{};
+      std::array<float, NCorr> sum_all_weights{};
+      std::array<unsigned int, NCorr> sum_n_points{};
+
+      for (unsigned int chan_in = chan_in_begin; chan_in < chan_in_end;
+           ++chan_in) {
+        const size_t offset = chan_in * NCorr;
+        for (size_t corr = 0; corr < NCorr; ++corr) {
+          // Note: weight is accounted for in process().
+          sum_data[corr] += data[offset + corr];
+          sum_all_data[corr] += all_data[offset + corr];
+          sum_weights[corr] += weights[offset + corr];
+          sum_all_weights[corr] += all_weights[offset + corr];
+          sum_n_points[corr] += n_points[offset + corr];
+        }
+      }
+
+      const size_t offset = chan_out * NCorr;
+      for (size_t corr = 0; corr < NCorr; ++corr) {
+        // Flag the point if insufficient unflagged data.
+        if (sum_weights[corr] == 0 || sum_n_points[corr] < itsMinNPoint ||
+            sum_n_points[corr] < n_averaged_all * itsMinPerc) {
+          data_out[offset + corr] =
+              (sum_all_weights[corr] == 0
+                   ? std::complex<float>()
+                   : sum_all_data[corr] / sum_all_weights[corr]);
+          flags_out[offset + corr] = true;
+          weights_out[offset + corr] = sum_all_weights[corr];
+        } else {
+          data_out[offset + corr] = sum_data[corr] / sum_weights[corr];
+          flags_out[offset + corr] = false;
+          weights_out[offset + corr] = sum_weights[corr];
+        }
+      }
+    }
+  }
+}
+
 double Averager::getFreqHz(const string& freqstr) {
   casacore::String unit;
   // See if a unit is given at the end.
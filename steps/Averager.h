@@ -14,6 +14,7 @@
 #include <xtensor/xtensor.hpp>
 #include <aocommon/staticfor.h>
 
+#include <dp3/base/BDABuffer.h>
 #include <dp3/base/DPBuffer.h>
 #include <dp3/steps/Step.h>
 #include "../common/Timer.h"
@@ -35,6 +36,11 @@ namespace steps {
 /// <tt>sum(data*weight) / sum(weight)</tt> and the sum of the weights
 /// is the weight of the new data point. If all data point to use are
 /// flagged, the resulting data point and weight are set to zero and flagged.
+/// <br>
+/// For BDA input, the Averager re-averages the rows of each BDABuffer in
+/// frequency, so BDA data does not have to be expanded first. Averaging in
+/// time is not supported for BDA data, since BDA rows of different baselines
+/// have different intervals.
 
 class Averager : public Step {
  public:
@@ -45,7 +51,9 @@ class Averager : public Step {
 
   /// Construct the object.
   /// Parameters are obtained from the parset using the given prefix.
-  Averager(const common::ParameterSet&, const string& prefix);
+  /// @param input_type Input type, Regular (default) or Bda.
+  Averager(const common::ParameterSet&, const string& prefix,
+           MsType input_type = MsType::kRegular);
 
   /// Construct the object using the given parameters.
   Averager(const string& stepname, unsigned int nchanAvg,
@@ -64,6 +72,14 @@ class Averager : public Step {
   /// When processed, it invokes the process function of the next step.
   bool process(std::unique_ptr<base::DPBuffer> buffer) override;
 
+  /// Process the BDA data by averaging each row in frequency.
+  /// When processed, it invokes the process function of the next step.
+  bool process(std::unique_ptr<base::BDABuffer> buffer) override;
+
+  bool accepts(MsType dt) const override { return dt == itsInputType; }
+
+  MsType outputs() const override { return itsInputType; }
+
   /// Finish the processing of this step and subsequent steps.
   void finish() override;
 
@@ -84,6 +100,28 @@ class Averager : public Step {
   /// Update itsBuf so it contains averages.
   void average();
 
+  /// Average the baselines [bl_begin, bl_end) into itsBuf, for any number of
+  /// correlations.
+  void averageBaselinesGeneric(const base::DPBuffer::DataType& data_in,
+                               const base::DPBuffer::WeightsType& weights_in,
+                               size_t bl_begin, size_t bl_end);
+
+  /// Average the baselines [bl_begin, bl_end) into itsBuf, for data with
+  /// NCorr correlations. Accumulating all correlations of a channel at once
+  /// lets the compiler unroll the correlation loop.
+  template <size_t NCorr>
+  void averageBaselines(const base::DPBuffer::DataType& data_in,
+                        const base::DPBuffer::WeightsType& weights_in,
+                        size_t bl_begin, size_t bl_end);
+
+  /// Update the info for frequency averaging of BDA data.
+  void updateBdaInfo(const base::DPInfo& infoIn);
+
+  /// Average a single BDA row in frequency into a row of the output buffer.
+  void averageBdaRow(const base::BDABuffer::Row& row_in,
+                     base::BDABuffer::Row& row_out) const;
+
+  const MsType itsInputType;
   std::string itsName;
   std::unique_ptr<base::DPBuffer> itsBuf;
   xt::xtensor<int, 3> itsNPoints;
@@ -98,6 +136,14 @@ class Averager : public Step {
   unsigned int itsNTimes;
   double itsOriginalTimeInterval;
   bool itsNoAvg;  ///< No averaging (i.e. both 1)?
+  /// Averaging kernel for the number of correlations, set in updateInfo().
+  void (Averager::*itsAverageBaselines)(const base::DPBuffer::DataType&,
+                                        const base::DPBuffer::WeightsType&,
+                                        size_t, size_t) =
+      &Averager::averageBaselinesGeneric;
+  /// For BDA input: the first input channel of each output channel, per
+  /// baseline. Each inner vector ends with the number of input channels.
+  std::vector<std::vector<unsigned int>> itsBdaChannelIndices;
   common::NSTimer itsTimer;
 };
 
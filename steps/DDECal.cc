@@ -66,6 +66,8 @@ DDECal::DDECal(const common::ParameterSet& parset, const std::string& prefix)
       itsSolutionWriter(itsSettings.h5parm_name),
       itsRequestedSolInt(itsSettings.solution_interval),
       itsSolIntCount(1),
+      itsMemoryBudget("DDECal " + prefix),
+      itsTimeSlotMemory(0.0),
       itsFirstSolutionIndex(0),
       itsNChan(itsSettings.n_channels),
       itsUVWFlagStep(parset, prefix, Step::MsType::kRegular),
@@ -260,6 +262,12 @@ void DDECal::updateInfo(const DPInfo& infoIn) {
     }
   }
 
+  // The data, flags and weights, and the model data of all directions.
+  itsTimeSlotMemory = double(infoIn.nbaselines()) * infoIn.nchan() *
+                      infoIn.ncorr() *
+                      ((itsSteps.size() + 1) * sizeof(std::complex<float>) +
+                       sizeof(float) + sizeof(bool));
+
   if (!itsUVWFlagStep.isDegenerate()) {
     itsDataResultStep = std::make_shared<ResultStep>();
     itsUVWFlagStep.setNextStep(itsDataResultStep);
@@ -403,6 +411,8 @@ void DDECal::show(std::ostream& os) const {
      << itsSettings.propagate_solutions << '\n'
      << "       converged only: " << std::boolalpha
      << itsSettings.propagate_converged_only << '\n'
+     << "          extrapolate: " << std::boolalpha
+     << itsSettings.extrapolate_solutions << '\n'
      << "  detect stalling:     " << std::boolalpha
      << itsSolver->GetDetectStalling() << '\n'
      << "  step size:           " << itsSolver->GetStepSize() << '\n';
@@ -488,7 +498,19 @@ void DDECal::InitializeSolutions(size_t buffer_index) {
     std::cout << "Propagating solutions from previous step\n";
     std::cout << "Previous solution vector size: " << itsSols[solution_index - 1].size() << "\n";
     std::cout << "Current solution vector size before assignment: " << itsSols[solution_index].size() << "\n";
-    itsSols[solution_index] = itsSols[solution_index - 1];
+    const bool extrapolate =
+        itsSettings.extrapolate_solutions && solution_index > 1 &&
+        !(itsSettings.propagate_converged_only &&
+          itsNIter[solution_index - 2] > itsSolver->GetMaxIterations());
+    if (extrapolate) {
+      // Extrapolate the phases of the previous two solution intervals.
+      ddecal::ExtrapolateSolutions(itsSols[solution_index - 2],
+                                   itsSols[solution_index - 1],
+                                   itsSolver->NSolutionPolarizations(),
+                                   itsSols[solution_index]);
+    } else {
+      itsSols[solution_index] = itsSols[solution_index - 1];
+    }
     std::cout << "Current solution vector size after assignment: " << itsSols[solution_index].size() << "\n";
   } else {
     const size_t n_solutions = std::accumulate(
@@ -742,7 +764,15 @@ bool DDECal::process(std::unique_ptr<DPBuffer> bufin) {
   doPrepare();
   std::cout << "fra5\n";
 
-  if (itsInputBuffers.size() == itsSolIntCount &&
+  const size_t n_buffered = (itsInputBuffers.size() - 1) * itsRequestedSolInt +
+                            itsInputBuffers.back().size();
+  itsMemoryBudget.SetUsage(n_buffered * itsTimeSlotMemory);
+  // Solve the buffered solution intervals early if buffering another one
+  // would exceed the memory budget.
+  const bool budget_full = !itsMemoryBudget.Fits(
+      (n_buffered + itsRequestedSolInt) * itsTimeSlotMemory);
+
+  if ((itsInputBuffers.size() == itsSolIntCount || budget_full) &&
       itsInputBuffers.back().size() == itsRequestedSolInt) {
       
       // Check if the updated itsFirstSolutionIndex would exceed itsSols.size()
@@ -776,6 +806,7 @@ bool DDECal::process(std::unique_ptr<DPBuffer> bufin) {
     }
     std::cout << "fra8\n";
     itsInputBuffers.clear();
+    itsMemoryBudget.SetUsage(0.0);
     std::cout << "fra9\n";  
   }
 
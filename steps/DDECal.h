@@ -15,6 +15,7 @@
 
 #include <aocommon/recursivefor.h>
 
+#include "../common/Memory.h"
 #include "../common/ParameterSet.h"
 
 #include "../ddecal/Settings.h"
@@ -139,6 +140,9 @@ class DDECal : public Step {
   /// For each direction, a number of solutions per solution interval
   std::vector<size_t> itsSolutionsPerDirection;
   size_t itsSolIntCount;  ///< Number of solution intervals to buffer
+  common::MemoryBudget::Consumer itsMemoryBudget;
+  /// Memory used by the buffered data and model data of one time slot.
+  double itsTimeSlotMemory;
   /// Index of the first solution in the current solution interval set.
   size_t itsFirstSolutionIndex;
   size_t itsNChan;
@@ -104,6 +104,7 @@ Demixer::Demixer(const common::ParameterSet& parset, const std::string& prefix)
       itsUseLBFGS(parset.getBool(prefix + "uselbfgssolver", false)),
       itsLBFGShistory(parset.getUint(prefix + "lbfgs.historysize", 10)),
       itsLBFGSrobustdof(parset.getDouble(prefix + "lbfgs.robustdof", 2.0)),
+      itsUseDenseSolver(parset.getBool(prefix + "usedensesolver", false)),
       itsTimeIndex(0),
       itsNConverged(0) {
   if (itsSkyName.empty() || itsInstrumentName.empty())
@@ -142,6 +143,9 @@ Demixer::Demixer(const common::ParameterSet& parset, const std::string& prefix)
     throw std::runtime_error(
         "uselbfgssolver=true but libdirac is not available");
 #endif
+  if (itsUseLBFGS && itsUseDenseSolver)
+    throw std::runtime_error(
+        "uselbfgssolver and usedensesolver can not be used together");
   // Add a result step as last step in the filter.
   itsFilter = std::make_shared<Filter>(itsSelBL);
   itsFilterResult = std::make_shared<ResultStep>();
@@ -421,6 +425,9 @@ void Demixer::show(std::ostream& os) const {
   os << "  instrumentmodel:    " << itsInstrumentName << '\n';
   os << "  default gain:       " << itsDefaultGain << '\n';
   os << "  max iterations:     " << itsMaxIter << '\n';
+  if (itsUseDenseSolver) {
+    os << "  usedensesolver:     true" << '\n';
+  }
   itsSelBL.show(os);
   if (itsSelBL.hasSelection()) {
     os << "    demixing " << itsFilter->getInfo().nbaselines() << " out of "
@@ -852,31 +859,40 @@ void Demixer::deproject(aocommon::xt::UTensor<std::complex<double>, 5>& factors,
   factors = std::move(newFactors);
 }
 
-namespace {
-struct ThreadPrivateStorage {
-  std::vector<double> unknowns;
-  xt::xtensor<double, 2> uvw;
-  std::vector<casacore::Cube<std::complex<double>>> model;
-  casacore::Cube<std::complex<double>> model_subtr;
-  size_t count_converged;
-};
-
-void initThreadPrivateStorage(ThreadPrivateStorage& storage, size_t nDirection,
-                              size_t nStation, size_t nBaseline,
-                              size_t nChannel, size_t nChannelSubtr) {
-  storage.unknowns.resize(nDirection * nStation * 8);
-  storage.uvw.resize({nStation, 3});
-  storage.model.resize(nDirection);
-  for (unsigned int dir = 0; dir < nDirection; ++dir) {
-    storage.model[dir].resize(4, nChannel, nBaseline);
+void Demixer::initWorkspaces() {
+  const size_t nThread = aocommon::ThreadPool::GetInstance().NThreads();
+  const size_t nDr = itsNModel;
+  const size_t nSt = itsNStation;
+  const size_t nBl = itsBaselines.size();
+  const casacore::Vector<double> freqDemix(itsFreqDemix);
+  const casacore::Vector<double> freqSubtr(itsFreqSubtr);
+
+  itsWorkspaces.resize(nThread);
+  for (DemixWorkspace& workspace : itsWorkspaces) {
+    workspace.unknowns.resize(nDr * nSt * 8);
+    workspace.uvw.resize({nSt, 3});
+    workspace.model.resize(nDr);
+    workspace.simulators.clear();
+    for (size_t dr = 0; dr < nDr; ++dr) {
+      workspace.model[dr].resize(4, itsFreqDemix.size(), nBl);
+      // The simulators keep a reference to the uvw and model buffers.
+      workspace.simulators.push_back(std::make_unique<base::Simulator>(
+          itsPatchList[dr]->direction(), nSt, itsBaselines, freqDemix,
+          casacore::Vector<double>(), workspace.uvw, workspace.model[dr],
+          false, false));
+    }
+    workspace.model_subtr.resize(4, itsFreqSubtr.size(), nBl);
+    workspace.simulators_subtr.clear();
+    for (size_t dr = 0; dr < itsSubtrSources.size(); ++dr) {
+      workspace.simulators_subtr.push_back(std::make_unique<base::Simulator>(
+          itsPatchList[dr]->direction(), nSt, itsBaselines, freqSubtr,
+          casacore::Vector<double>(), workspace.uvw, workspace.model_subtr,
+          false, false));
+    }
   }
-  storage.model_subtr.resize(4, nChannelSubtr, nBaseline);
-  storage.count_converged = 0;
 }
-}  // end unnamed namespace
 
 void Demixer::demix() {
-  const size_t nThread = aocommon::ThreadPool::GetInstance().NThreads();
   const size_t nTime = itsAvgResults[0]->size();
   const size_t nTimeSubtr = itsAvgResultSubtr->size();
   const size_t multiplier = itsNTimeAvg / itsNTimeAvgSubtr;
@@ -888,11 +904,11 @@ void Demixer::demix() {
   const size_t nChSubtr = itsFreqSubtr.size();
   const size_t nCr = 4;
 
-  std::vector<ThreadPrivateStorage> threadStorage(nThread);
-  for (std::vector<ThreadPrivateStorage>::iterator it = threadStorage.begin(),
-                                                   end = threadStorage.end();
-       it != end; ++it) {
-    initThreadPrivateStorage(*it, nDr, nSt, nBl, nCh, nChSubtr);
+  if (itsWorkspaces.empty()) {
+    initWorkspaces();
+  }
+  for (DemixWorkspace& workspace : itsWorkspaces) {
+    workspace.count_converged = 0;
 
     // Copy the previous solution to the thread private vectors of unknowns.
     // When solution propagation is disabled, itsPrevSolution is never
@@ -900,14 +916,15 @@ void Demixer::demix() {
     // 0.0+0.0i for the off-diagonal terms. Thus, when solution propagation
     // is disabled this statement effectively re-initializes the thread
     // private vectors of unknowns.
-    copy(itsPrevSolution.begin(), itsPrevSolution.end(), it->unknowns.begin());
+    std::copy(itsPrevSolution.begin(), itsPrevSolution.end(),
+              workspace.unknowns.begin());
   }
 
   base::const_cursor<base::Baseline> cr_baseline(&(itsBaselines[0]));
 
   aocommon::DynamicFor<size_t> loop;
   loop.Run(0, nTime, [&](size_t ts, size_t thread) {
-    ThreadPrivateStorage& storage = threadStorage[thread];
+    DemixWorkspace& storage = itsWorkspaces[thread];
 
     // If solution propagation is disabled, re-initialize the thread-private
     // vector of unknowns.
@@ -927,12 +944,8 @@ void Demixer::demix() {
       base::nsplitUVW(itsUVWSplitIndex, itsBaselines,
                       itsAvgResults[dr]->get()[ts]->GetUvw(), storage.uvw);
 
-      base::Simulator simulator(
-          itsPatchList[dr]->direction(), nSt, itsBaselines,
-          casacore::Vector<double>(itsFreqDemix), casacore::Vector<double>(),
-          storage.uvw, storage.model[dr], false, false);
       for (size_t i = 0; i < itsPatchList[dr]->nComponents(); ++i) {
-        simulator.simulate(itsPatchList[dr]->component(i));
+        storage.simulators[dr]->simulate(itsPatchList[dr]->component(i));
       }
     }
 
@@ -977,19 +990,28 @@ void Demixer::demix() {
           storage.model[dr].data(), 3, stride_model);
     }
 
-    const bool converged =
+    bool converged;
+    if (itsUseDenseSolver) {
+      converged = estimateDense(nDr, nSt, nBl, nCh, cr_baseline, cr_data,
+                                cr_model, cr_flag, cr_weight, cr_mix,
+                                &(storage.unknowns[0]), storage.estimate,
+                                itsMaxIter);
+    } else {
+      converged =
 #ifdef HAVE_LIBDIRAC
-        (itsUseLBFGS
-             ? estimate(nDr, nSt, nBl, nCh, cr_baseline, cr_data, cr_model,
-                        cr_flag, cr_weight, cr_mix, &(storage.unknowns[0]),
-                        itsLBFGShistory, itsLBFGSrobustdof, itsMaxIter)
-             : estimate(nDr, nSt, nBl, nCh, cr_baseline, cr_data, cr_model,
-                        cr_flag, cr_weight, cr_mix, &(storage.unknowns[0]),
-                        itsMaxIter));
+          (itsUseLBFGS
+               ? estimate(nDr, nSt, nBl, nCh, cr_baseline, cr_data, cr_model,
+                          cr_flag, cr_weight, cr_mix, &(storage.unknowns[0]),
+                          itsLBFGShistory, itsLBFGSrobustdof, itsMaxIter)
+               : estimate(nDr, nSt, nBl, nCh, cr_baseline, cr_data, cr_model,
+                          cr_flag, cr_weight, cr_mix, &(storage.unknowns[0]),
+                          itsMaxIter));
 #else
-        estimate(nDr, nSt, nBl, nCh, cr_baseline, cr_data, cr_model, cr_flag,
-                 cr_weight, cr_mix, &(storage.unknowns[0]), itsMaxIter);
+          estimate(nDr, nSt, nBl, nCh, cr_baseline, cr_data, cr_model,
+                   cr_flag, cr_weight, cr_mix, &(storage.unknowns[0]),
+                   itsMaxIter);
 #endif /* HAVE_LIBDIRAC */
+    }
 
     if (converged) {
       ++storage.count_converged;
@@ -1045,13 +1067,9 @@ void Demixer::demix() {
           cr_model_subtr = base::cursor<std::complex<double>>(
               storage.model_subtr.data(), 3, stride_model_subtr);
 
-          base::Simulator simulator(itsPatchList[dr]->direction(), nSt,
-                                    itsBaselines,
-                                    casacore::Vector<double>(itsFreqSubtr),
-                                    casacore::Vector<double>(), storage.uvw,
-                                    storage.model_subtr, false, false);
           for (size_t i = 0; i < itsPatchList[dr]->nComponents(); ++i) {
-            simulator.simulate(itsPatchList[dr]->component(i));
+            storage.simulators_subtr[dr]->simulate(
+                itsPatchList[dr]->component(i));
           }
         }
 
@@ -1119,8 +1137,8 @@ void Demixer::demix() {
   }
 
   // Update convergence count.
-  for (size_t i = 0; i < nThread; ++i) {
-    itsNConverged += threadStorage[i].count_converged;
+  for (const DemixWorkspace& workspace : itsWorkspaces) {
+    itsNConverged += workspace.count_converged;
   }
 }
 
@@ -13,8 +13,10 @@
 #include "PhaseShift.h"
 
 #include "../base/Baseline.h"
+#include "../base/EstimateMixed.h"
 #include "../base/FlagCounter.h"
 #include "../base/Patch.h"
+#include "../base/Simulator.h"
 #include "../common/ParameterSet.h"
 #include "../common/Timer.h"
 
@@ -81,6 +83,24 @@ class Demixer : public Step {
   void deproject(aocommon::xt::UTensor<std::complex<double>, 5>& factors,
                  unsigned int resultIndex);
 
+  /// Buffers that a thread uses in demix(). They are kept between calls to
+  /// demix(), to avoid reallocating them for every time chunk.
+  struct DemixWorkspace {
+    std::vector<double> unknowns;
+    xt::xtensor<double, 2> uvw;
+    std::vector<casacore::Cube<std::complex<double>>> model;
+    casacore::Cube<std::complex<double>> model_subtr;
+    /// Simulators that write into model, for each direction.
+    std::vector<std::unique_ptr<base::Simulator>> simulators;
+    /// Simulators that write into model_subtr, for each subtract direction.
+    std::vector<std::unique_ptr<base::Simulator>> simulators_subtr;
+    base::DenseEstimateWorkspace estimate;
+    size_t count_converged;
+  };
+
+  /// Create the workspace for each thread.
+  void initWorkspaces();
+
   /// Solve gains and subtract sources.
   void demix();
 
@@ -151,6 +171,8 @@ class Demixer : public Step {
                              ///< as a multiple of the size of parameter vector.
   double itsLBFGSrobustdof;  ///< the degrees of freedom used in robust noise
                              ///< model.
+  bool itsUseDenseSolver;  ///< if true, use base::estimateDense() instead of
+                           ///< LSQfit.
 
   /// Accumulator used for computing the demixing weights at the demix
   /// resolution. The shape of this buffer is
@@ -186,6 +208,7 @@ class Demixer : public Step {
   std::vector<double> itsFreqSubtr;
   std::vector<double> itsUnknowns;
   std::vector<double> itsPrevSolution;
+  std::vector<DemixWorkspace> itsWorkspaces;
   unsigned int itsTimeIndex;
   unsigned int itsNConverged;
   base::FlagCounter itsFlagCounter;
@@ -145,6 +145,17 @@ bool Filter::process(std::unique_ptr<DPBuffer> buffer) {
     return true;
   }
 
+  if (itsSelBL.empty()) {
+    // Filtering on channel not baseline; select the channels in the existing
+    // buffer. UVW coordinates and row numbers are not dependent on channel.
+    // Like for a baseline selection, extra data buffers are not passed on.
+    buffer->RemoveData();
+    buffer->SelectChannels(itsStartChan, getInfo().nchan());
+    itsTimer.stop();
+    getNextStep()->process(std::move(buffer));
+    return true;
+  }
+
   // Create the new buffer and reshape it based on the sizes set in updateInfo
   std::unique_ptr<DPBuffer> filter_buffer =
       std::make_unique<DPBuffer>(buffer->GetTime(), buffer->GetExposure());
@@ -160,58 +171,40 @@ bool Filter::process(std::unique_ptr<DPBuffer> buffer) {
   const DPBuffer::FlagsType& flags = buffer->GetFlags();
   const DPBuffer::WeightsType& weights = buffer->GetWeights();
   const DPBuffer::UvwType& uvws = buffer->GetUvw();
-  if (itsSelBL.empty()) {
-    // filtering on channel not baseline; copy all data for given channels to
-    // make them contiguous.
-    // UVW is a straight copy with no filtering because it is not dependent on
-    // channel.
-    filter_buffer->GetData() = xt::view(
-        data, xt::all(),
-        xt::range(itsStartChan, itsStartChan + getInfo().nchan()), xt::all());
-    filter_buffer->GetFlags() = xt::view(
-        flags, xt::all(),
-        xt::range(itsStartChan, itsStartChan + getInfo().nchan()), xt::all());
-    filter_buffer->GetWeights() = xt::view(
-        weights, xt::all(),
-        xt::range(itsStartChan, itsStartChan + getInfo().nchan()), xt::all());
-    filter_buffer->GetUvw() = xt::view(uvws, xt::all(), xt::all());
-    filter_buffer->SetRowNumbers(buffer->GetRowNumbers());
-  } else {
-    // Filtering on baseline and/or channel; copy all data for selected
-    // baselines and channels to make them contiguous. UVW needs to be filtered
-    // as well as it is dependent on baselines.
-    casacore::Vector<common::rownr_t> rowNrs;
+  // Filtering on baseline and/or channel; copy all data for selected
+  // baselines and channels to make them contiguous. UVW needs to be filtered
+  // as well as it is dependent on baselines.
+  casacore::Vector<common::rownr_t> rowNrs;
+  if (!buffer->GetRowNumbers().empty()) {
+    rowNrs.resize(getInfo().nbaselines());
+  }
+  // Copy the data of the selected baselines and channels.
+  std::complex<float>* toData = filter_buffer->GetData().data();
+  bool* toFlag = filter_buffer->GetFlags().data();
+  float* toWeight = filter_buffer->GetWeights().data();
+  double* toUVW = filter_buffer->GetUvw().data();
+  std::size_t off = data.shape(2) * itsStartChan;  // offset of first channel
+  const std::complex<float>* frData = data.data() + off;
+  const bool* frFlag = flags.data() + off;
+  const float* frWeight = weights.data() + off;
+  const double* frUVW = uvws.data();
+  int ndfr = data.shape(2) * data.shape(1);
+  int ndto =
+      filter_buffer->GetData().shape(2) * filter_buffer->GetData().shape(1);
+  for (std::size_t i = 0; i < itsSelBL.size(); ++i) {
     if (!buffer->GetRowNumbers().empty()) {
-      rowNrs.resize(getInfo().nbaselines());
-    }
-    // Copy the data of the selected baselines and channels.
-    std::complex<float>* toData = filter_buffer->GetData().data();
-    bool* toFlag = filter_buffer->GetFlags().data();
-    float* toWeight = filter_buffer->GetWeights().data();
-    double* toUVW = filter_buffer->GetUvw().data();
-    std::size_t off = data.shape(2) * itsStartChan;  // offset of first channel
-    const std::complex<float>* frData = data.data() + off;
-    const bool* frFlag = flags.data() + off;
-    const float* frWeight = weights.data() + off;
-    const double* frUVW = uvws.data();
-    int ndfr = data.shape(2) * data.shape(1);
-    int ndto =
-        filter_buffer->GetData().shape(2) * filter_buffer->GetData().shape(1);
-    for (std::size_t i = 0; i < itsSelBL.size(); ++i) {
-      if (!buffer->GetRowNumbers().empty()) {
-        rowNrs[i] = buffer->GetRowNumbers()[itsSelBL[i]];
-      }
-      std::copy_n(frData + itsSelBL[i] * ndfr, ndto, toData);
-      toData += ndto;
-      std::copy_n(frFlag + itsSelBL[i] * ndfr, ndto, toFlag);
-      toFlag += ndto;
-      std::copy_n(frWeight + itsSelBL[i] * ndfr, ndto, toWeight);
-      toWeight += ndto;
-      std::copy_n(frUVW + itsSelBL[i] * 3, 3, toUVW);
-      toUVW += 3;
+      rowNrs[i] = buffer->GetRowNumbers()[itsSelBL[i]];
     }
-    filter_buffer->SetRowNumbers(rowNrs);
+    std::copy_n(frData + itsSelBL[i] * ndfr, ndto, toData);
+    toData += ndto;
+    std::copy_n(frFlag + itsSelBL[i] * ndfr, ndto, toFlag);
+    toFlag += ndto;
+    std::copy_n(frWeight + itsSelBL[i] * ndfr, ndto, toWeight);
+    toWeight += ndto;
+    std::copy_n(frUVW + itsSelBL[i] * 3, 3, toUVW);
+    toUVW += 3;
   }
+  filter_buffer->SetRowNumbers(rowNrs);
   itsTimer.stop();
   getNextStep()->process(std::move(filter_buffer));
   return true;
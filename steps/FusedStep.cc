@@ -0,0 +1,83 @@
+// FusedStep.cc: DP3 step class that runs steps on tiles of baselines
+// Copyright (C) 2023 ASTRON (Netherlands Institute for Radio Astronomy)
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "FusedStep.h"
+
+#include <dp3/base/DPBuffer.h>
+#include <dp3/base/DPInfo.h>
+
+#include "../base/FlagCounter.h"
+
+#include <aocommon/staticfor.h>
+
+#include <algorithm>
+#include <cassert>
+#include <complex>
+#include <iostream>
+
+using dp3::base::DPBuffer;
+using dp3::base::DPInfo;
+
+namespace dp3 {
+namespace steps {
+
+FusedStep::FusedStep(std::vector<std::shared_ptr<Step>> steps,
+                     std::size_t tile_size_in_bytes)
+    : steps_(std::move(steps)),
+      tile_size_in_bytes_(tile_size_in_bytes),
+      tile_size_(1) {
+  assert(!steps_.empty());
+}
+
+void FusedStep::updateInfo(const DPInfo& info_in) {
+  Step::updateInfo(info_in);
+  const std::size_t baseline_size =
+      info_in.nchan() * info_in.ncorr() *
+      (sizeof(std::complex<float>) + sizeof(float) + sizeof(bool));
+  tile_size_ = std::max<std::size_t>(
+      1, tile_size_in_bytes_ / std::max<std::size_t>(1, baseline_size));
+}
+
+bool FusedStep::process(std::unique_ptr<DPBuffer> buffer) {
+  timer_.start();
+  for (const std::shared_ptr<Step>& step : steps_) {
+    step->StartBaselineTiles(*buffer);
+  }
+  const std::size_t n_baselines = buffer->GetData().shape(0);
+  const std::size_t n_tiles = (n_baselines + tile_size_ - 1) / tile_size_;
+  aocommon::StaticFor<std::size_t> loop;
+  loop.Run(0, n_tiles, [&](std::size_t start_tile, std::size_t end_tile) {
+    for (std::size_t tile = start_tile; tile != end_tile; ++tile) {
+      const std::size_t first_baseline = tile * tile_size_;
+      const std::size_t end_baseline =
+          std::min(first_baseline + tile_size_, n_baselines);
+      for (const std::shared_ptr<Step>& step : steps_) {
+        step->ProcessBaselines(*buffer, first_baseline, end_baseline);
+      }
+    }
+  });
+  timer_.stop();
+  steps_.back()->getNextStep()->process(std::move(buffer));
+  return true;
+}
+
+void FusedStep::finish() {
+  // Let the fused and next steps finish.
+  getNextStep()->finish();
+}
+
+void FusedStep::show(std::ostream& os) const {
+  os << "FusedStep\n"
+     << "  steps:          " << steps_.size() << '\n'
+     << "  tile size:      " << tile_size_ << " baselines\n";
+}
+
+void FusedStep::showTimings(std::ostream& os, double duration) const {
+  os << "  ";
+  base::FlagCounter::showPerc1(os, timer_.getElapsed(), duration);
+  os << " FusedStep (" << steps_.size() << " steps)\n";
+}
+
+}  // namespace steps
+}  // namespace dp3
@@ -0,0 +1,78 @@
+// FusedStep.h: DP3 step class that runs steps on tiles of baselines
+// Copyright (C) 2023 ASTRON (Netherlands Institute for Radio Astronomy)
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/// @file
+/// @brief DP3 step class that runs steps on tiles of baselines
+
+#ifndef DP3_STEPS_FUSED_STEP_H
+#define DP3_STEPS_FUSED_STEP_H
+
+#include <dp3/steps/Step.h>
+
+#include "../common/Timer.h"
+
+#include <memory>
+#include <vector>
+
+namespace dp3 {
+namespace steps {
+
+/// @brief DP3 step class that runs steps on tiles of baselines
+
+/// A FusedStep is inserted in front of a series of consecutive steps that
+/// support baseline tiles (see Step::SupportsBaselineTiles()). It splits the
+/// baselines of a buffer in tiles that fit in the cache, and runs all steps
+/// of the series on a tile before moving to the next tile. Afterwards, it
+/// passes the buffer to the step after the series, such that the data is
+/// streamed from memory once instead of once per step.
+///
+/// The fused steps remain in the step chain for everything except processing
+/// regular data: updateInfo(), finish(), show() and the required and provided
+/// fields still pass through them. Their timings therefore do not include the
+/// processing of the tiles, which is timed by the FusedStep.
+class FusedStep : public Step {
+ public:
+  /// @param steps The series of steps, which should directly follow each
+  /// other in the step chain. The FusedStep should be linked to the first
+  /// one.
+  /// @param tile_size_in_bytes The size of the data, flags and weights of a
+  /// tile.
+  explicit FusedStep(std::vector<std::shared_ptr<Step>> steps,
+                     std::size_t tile_size_in_bytes = 256 * 1024);
+
+  /// The fused steps remain in the chain, so they determine the fields.
+  common::Fields getRequiredFields() const override { return {}; }
+
+  common::Fields getProvidedFields() const override { return {}; }
+
+  /// Process the data of all fused steps in tiles.
+  /// It invokes the process function of the step after the fused steps.
+  bool process(std::unique_ptr<base::DPBuffer> buffer) override;
+
+  /// Finish the processing of this step and subsequent steps.
+  void finish() override;
+
+  /// Update the general info.
+  void updateInfo(const base::DPInfo&) override;
+
+  /// Show the step parameters.
+  void show(std::ostream&) const override;
+
+  /// Show the timings.
+  void showTimings(std::ostream&, double duration) const override;
+
+  /// Number of baselines in a tile. Valid after updateInfo().
+  std::size_t TileSize() const { return tile_size_; }
+
+ private:
+  std::vector<std::shared_ptr<Step>> steps_;
+  std::size_t tile_size_in_bytes_;
+  std::size_t tile_size_;  ///< number of baselines per tile
+  common::NSTimer timer_;
+};
+
+}  // namespace steps
+}  // namespace dp3
+
+#endif
@@ -97,6 +97,8 @@ GainCal::GainCal(const common::ParameterSet& parset, const std::string& prefix)
       itsStepInParmUpdate(0),
       itsChunkStartTime(0),
       itsStepInSolInt(0),
+      itsNParallelSolInts(parset.getUint(prefix + "parallelsolints", 1)),
+      itsSolIntIndex(0),
       itsAllSolutions(),
       itsModelDataName(parset.getString(prefix + "reusemodel", "")) {
   std::stringstream ss;
@@ -160,8 +162,9 @@ GainCal::GainCal(const common::ParameterSet& parset, const std::string& prefix)
 
   itsNIter.resize(4, 0);
 
-  if (itsApplySolution) {
-    itsBuffers.resize(itsSolInt);
+  if (itsNParallelSolInts == 0) {
+    throw std::invalid_argument(prefix +
+                                "parallelsolints should be at least one");
   }
 
   std::string modestr = parset.getString(prefix + "caltype");
@@ -202,6 +205,9 @@ void GainCal::updateInfo(const DPInfo& infoIn) {
   if (itsTimeSlotsPerParmUpdate == 0) {
     itsTimeSlotsPerParmUpdate = info().ntime();
   }
+  if (itsApplySolution) {
+    itsBuffers.resize(itsSolInt * itsNParallelSolInts);
+  }
 
   if (itsNChan == 0) {
     itsNChan = info().nchan();
@@ -241,19 +247,21 @@ void GainCal::updateInfo(const DPInfo& infoIn) {
         itsNFreqCells);  // TODO: could be numthreads instead
 
     unsigned int nSt = info().antennaUsed().size();
-    for (unsigned int st = 0; st < nSt; ++st) {
+    for (unsigned int i = 0; i < itsNParallelSolInts * nSt; ++i) {
       itsPhaseFitters.push_back(std::make_unique<PhaseFitter>());
-      itsPhaseFitters[st]->Initialize(itsFreqData);
+      itsPhaseFitters[i]->Initialize(itsFreqData);
     }
   }
 
-  algorithms_.reserve(itsNFreqCells);
-  unsigned int chMax = itsNChan;
-  for (unsigned int freqCell = 0; freqCell < itsNFreqCells; ++freqCell) {
-    if ((freqCell + 1) * itsNChan >
-        info().nchan()) {  // Last cell can be smaller
-      chMax -= ((freqCell + 1) * itsNChan) % info().nchan();
-    }
+  // The algorithms hold the matrix workspaces for a solution interval. Each
+  // concurrently solved interval has its own set, which is reused for later
+  // intervals.
+  algorithms_.reserve(itsNParallelSolInts * itsNFreqCells);
+  for (unsigned int i = 0; i < itsNParallelSolInts * itsNFreqCells; ++i) {
+    const unsigned int freqCell = i % itsNFreqCells;
+    // Last cell can be smaller
+    const unsigned int chMax =
+        std::min(itsNChan, info().nchan() - freqCell * itsNChan);
 
     GainCalAlgorithm::Mode smode;
     switch (itsMode) {
@@ -289,6 +297,8 @@ void GainCal::updateInfo(const DPInfo& infoIn) {
   if (itsDebugLevel > 0) {
     if (aocommon::ThreadPool::GetInstance().NThreads() != 1)
       throw std::runtime_error("nthreads should be 1 in debug mode");
+    if (itsNParallelSolInts != 1)
+      throw std::runtime_error("parallelsolints should be 1 in debug mode");
     assert(itsTimeSlotsPerParmUpdate >= info().ntime());
     itsAllSolutions.resize(
         {info().ntime(), itsMaxIter, itsNFreqCells,
@@ -312,6 +322,9 @@ void GainCal::show(std::ostream& os) const {
   }
   os << '\n';
   os << "  solint:              " << itsSolInt << '\n';
+  if (itsNParallelSolInts > 1) {
+    os << "  parallel solints:    " << itsNParallelSolInts << '\n';
+  }
   os << "  nchan:               " << itsNChan << '\n';
   os << "  max iter:            " << itsMaxIter << '\n';
   os << "  tolerance:           " << itsTolerance << '\n';
@@ -438,9 +451,9 @@ bool GainCal::process(std::unique_ptr<DPBuffer> buffer) {
 
   if (itsStepInSolInt == 0) {
     // Start new solution interval
-    for (GainCalAlgorithm& algorithm : algorithms_) {
-      algorithm.clearStationFlagged();
-      algorithm.resetVis();
+    for (unsigned int freqCell = 0; freqCell < itsNFreqCells; ++freqCell) {
+      algorithm(itsSolIntIndex, freqCell).clearStationFlagged();
+      algorithm(itsSolIntIndex, freqCell).resetVis();
     }
   }
 
@@ -454,43 +467,60 @@ bool GainCal::process(std::unique_ptr<DPBuffer> buffer) {
   itsTimerFill.stop();
 
   if (itsApplySolution) {
-    itsBuffers[itsStepInSolInt] = std::move(buffer);
+    itsBuffers[itsSolIntIndex * itsSolInt + itsStepInSolInt] =
+        std::move(buffer);
+  } else {
+    getNextStep()->process(std::move(buffer));
   }
 
   ++itsStepInSolInt;
   if (itsStepInSolInt == itsSolInt) {
-    // Solve past solution interval
-    calibrate();
+    itsStepInSolInt = 0;
+    ++itsSolIntIndex;
+    if (itsSolIntIndex == itsNParallelSolInts) {
+      // Solve past solution intervals
+      solveIntervals(itsNParallelSolInts, itsSolInt);
+      itsSolIntIndex = 0;
+    }
+  }
+
+  itsTimer.stop();
+  return false;
+}
+
+void GainCal::solveIntervals(std::size_t n_intervals,
+                             std::size_t n_steps_in_last) {
+  calibrate(n_intervals);
+
+  const std::size_t first_solution = itsSols.size() - n_intervals;
+  for (std::size_t interval = 0; interval < n_intervals; ++interval) {
     itsStepInParmUpdate++;
 
     if (itsApplySolution) {
       const xt::xtensor<std::complex<float>, 3> invsol =
-          invertSol(itsSols.back());
-      for (std::size_t stepInSolInt = 0; stepInSolInt < itsSolInt;
+          invertSol(itsSols[first_solution + interval]);
+      const std::size_t n_steps =
+          (interval + 1 == n_intervals) ? n_steps_in_last : itsSolInt;
+      for (std::size_t stepInSolInt = 0; stepInSolInt < n_steps;
            stepInSolInt++) {
-        applySolution(*itsBuffers[stepInSolInt], invsol);
-        getNextStep()->process(std::move(itsBuffers[stepInSolInt]));
+        std::unique_ptr<DPBuffer>& buffer =
+            itsBuffers[interval * itsSolInt + stepInSolInt];
+        applySolution(*buffer, invsol);
+        getNextStep()->process(std::move(buffer));
       }
     }
-
-    itsStepInSolInt = 0;
   }
 
-  itsTimer.stop();
-
-  if (!itsUseH5Parm && (itsStepInParmUpdate == itsTimeSlotsPerParmUpdate)) {
+  if (!itsUseH5Parm && (itsStepInParmUpdate >= itsTimeSlotsPerParmUpdate)) {
+    // With concurrently solved intervals, the chunk may contain a few more
+    // intervals than requested.
     writeSolutionsParmDB(itsChunkStartTime);
     itsChunkStartTime +=
-        itsSolInt * itsTimeSlotsPerParmUpdate * info().timeInterval();
+        itsSolInt * itsStepInParmUpdate * info().timeInterval();
     itsSols.clear();
     itsTECSols.clear();
     itsStepInParmUpdate = 0;
   }
-
-  if (!itsApplySolution) {
-    getNextStep()->process(std::move(buffer));
-  }
-  return false;
 }
 
 xt::xtensor<std::complex<float>, 3> GainCal::invertSol(
@@ -556,12 +586,13 @@ void GainCal::fillMatrices(const DPBuffer::DataType& model,
   aocommon::DynamicFor<size_t> loop;
   loop.Run(0, n_channels, [&](size_t ch) {
     constexpr size_t kNumDimensions = 6;
-    dp3::base::GainCalAlgorithm& algorithm = algorithms_[ch / itsNChan];
+    dp3::base::GainCalAlgorithm& cell_algorithm =
+        algorithm(itsSolIntIndex, ch / itsNChan);
     aocommon::xt::Span<std::complex<double>, kNumDimensions> visibilities =
-        CreateSpanFromCasacore<6>(algorithm.getVis());
+        CreateSpanFromCasacore<6>(cell_algorithm.getVis());
     aocommon::xt::Span<std::complex<double>, kNumDimensions>
         model_visibilities =
-            CreateSpanFromCasacore<kNumDimensions>(algorithm.getMVis());
+            CreateSpanFromCasacore<kNumDimensions>(cell_algorithm.getMVis());
 
     for (size_t bl = 0; bl < n_baselines; ++bl) {
       if (!itsSelectedBL[bl]) {
@@ -572,8 +603,8 @@ void GainCal::fillMatrices(const DPBuffer::DataType& model,
       const int ant2 = getInfo().antennaMap()[getInfo().getAnt2()[bl]];
 
       const bool skip = (ant1 == ant2 ||
-                         algorithms_[ch / itsNChan].getStationFlagged()[ant1] ||
-                         algorithms_[ch / itsNChan].getStationFlagged()[ant2] ||
+                         cell_algorithm.getStationFlagged()[ant1] ||
+                         cell_algorithm.getStationFlagged()[ant2] ||
                          flags(bl, ch, 0));
 
       if (skip) {  // Only check flag of cr==0
@@ -581,7 +612,7 @@ void GainCal::fillMatrices(const DPBuffer::DataType& model,
       }
 
       if (itsMode == CalType::kTec || itsMode == CalType::kTecAndPhase) {
-        algorithms_[ch / itsNChan].incrementWeight(weights(bl, ch, 0));
+        cell_algorithm.incrementWeight(weights(bl, ch, 0));
       }
 
       for (size_t cr = 0; cr < n_correlations; ++cr) {
@@ -619,34 +650,39 @@ bool GainCal::diagonalMode(CalType caltype) {
           caltype == CalType::kDiagonalAmplitude);
 }
 
-void GainCal::calibrate() {
+void GainCal::calibrate(std::size_t n_intervals) {
   itsTimerSolve.start();
 
-  for (GainCalAlgorithm& algorithm : algorithms_) {
-    algorithm.init(!itsPropagateSolutions);
+  const std::size_t n_cells = n_intervals * itsNFreqCells;
+  for (std::size_t cell = 0; cell < n_cells; ++cell) {
+    algorithms_[cell].init(!itsPropagateSolutions);
   }
 
-  unsigned int iter = 0;
+  unsigned int nSt = info().antennaUsed().size();
 
-  xt::xtensor<double, 2> tecsol(
-      {info().antennaUsed().size(), itsMode == CalType::kTecAndPhase ? 2u : 1u},
-      0.0);
+  std::vector<xt::xtensor<double, 2>> tecsols(
+      n_intervals,
+      xt::xtensor<double, 2>(
+          {nSt, itsMode == CalType::kTecAndPhase ? 2u : 1u}, 0.0));
 
   std::vector<GainCalAlgorithm::Status> converged(
-      itsNFreqCells, GainCalAlgorithm::NOTCONVERGED);
+      n_cells, GainCalAlgorithm::NOTCONVERGED);
 
-  for (; iter < itsMaxIter; ++iter) {
-    bool allConverged = true;
+  // An interval is done when none of its frequency cells has steps worth
+  // continuing. The other intervals continue iterating.
+  std::vector<bool> interval_done(n_intervals, false);
+  std::vector<unsigned int> n_iterations(n_intervals, itsMaxIter);
+  std::size_t n_intervals_done = 0;
+
+  for (unsigned int iter = 0; iter < itsMaxIter; ++iter) {
     aocommon::RecursiveFor recursive_for;
-    recursive_for.Run(0, itsNFreqCells, [&](size_t freqCell) {
+    // Parallelizing over all frequency cells of all intervals keeps all
+    // threads busy when there are only a few frequency cells.
+    recursive_for.Run(0, n_cells, [&](size_t cell) {
       // Do another step when stalled and not all converged
-      if (converged[freqCell] != GainCalAlgorithm::CONVERGED) {
-        converged[freqCell] = algorithms_[freqCell].doStep(iter, recursive_for);
-        // Only continue if there are steps worth continuing
-        // (so not converged, failed or stalled)
-        if (converged[freqCell] == GainCalAlgorithm::NOTCONVERGED) {
-          allConverged = false;
-        }
+      if (!interval_done[cell / itsNFreqCells] &&
+          converged[cell] != GainCalAlgorithm::CONVERGED) {
+        converged[cell] = algorithms_[cell].doStep(iter, recursive_for);
       }
     });
 
@@ -663,100 +699,123 @@ void GainCal::calibrate() {
     if (itsMode == CalType::kTec || itsMode == CalType::kTecAndPhase) {
       itsTimerSolve.stop();
       itsTimerPhaseFit.start();
-      casacore::Matrix<std::complex<double>> sols_f(
-          itsNFreqCells, info().antennaUsed().size());
+      for (std::size_t interval = 0; interval < n_intervals; ++interval) {
+        if (interval_done[interval]) continue;
 
-      unsigned int nSt = info().antennaUsed().size();
+        xt::xtensor<double, 2>& tecsol = tecsols[interval];
+        casacore::Matrix<std::complex<double>> sols_f(itsNFreqCells, nSt);
 
-      // TODO: set phase reference to something smarter than station 0
-      for (unsigned int freqCell = 0; freqCell < itsNFreqCells; ++freqCell) {
-        casacore::Matrix<std::complex<double>> sol =
-            algorithms_[freqCell].getSolution(false);
-        if (algorithms_[freqCell].getStationFlagged()[0]) {
-          // If reference station flagged, flag whole channel
-          for (unsigned int st = 0; st < info().antennaUsed().size(); ++st) {
-            algorithms_[freqCell].getStationFlagged()[st] = true;
-          }
-        } else {
-          for (unsigned int st = 0; st < info().antennaUsed().size(); ++st) {
-            sols_f(freqCell, st) = sol(st, 0) / sol(0, 0);
-            assert(casacore::isFinite(sols_f(freqCell, st)));
-          }
-        }
-      }
-
-      // Fit the data for each station
-      recursive_for.Run(0, nSt, [&](size_t st, size_t) {
-        unsigned int numpoints = 0;
-        double* phases = itsPhaseFitters[st]->PhaseData();
-        double* weights = itsPhaseFitters[st]->WeightData();
+        // TODO: set phase reference to something smarter than station 0
         for (unsigned int freqCell = 0; freqCell < itsNFreqCells; ++freqCell) {
-          if (algorithms_[freqCell].getStationFlagged()[st % nSt] ||
-              converged[freqCell] == GainCalAlgorithm::FAILED) {
-            phases[freqCell] = 0;
-            weights[freqCell] = 0;
+          GainCalAlgorithm& cell_algorithm = algorithm(interval, freqCell);
+          casacore::Matrix<std::complex<double>> sol =
+              cell_algorithm.getSolution(false);
+          if (cell_algorithm.getStationFlagged()[0]) {
+            // If reference station flagged, flag whole channel
+            for (unsigned int st = 0; st < nSt; ++st) {
+              cell_algorithm.getStationFlagged()[st] = true;
+            }
           } else {
-            phases[freqCell] = arg(sols_f(freqCell, st));
-            if (!std::isfinite(phases[freqCell])) {
-              std::cout << "Yuk, phases[freqCell]=" << phases[freqCell]
-                        << ", sols_f(freqCell, st)=" << sols_f(freqCell, st)
-                        << '\n';
-              assert(std::isfinite(phases[freqCell]));
+            for (unsigned int st = 0; st < nSt; ++st) {
+              sols_f(freqCell, st) = sol(st, 0) / sol(0, 0);
+              assert(casacore::isFinite(sols_f(freqCell, st)));
             }
-            assert(algorithms_[freqCell].getWeight() > 0);
-            weights[freqCell] = algorithms_[freqCell].getWeight();
-            numpoints++;
           }
         }
 
-        for (unsigned int freqCell = 0; freqCell < itsNFreqCells; ++freqCell) {
-          assert(std::isfinite(phases[freqCell]));
-        }
-
-        if (numpoints > 1) {  // TODO: limit should be higher
-          if (itsMode == CalType::kTecAndPhase) {
-            itsPhaseFitters[st]->FitDataToTEC2Model(tecsol(st, 0),
-                                                    tecsol(st, 1));
-          } else {  // itsMode==kTec
-            itsPhaseFitters[st]->FitDataToTEC1Model(tecsol(st, 0));
+        // Fit the data for each station
+        recursive_for.Run(0, nSt, [&](size_t st, size_t) {
+          PhaseFitter& phase_fitter = *itsPhaseFitters[interval * nSt + st];
+          unsigned int numpoints = 0;
+          double* phases = phase_fitter.PhaseData();
+          double* weights = phase_fitter.WeightData();
+          for (unsigned int freqCell = 0; freqCell < itsNFreqCells;
+               ++freqCell) {
+            GainCalAlgorithm& cell_algorithm = algorithm(interval, freqCell);
+            if (cell_algorithm.getStationFlagged()[st % nSt] ||
+                converged[interval * itsNFreqCells + freqCell] ==
+                    GainCalAlgorithm::FAILED) {
+              phases[freqCell] = 0;
+              weights[freqCell] = 0;
+            } else {
+              phases[freqCell] = arg(sols_f(freqCell, st));
+              if (!std::isfinite(phases[freqCell])) {
+                std::cout << "Yuk, phases[freqCell]=" << phases[freqCell]
+                          << ", sols_f(freqCell, st)=" << sols_f(freqCell, st)
+                          << '\n';
+                assert(std::isfinite(phases[freqCell]));
+              }
+              assert(cell_algorithm.getWeight() > 0);
+              weights[freqCell] = cell_algorithm.getWeight();
+              numpoints++;
+            }
           }
-          // Update solution in GainCalAlgorithm object
+
           for (unsigned int freqCell = 0; freqCell < itsNFreqCells;
                ++freqCell) {
             assert(std::isfinite(phases[freqCell]));
-            algorithms_[freqCell].getSolution(false)(st, 0) =
-                std::polar(1., phases[freqCell]);
           }
-        } else {
-          tecsol(st, 0) = 0;  // std::numeric_limits<double>::quiet_NaN();
-          if (itsMode == CalType::kTecAndPhase) {
-            tecsol(st, 1) = 0;  // std::numeric_limits<double>::quiet_NaN();
+
+          if (numpoints > 1) {  // TODO: limit should be higher
+            if (itsMode == CalType::kTecAndPhase) {
+              phase_fitter.FitDataToTEC2Model(tecsol(st, 0), tecsol(st, 1));
+            } else {  // itsMode==kTec
+              phase_fitter.FitDataToTEC1Model(tecsol(st, 0));
+            }
+            // Update solution in GainCalAlgorithm object
+            for (unsigned int freqCell = 0; freqCell < itsNFreqCells;
+                 ++freqCell) {
+              assert(std::isfinite(phases[freqCell]));
+              algorithm(interval, freqCell).getSolution(false)(st, 0) =
+                  std::polar(1., phases[freqCell]);
+            }
+          } else {
+            tecsol(st, 0) = 0;  // std::numeric_limits<double>::quiet_NaN();
+            if (itsMode == CalType::kTecAndPhase) {
+              tecsol(st, 1) = 0;  // std::numeric_limits<double>::quiet_NaN();
+            }
           }
-        }
 
-        if (itsDebugLevel > 0) {
-          for (unsigned int freqCell = 0; freqCell < itsNFreqCells;
-               ++freqCell) {
-            Matrix<std::complex<double>> fullSolution =
-                algorithms_[freqCell].getSolution(false);
-            std::copy(
-                fullSolution.begin(), fullSolution.end(),
-                &itsAllSolutions(itsStepInParmUpdate, iter, freqCell, 1, 0, 0));
+          if (itsDebugLevel > 0) {
+            for (unsigned int freqCell = 0; freqCell < itsNFreqCells;
+                 ++freqCell) {
+              Matrix<std::complex<double>> fullSolution =
+                  algorithms_[freqCell].getSolution(false);
+              std::copy(fullSolution.begin(), fullSolution.end(),
+                        &itsAllSolutions(itsStepInParmUpdate, iter, freqCell,
+                                         1, 0, 0));
+            }
           }
-        }
-      });
+        });
+      }
       itsTimerPhaseFit.stop();
       itsTimerSolve.start();
     }
 
-    if (allConverged) {
+    for (std::size_t interval = 0; interval < n_intervals; ++interval) {
+      if (interval_done[interval]) continue;
+      // Only continue if there are steps worth continuing
+      // (so not converged, failed or stalled)
+      const auto first = converged.begin() + interval * itsNFreqCells;
+      if (std::none_of(first, first + itsNFreqCells,
+                       [](GainCalAlgorithm::Status status) {
+                         return status == GainCalAlgorithm::NOTCONVERGED;
+                       })) {
+        interval_done[interval] = true;
+        n_iterations[interval] = iter;
+        ++n_intervals_done;
+      }
+    }
+
+    if (n_intervals_done == n_intervals) {
       break;
     }
 
   }  // End niter
 
-  for (unsigned int freqCell = 0; freqCell < itsNFreqCells; ++freqCell) {
-    switch (converged[freqCell]) {
+  for (std::size_t cell = 0; cell < n_cells; ++cell) {
+    const unsigned int iter = n_iterations[cell / itsNFreqCells];
+    switch (converged[cell]) {
       case GainCalAlgorithm::CONVERGED: {
         itsConverged++;
         itsNIter[0] += iter;
@@ -784,35 +843,35 @@ void GainCal::calibrate() {
 
   // Calibrate terminated (either by maxiter or by converging)
 
-  unsigned int nSt = info().antennaUsed().size();
-
-  xt::xtensor<std::complex<float>, 3> sol(
-      {itsNFreqCells, nSt, algorithms_[0].numCorrelations()});
-
   unsigned int transpose[2][4] = {{0, 1, 0, 0}, {0, 2, 1, 3}};
 
-  for (unsigned int freqCell = 0; freqCell < itsNFreqCells; ++freqCell) {
-    casacore::Matrix<std::complex<double>> tmpsol =
-        algorithms_[freqCell].getSolution(true);
-
-    for (unsigned int st = 0; st < nSt; st++) {
-      for (unsigned int cr = 0; cr < algorithms_[0].nCr(); ++cr) {
-        unsigned int crt = transpose[algorithms_[0].numCorrelations() / 4]
-                                    [cr];  // Conjugate transpose ! (only for
-                                           // numCorrelations = 4)
-        sol(freqCell, st, crt) = conj(tmpsol(st, cr));  // Conjugate transpose
-        if (itsMode == CalType::kDiagonal ||
-            itsMode == CalType::kDiagonalPhase ||
-            itsMode == CalType::kDiagonalAmplitude) {
-          sol(freqCell, st, crt + 1) =
-              conj(tmpsol(st + nSt, cr));  // Conjugate transpose
+  for (std::size_t interval = 0; interval < n_intervals; ++interval) {
+    xt::xtensor<std::complex<float>, 3> sol(
+        {itsNFreqCells, nSt, algorithms_[0].numCorrelations()});
+
+    for (unsigned int freqCell = 0; freqCell < itsNFreqCells; ++freqCell) {
+      casacore::Matrix<std::complex<double>> tmpsol =
+          algorithm(interval, freqCell).getSolution(true);
+
+      for (unsigned int st = 0; st < nSt; st++) {
+        for (unsigned int cr = 0; cr < algorithms_[0].nCr(); ++cr) {
+          unsigned int crt = transpose[algorithms_[0].numCorrelations() / 4]
+                                      [cr];  // Conjugate transpose ! (only for
+                                             // numCorrelations = 4)
+          sol(freqCell, st, crt) = conj(tmpsol(st, cr));  // Conjugate transpose
+          if (itsMode == CalType::kDiagonal ||
+              itsMode == CalType::kDiagonalPhase ||
+              itsMode == CalType::kDiagonalAmplitude) {
+            sol(freqCell, st, crt + 1) =
+                conj(tmpsol(st + nSt, cr));  // Conjugate transpose
+          }
         }
       }
     }
-  }
-  itsSols.push_back(std::move(sol));
-  if (itsMode == CalType::kTec || itsMode == CalType::kTecAndPhase) {
-    itsTECSols.push_back(std::move(tecsol));
+    itsSols.push_back(std::move(sol));
+    if (itsMode == CalType::kTec || itsMode == CalType::kTecAndPhase) {
+      itsTECSols.push_back(std::move(tecsols[interval]));
+    }
   }
 
   itsTimerSolve.stop();
@@ -1296,17 +1355,9 @@ void GainCal::finish() {
 
   // Solve remaining time slots if any
   if (itsStepInSolInt != 0) {
-    calibrate();
-
-    if (itsApplySolution) {
-      const xt::xtensor<std::complex<float>, 3> invsol =
-          invertSol(itsSols.back());
-      for (std::size_t stepInSolInt = 0; stepInSolInt < itsStepInSolInt;
-           stepInSolInt++) {
-        applySolution(*itsBuffers[stepInSolInt], invsol);
-        getNextStep()->process(std::move(itsBuffers[stepInSolInt]));
-      }
-    }
+    solveIntervals(itsSolIntIndex + 1, itsStepInSolInt);
+  } else if (itsSolIntIndex != 0) {
+    solveIntervals(itsSolIntIndex, itsSolInt);
   }
 
   itsTimer.stop();
@@ -75,8 +75,20 @@ class GainCal final : public Step {
       std::vector<schaapcommon::h5parm::AxisInfo>& axes);
 
  private:
-  /// Perform gaincal (polarized or unpolarized)
-  void calibrate();
+  /// Perform gaincal (polarized or unpolarized) for the first n_intervals
+  /// buffered solution intervals. The intervals are solved concurrently.
+  void calibrate(std::size_t n_intervals);
+
+  /// Solve the first n_intervals buffered solution intervals, apply the
+  /// solutions if requested and pass the buffers on to the next step.
+  /// @param n_steps_in_last Number of time slots in the last interval.
+  void solveIntervals(std::size_t n_intervals, std::size_t n_steps_in_last);
+
+  /// Get the algorithm for a frequency cell of a buffered solution interval.
+  base::GainCalAlgorithm& algorithm(std::size_t interval,
+                                    std::size_t freq_cell) {
+    return algorithms_[interval * itsNFreqCells + freq_cell];
+  }
 
   /// Check for scalar mode
   static bool scalarMode(base::CalType caltype);
@@ -117,7 +129,7 @@ class GainCal final : public Step {
 
   std::string itsName;
   /// If itsApplySolution is true, stores the (input) buffers for the current
-  /// solution interval.
+  /// solution intervals.
   std::vector<std::unique_ptr<base::DPBuffer>> itsBuffers;
   bool itsUseModelColumn;
   std::string itsModelColumnName;
@@ -139,8 +151,10 @@ class GainCal final : public Step {
   std::vector<xt::xtensor<double, 2>> itsTECSols;
   std::vector<double> itsFreqData;  ///< Mean frequency for every freqcell
 
-  std::vector<std::unique_ptr<PhaseFitter>> itsPhaseFitters;  ///< Length nSt
+  /// Length nParallelSolInts x nSt
+  std::vector<std::unique_ptr<PhaseFitter>> itsPhaseFitters;
 
+  /// Length nParallelSolInts x nFreqCells
   std::vector<base::GainCalAlgorithm> algorithms_;
 
   UVWFlagger itsUVWFlagStep;
@@ -182,6 +196,10 @@ class GainCal final : public Step {
   unsigned int itsStepInParmUpdate;  ///< Timestep within parameter update
   double itsChunkStartTime;          ///< First time value of chunk to be stored
   unsigned int itsStepInSolInt;      ///< Timestep within solint
+  /// Number of solution intervals that are buffered and solved concurrently
+  unsigned int itsNParallelSolInts;
+  /// Index of the current solution interval within the buffered intervals
+  unsigned int itsSolIntIndex;
 
   /// Tensor that holds all solutions for all iterations.
   xt::xtensor<std::complex<double>, 6> itsAllSolutions;
@@ -63,6 +63,7 @@ IDGPredict::IDGPredict(
       pixel_size_y_(readers.first.front().PixelSizeY()),
       readers_(std::move(readers.first)),
       buffer_size_(0),
+      memory_budget_("IDGPredict " + prefix),
       ant1_(),
       ant2_(),
       timer_(),
@@ -203,7 +204,7 @@ void IDGPredict::updateInfo(const dp3::base::DPInfo& info) {
 
   // Determine available size for buffering
   if (buffer_size_ == 0) {
-    buffer_size_ = GetAllocatableBuffers(common::AvailableMemory());
+    buffer_size_ = GetAllocatableBuffers(memory_budget_.GetShare());
   }
 
   StartIDG();
@@ -26,6 +26,7 @@
 
 #include <dp3/steps/Step.h>
 
+#include "../common/Memory.h"
 #include "../common/ParameterSet.h"
 #include "../common/Timer.h"
 
@@ -158,6 +159,7 @@ class IDGPredict : public ModelDataStep {
   std::vector<aocommon::FitsReader> readers_;
 
   size_t buffer_size_;  ///< Number of DPBuffers to keep before calling flush
+  common::MemoryBudget::Consumer memory_budget_;
 
   std::vector<std::size_t> ant1_;  ///< Contains only the used antennas
   std::vector<std::size_t> ant2_;  ///< Contains only the used antennas
@@ -44,7 +44,7 @@ bool InputStep::HasBda(const casacore::MeasurementSet& ms) {
 }
 
 std::unique_ptr<InputStep> InputStep::CreateReader(
-    const common::ParameterSet& parset) {
+    const common::ParameterSet& parset, const std::string& selection_prefix) {
   // Get input and output MS name.
   // Those parameters were always called msin and msout.
   // However, SAS/MAC cannot handle a parameter and a group with the same
@@ -88,7 +88,8 @@ std::unique_ptr<InputStep> InputStep::CreateReader(
     if (HasBda(ms)) {
       return std::make_unique<MSBDAReader>(ms, parset, "msin.");
     } else {
-      return std::make_unique<MSReader>(ms, parset, "msin.");
+      return std::make_unique<MSReader>(ms, parset, "msin.", false,
+                                        selection_prefix);
     }
   } else {
     // MultiMSReader checks that all MS's have regular (non-BDA) data.
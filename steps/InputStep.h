@@ -66,7 +66,11 @@ class InputStep : public Step {
 
   /// Creates an MS reader.
   /// Based on the MS it will create either a BDAMSReader or a regular
-  static std::unique_ptr<InputStep> CreateReader(const common::ParameterSet&);
+  /// @param selection_prefix If not empty, a regular MSReader for a single MS
+  /// reads its baseline and channel selection using this prefix instead of
+  /// "msin.". Other readers ignore it.
+  static std::unique_ptr<InputStep> CreateReader(
+      const common::ParameterSet&, const std::string& selection_prefix = "");
 
  private:
   /// This variable is used by the inputStep's derived classes to determine
@@ -6,6 +6,7 @@
 
 #include "MSReader.h"
 
+#include <algorithm>
 #include <iostream>
 
 #include <xtensor/xadapt.hpp>
@@ -39,6 +40,7 @@
 
 #include "../base/BaselineSelection.h"
 #include "../base/MS.h"
+#include "../common/Numa.h"
 #include "../common/ParameterSet.h"
 
 using casacore::ArrayColumn;
@@ -77,9 +79,38 @@ using dp3::base::FlagCounter;
 namespace dp3 {
 namespace steps {
 
+namespace {
+
+/// Implements MSReader::flagInfNaN. NCorr is the number of correlations, or
+/// zero to use the number of correlations of the buffer.
+template <size_t NCorr>
+void FlagInfNaN(DPBuffer& buffer, FlagCounter& flagCounter) {
+  const size_t ncorr = NCorr == 0 ? buffer.GetData().shape(2) : NCorr;
+  const std::complex<float>* dataPtr = buffer.GetData().data();
+  bool* flagPtr = buffer.GetFlags().data();
+  for (size_t i = 0; i < buffer.GetData().size(); i += ncorr) {
+    for (size_t j = i; j < i + ncorr; ++j) {
+      bool flag = (!std::isfinite(dataPtr[j].real()) ||
+                   !std::isfinite(dataPtr[j].imag()));
+      if (flag) {
+        flagCounter.incrCorrelation(j - i);
+      }
+      if (flag || flagPtr[j]) {
+        // Flag all correlations if a single one is flagged.
+        for (size_t k = i; k < i + ncorr; ++k) {
+          flagPtr[k] = true;
+        }
+        break;
+      }
+    }
+  }
+}
+
+}  // namespace
+
 MSReader::MSReader(const casacore::MeasurementSet& ms,
                    const common::ParameterSet& parset, const string& prefix,
-                   bool missingData)
+                   bool missingData, const string& selectionPrefix)
     : itsMS(ms),
       itsSelMS(itsMS),
       itsDataColName(parset.getString(prefix + "datacolumn", "DATA")),
@@ -87,15 +118,21 @@ MSReader::MSReader(const casacore::MeasurementSet& ms,
       itsWeightColName(
           parset.getString(prefix + "weightcolumn", "WEIGHT_SPECTRUM")),
       itsModelColName(parset.getString(prefix + "modelcolumn", "MODEL_DATA")),
-      itsStartChanStr(parset.getString(prefix + "startchan", "0")),
-      itsNrChanStr(parset.getString(prefix + "nchan", "0")),
-      itsSelBL(parset.getString(prefix + "baseline", string())),
+      itsStartChanStr(parset.getString(
+          (selectionPrefix.empty() ? prefix : selectionPrefix) + "startchan",
+          "0")),
+      itsNrChanStr(parset.getString(
+          (selectionPrefix.empty() ? prefix : selectionPrefix) + "nchan", "0")),
+      itsSelBL(parset.getString(
+          (selectionPrefix.empty() ? prefix : selectionPrefix) + "baseline",
+          string())),
       itsNeedSort(parset.getBool(prefix + "sort", false)),
       itsAutoWeight(parset.getBool(prefix + "autoweight", false)),
       itsAutoWeightForce(parset.getBool(prefix + "forceautoweight", false)),
       itsUseFlags(parset.getBool(prefix + "useflag", true)),
       itsMissingData(missingData),
-      itsTimeTolerance(parset.getDouble(prefix + "timetolerance", 1e-2)) {
+      itsTimeTolerance(parset.getDouble(prefix + "timetolerance", 1e-2)),
+      itsTimeBlock(std::max(1u, parset.getUint(prefix + "timeblock", 1))) {
   common::NSTimer::StartStop sstime(itsTimer);
   // Get info from parset.
   string startTimeStr = parset.getString(prefix + "starttime", "");
@@ -148,6 +185,11 @@ MSReader::MSReader(const casacore::MeasurementSet& ms,
       itsSelMS = subset;
     }
   }
+  // Blocks of time slots are read from the full MS, which could contain rows
+  // with another shape if a band or baselines are selected.
+  if (itsSelMS.nrow() != itsMS.nrow()) {
+    itsTimeBlock = 1;
+  }
   // Prepare the MS access and get time info.
   double startTimeMS = 0., endTimeMS = 0.;
   prepare(startTimeMS, endTimeMS, itsTimeInterval);
@@ -256,10 +298,10 @@ std::string MSReader::msName() const { return itsMS.tableName(); }
 
 bool MSReader::process(std::unique_ptr<DPBuffer> buffer) {
   if (getFieldsToRead().Data()) {
-    buffer->GetData().resize({itsNrBl, itsNrChan, itsNrCorr});
+    common::NumaResize(buffer->GetData(), {itsNrBl, itsNrChan, itsNrCorr});
   }
   if (getFieldsToRead().Flags()) {
-    buffer->GetFlags().resize({itsNrBl, itsNrChan, itsNrCorr});
+    common::NumaResize(buffer->GetFlags(), {itsNrBl, itsNrChan, itsNrCorr});
   }
   {
     common::NSTimer::StartStop sstime(itsTimer);
@@ -326,7 +368,12 @@ bool MSReader::process(std::unique_ptr<DPBuffer> buffer) {
             ScalarColumn<double>(itsIter.table(), "EXPOSURE")(0));
         // Get data and flags from the MS.
         const casacore::IPosition casa_shape(3, itsNrCorr, itsNrChan, itsNrBl);
-        if (getFieldsToRead().Data()) {
+        const bool readFlags = getFieldsToRead().Flags() && itsUseFlags;
+        const bool fromBlock =
+            itsTimeBlock > 1 &&
+            readFromTimeBlock(buffer->GetRowNumbers(),
+                              getFieldsToRead().Data(), readFlags, *buffer);
+        if (getFieldsToRead().Data() && !fromBlock) {
           ArrayColumn<casacore::Complex> dataCol(itsIter.table(),
                                                  itsDataColName);
           casacore::Cube<casacore::Complex> casa_data(
@@ -339,14 +386,15 @@ bool MSReader::process(std::unique_ptr<DPBuffer> buffer) {
         }
         if (getFieldsToRead().Flags()) {
           if (itsUseFlags) {
-            ArrayColumn<bool> flagCol(itsIter.table(), itsFlagColName);
             casacore::Cube<bool> casa_flags(
                 casa_shape, buffer->GetFlags().data(), casacore::SHARE);
-
-            if (itsUseAllChan) {
-              flagCol.getColumn(casa_flags);
-            } else {
-              flagCol.getColumn(itsColSlicer, casa_flags);
+            if (!fromBlock) {
+              ArrayColumn<bool> flagCol(itsIter.table(), itsFlagColName);
+              if (itsUseAllChan) {
+                flagCol.getColumn(casa_flags);
+              } else {
+                flagCol.getColumn(itsColSlicer, casa_flags);
+              }
             }
             // Set flags if FLAG_ROW is set.
             ScalarColumn<bool> flagrowCol(itsIter.table(), "FLAG_ROW");
@@ -387,26 +435,73 @@ bool MSReader::process(std::unique_ptr<DPBuffer> buffer) {
   return true;
 }
 
-void MSReader::flagInfNaN(DPBuffer& buffer, FlagCounter& flagCounter) {
-  const int ncorr = buffer.GetData().shape(2);
-  const std::complex<float>* dataPtr = buffer.GetData().data();
-  bool* flagPtr = buffer.GetFlags().data();
-  for (unsigned int i = 0; i < buffer.GetData().size(); i += ncorr) {
-    for (unsigned int j = i; j < i + ncorr; ++j) {
-      bool flag = (!std::isfinite(dataPtr[j].real()) ||
-                   !std::isfinite(dataPtr[j].imag()));
-      if (flag) {
-        flagCounter.incrCorrelation(j - i);
+bool MSReader::readFromTimeBlock(
+    const casacore::Vector<common::rownr_t>& rowNrs, bool readData,
+    bool readFlags, DPBuffer& buf) {
+  const common::rownr_t nrow = rowNrs.size();
+  if (nrow != itsNrBl || nrow == 0) {
+    return false;
+  }
+  const common::rownr_t firstRow = rowNrs[0];
+  for (common::rownr_t i = 1; i < nrow; ++i) {
+    if (rowNrs[i] != firstRow + i) {
+      return false;
+    }
+  }
+  if (firstRow < itsBlockFirstRow ||
+      firstRow + nrow > itsBlockFirstRow + itsBlockNrRows) {
+    // Let blocks end at a multiple of the block size, so they align with
+    // storage manager tiles that contain a whole number of blocks.
+    const common::rownr_t blockSize = common::rownr_t(itsTimeBlock) * nrow;
+    itsBlockFirstRow = firstRow;
+    itsBlockNrRows = std::min(std::max(nrow, blockSize - firstRow % blockSize),
+                              itsMS.nrow() - firstRow);
+    const Slicer rowRange(IPosition(1, itsBlockFirstRow),
+                          IPosition(1, itsBlockNrRows));
+    if (readData) {
+      ArrayColumn<casacore::Complex> dataCol(itsMS, itsDataColName);
+      if (itsUseAllChan) {
+        dataCol.getColumnRange(rowRange, itsBlockData, true);
+      } else {
+        dataCol.getColumnRange(rowRange, itsColSlicer, itsBlockData, true);
       }
-      if (flag || flagPtr[j]) {
-        // Flag all correlations if a single one is flagged.
-        for (unsigned int k = i; k < i + ncorr; ++k) {
-          flagPtr[k] = true;
-        }
-        break;
+    }
+    if (readFlags) {
+      ArrayColumn<bool> flagCol(itsMS, itsFlagColName);
+      if (itsUseAllChan) {
+        flagCol.getColumnRange(rowRange, itsBlockFlags, true);
+      } else {
+        flagCol.getColumnRange(rowRange, itsColSlicer, itsBlockFlags, true);
       }
     }
   }
+  const std::size_t rowSize = std::size_t(itsNrCorr) * itsNrChan;
+  const std::size_t offset = (firstRow - itsBlockFirstRow) * rowSize;
+  if (readData) {
+    std::copy_n(itsBlockData.data() + offset, nrow * rowSize,
+                buf.GetData().data());
+  }
+  if (readFlags) {
+    std::copy_n(itsBlockFlags.data() + offset, nrow * rowSize,
+                buf.GetFlags().data());
+  }
+  return true;
+}
+
+void MSReader::flagInfNaN(DPBuffer& buffer, FlagCounter& flagCounter) {
+  switch (buffer.GetData().shape(2)) {
+    case 1:
+      FlagInfNaN<1>(buffer, flagCounter);
+      break;
+    case 2:
+      FlagInfNaN<2>(buffer, flagCounter);
+      break;
+    case 4:
+      FlagInfNaN<4>(buffer, flagCounter);
+      break;
+    default:
+      FlagInfNaN<0>(buffer, flagCounter);
+  }
 }
 
 void MSReader::finish() { getNextStep()->finish(); }
@@ -443,6 +538,9 @@ void MSReader::show(std::ostream& os) const {
     os << "  WEIGHT column:  " << itsWeightColName << '\n';
     os << "  FLAG column:    " << itsFlagColName << '\n';
     os << "  autoweight:     " << std::boolalpha << itsAutoWeight << '\n';
+    if (itsTimeBlock > 1) {
+      os << "  time block:     " << itsTimeBlock << " time slots\n";
+    }
   }
 }
 
@@ -746,7 +844,7 @@ void MSReader::getUVW(const RefRows& rowNrs, double time, DPBuffer& buf) {
 void MSReader::getWeights(const RefRows& rowNrs, DPBuffer& buf) {
   common::NSTimer::StartStop sstime(itsTimer);
   // Resize if needed (probably when called for first time).
-  buf.GetWeights().resize({itsNrBl, itsNrChan, itsNrCorr});
+  common::NumaResize(buf.GetWeights(), {itsNrBl, itsNrChan, itsNrCorr});
   DPBuffer::WeightsType& weights = buf.GetWeights();
   const casacore::IPosition shape(3, itsNrCorr, itsNrChan, itsNrBl);
   casacore::Cube<float> casa_weights(shape, weights.data(), casacore::SHARE);
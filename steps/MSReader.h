@@ -100,8 +100,12 @@ class MSReader : public InputStep {
   /// Construct the object for the given MS.
   /// Parameters are obtained from the parset using the given prefix.
   /// The missingData argument is for MultiMSReader.
+  /// If selectionPrefix is not empty, the baseline and channel selection
+  /// (baseline, startchan and nchan) are read using that prefix instead.
+  /// It is used to apply the selection of a leading Filter step while reading.
   MSReader(const casacore::MeasurementSet& ms, const common::ParameterSet&,
-           const std::string& prefix, bool missingData = false);
+           const std::string& prefix, bool missingData = false,
+           const std::string& selectionPrefix = "");
 
   /// Process the next data chunk.
   /// It returns false when at the end.
@@ -176,6 +180,13 @@ class MSReader : public InputStep {
   /// Calculate the weights from the autocorrelations.
   void autoWeight(base::DPBuffer& buf);
 
+  /// Copy the data and flags of a time slot from the block of time slots that
+  /// is read with a single column access. Reads the next block if needed.
+  /// It only handles time slots that are stored in consecutive rows.
+  /// @return False if the time slot cannot be taken from a block.
+  bool readFromTimeBlock(const casacore::Vector<common::rownr_t>& rowNrs,
+                         bool readData, bool readFlags, base::DPBuffer& buf);
+
   /// Read the weights at the given row numbers into the buffer.
   /// Note: the buffer must contain DATA if autoweighting is in effect.
   void getWeights(const casacore::RefRows& rowNrs, base::DPBuffer&);
@@ -206,6 +217,12 @@ class MSReader : public InputStep {
   ///
   /// Can be negative to insert flagged time slots before start.
   double itsTimeTolerance{1e-2};
+  /// Nr of time slots that are read with a single column access.
+  unsigned int itsTimeBlock{1};
+  common::rownr_t itsBlockFirstRow{0};  ///< first MS row in the block
+  common::rownr_t itsBlockNrRows{0};    ///< nr of MS rows in the block
+  casacore::Array<casacore::Complex> itsBlockData;
+  casacore::Array<bool> itsBlockFlags;
   double itsTimeInterval{0.0};
   double itsFirstTime{0.0};
   double itsLastTime{0.0};
@@ -43,6 +43,7 @@
 #include <casacore/casa/version.h>
 
 #include <aocommon/logger.h>
+#include <aocommon/staticfor.h>
 
 using casacore::Array;
 using casacore::ArrayColumn;
@@ -94,7 +95,8 @@ MSWriter::MSWriter(const std::string& out_name,
       chunk_duration_(parset.getDouble(prefix + "chunkduration", 0.0)),
       vds_dir_(parset.getString(prefix + "vdsdir", std::string())),
       cluster_desc_(parset.getString(prefix + "clusterdesc", std::string())),
-      st_man_keys_(parset, prefix) {
+      st_man_keys_(parset, prefix),
+      write_queue_(std::max(1u, parset.getUint(prefix + "queuesize", 3))) {
   if (data_col_name_ != "DATA")
     throw std::runtime_error(
         "Currently only the DATA column"
@@ -136,17 +138,55 @@ bool MSWriter::process(std::unique_ptr<DPBuffer> buffer) {
 
   common::NSTimer::StartStop sstime(timer_);
 
+  std::vector<char> row_flags;
+  PrepareData(*buffer, row_flags);
   if (use_write_thread_) {
-    CreateTask(std::move(buffer));
+    CreateTask(std::move(buffer), std::move(row_flags));
   } else {
-    ProcessBuffer(*buffer);
+    ProcessBuffer(*buffer, row_flags);
     getNextStep()->process(std::move(buffer));
   }
 
   return true;
 }
 
-void MSWriter::ProcessBuffer(DPBuffer& buffer) {
+void MSWriter::PrepareData(DPBuffer& buffer,
+                           std::vector<char>& row_flags) const {
+  if (buffer.GetData().size() == 0) {
+    return;
+  }
+  const std::size_t n_baselines = buffer.GetFlags().shape(0);
+  const std::size_t baseline_size =
+      buffer.GetFlags().shape(1) * buffer.GetFlags().shape(2);
+  const bool compress = st_man_keys_.stManName == "dysco";
+  row_flags.resize(n_baselines);
+
+  aocommon::StaticFor<std::size_t> loop;
+  loop.Run(0, n_baselines, [&](std::size_t start, std::size_t end) {
+    for (std::size_t bl = start; bl != end; ++bl) {
+      const bool* flags = buffer.GetFlags().data() + bl * baseline_size;
+      // A row is flagged if no flags in the row are False.
+      row_flags[bl] =
+          std::all_of(flags, flags + baseline_size, [](bool f) { return f; });
+      if (compress) {
+        std::complex<float>* data =
+            buffer.GetData().data() + bl * baseline_size;
+        float* weights = buffer.GetWeights().data() + bl * baseline_size;
+        for (std::size_t i = 0; i != baseline_size; ++i) {
+          if (flags[i]) {
+            data[i] =
+                std::complex<float>(std::numeric_limits<float>::quiet_NaN(),
+                                    std::numeric_limits<float>::quiet_NaN());
+            weights[i] = 0.0;
+          }
+        }
+      }
+    }
+  });
+}
+
+void MSWriter::ProcessBuffer(DPBuffer& buffer,
+                             const std::vector<char>& row_flags) {
   const common::NSTimer::StartStop timer(writer_timer_);
 
   // Form the vector of the output table containing new rows.
@@ -163,7 +203,7 @@ void MSWriter::ProcessBuffer(DPBuffer& buffer) {
   // Copy the input columns that do not change.
   WriteMeta(out, buffer);
   // Now write the data and flags.
-  WriteData(out, buffer);
+  WriteData(out, buffer, row_flags);
   // Flush if sufficient time slots are written.
   nr_done_++;
   if (nr_times_flush_ > 0 && nr_done_ % nr_times_flush_ == 0) {
@@ -192,6 +232,11 @@ void MSWriter::StartNewMs() {
   aocommon::Logger::Info << "Finished preparing output MS\n";
   info().clearMetaChanged();
 
+  antenna1_ = casacore::Vector<int>(getInfo().getAnt1());
+  antenna2_ = casacore::Vector<int>(getInfo().getAnt2());
+  unit_weights_.resize(IPosition(1, getInfo().ncorr()));
+  unit_weights_ = 1;
+
   use_write_thread_ = dynamic_cast<NullStep*>(getNextStep().get()) != nullptr;
   if (use_write_thread_) {
     is_write_thread_active_ = true;
@@ -676,28 +721,12 @@ void MSWriter::WriteHistory(Table& ms, const common::ParameterSet& parset) {
   cli.put(rownr, clivec);
 }
 
-void MSWriter::WriteData(Table& out, DPBuffer& buf) {
+void MSWriter::WriteData(Table& out, DPBuffer& buf,
+                         const std::vector<char>& row_flags) {
   if (buf.GetData().size() == 0) {
     return;
   }
 
-  // If compressing, flagged values need to be set to NaN, and flagged
-  // weights to zero, to decrease the dynamic range
-  if (st_man_keys_.stManName == "dysco") {
-    auto data_iterator = buf.GetData().begin();
-    auto weights_iterator = buf.GetWeights().begin();
-    for (bool flag : buf.GetFlags()) {
-      if (flag) {
-        *data_iterator =
-            casacore::Complex(std::numeric_limits<float>::quiet_NaN(),
-                              std::numeric_limits<float>::quiet_NaN());
-        *weights_iterator = 0.0;
-      }
-      ++data_iterator;
-      ++weights_iterator;
-    }
-  }
-
   // Write DATA, WEIGHT_SPECTRUM and FLAG
   ArrayColumn<casacore::Complex> data_col(out, data_col_name_);
   ArrayColumn<bool> flag_col(out, "FLAG");
@@ -712,11 +741,10 @@ void MSWriter::WriteData(Table& out, DPBuffer& buf) {
   weightCol.putColumn(weights);
   flag_col.putColumn(flags);
 
-  // A row is flagged if no flags in the row are False.
-  auto c = partialNFalse(flags, IPosition(2, 0, 1));
-  casacore::Vector<bool> row_flags(c == decltype(c)::value_type(0));
+  casacore::Vector<bool> flag_row(row_flags.size());
+  std::copy(row_flags.begin(), row_flags.end(), flag_row.begin());
   ScalarColumn<bool> flag_row_col(out, "FLAG_ROW");
-  flag_row_col.putColumn(row_flags);
+  flag_row_col.putColumn(flag_row);
 
   // Write UVW
   ArrayColumn<double> uvw_col(out, "UVW");
@@ -729,8 +757,8 @@ void MSWriter::WriteMeta(Table& out, const DPBuffer& buf) {
   // Fill ANTENNA1/2.
   ScalarColumn<int> ant1col(out, "ANTENNA1");
   ScalarColumn<int> ant2col(out, "ANTENNA2");
-  ant1col.putColumn(casacore::Vector<int>(getInfo().getAnt1()));
-  ant2col.putColumn(casacore::Vector<int>(getInfo().getAnt2()));
+  ant1col.putColumn(antenna1_);
+  ant2col.putColumn(antenna2_);
   // Fill all rows that do not change.
   FillSca<double>(buf.GetTime(), out, "TIME");
   FillSca<double>(buf.GetTime(), out, "TIME_CENTROID");
@@ -745,10 +773,8 @@ void MSWriter::WriteMeta(Table& out, const DPBuffer& buf) {
   FillSca<int>(0, out, "ARRAY_ID");
   FillSca<int>(0, out, "OBSERVATION_ID");
   FillSca<int>(0, out, "STATE_ID");
-  Array<float> arr(IPosition(1, getInfo().ncorr()));
-  arr = 1;
-  FillArr<float>(arr, out, "SIGMA");
-  FillArr<float>(arr, out, "WEIGHT");
+  FillArr<float>(unit_weights_, out, "SIGMA");
+  FillArr<float>(unit_weights_, out, "WEIGHT");
 }
 
 void MSWriter::CopyMeta(const Table& in, Table& out, bool copy_time_info) {
@@ -785,16 +811,17 @@ void MSWriter::StopWriteThread() {
 }
 
 void MSWriter::WriteQueueProcess() {
-  std::unique_ptr<base::DPBuffer> buffer;
-  while (write_queue_.read(buffer)) {
-    ProcessBuffer(*buffer);
+  WriteTask task;
+  while (write_queue_.read(task)) {
+    ProcessBuffer(*task.buffer, task.row_flags);
   }
 }
 
-void MSWriter::CreateTask(std::unique_ptr<base::DPBuffer> buffer) {
+void MSWriter::CreateTask(std::unique_ptr<base::DPBuffer> buffer,
+                          std::vector<char> row_flags) {
   const common::NSTimer::StartStop timer(create_task_timer_);
 
-  write_queue_.write(std::move(buffer));
+  write_queue_.write(WriteTask{std::move(buffer), std::move(row_flags)});
 }
 
 }  // namespace steps
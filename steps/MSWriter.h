@@ -9,6 +9,7 @@
 
 #include <memory>
 #include <thread>
+#include <vector>
 
 #include <aocommon/lane.h>
 
@@ -116,15 +117,25 @@ class MSWriter : public OutputStep {
   /// Update the FIELD table with the new phase center.
   void UpdatePhaseCentre(const string& out_name);
 
+  /// Prepare the data in @ref buffer for writing. This is done in parallel
+  /// over the baselines, before the buffer is handed to the write thread.
+  ///
+  /// When compressing, flagged values are set to NaN and flagged weights to
+  /// zero, to decrease the dynamic range.
+  /// @param row_flags Is set to the FLAG_ROW value of each baseline.
+  void PrepareData(base::DPBuffer& buffer, std::vector<char>& row_flags) const;
+
   /// Process the data in @ref buffer.
   ///
   /// This function does not access @ref internal_buffer_.
-  void ProcessBuffer(base::DPBuffer& buffer);
+  void ProcessBuffer(base::DPBuffer& buffer,
+                     const std::vector<char>& row_flags);
 
   /// Write the data, flags, etc.
   ///
   /// This function does not access @ref internal_buffer_.
-  void WriteData(casacore::Table& out, base::DPBuffer& buf);
+  void WriteData(casacore::Table& out, base::DPBuffer& buf,
+                 const std::vector<char>& row_flags);
 
   /// Write all meta data columns for a time slot (ANTENNA1, etc.)
   ///
@@ -199,6 +210,12 @@ class MSWriter : public OutputStep {
   std::string cluster_desc_;  ///< name of clusterdesc file
   base::StManParsetKeys st_man_keys_;
 
+  /// Meta data that is the same for every time slot of an MS. It is filled
+  /// when starting a new MS.
+  casacore::Vector<int> antenna1_;
+  casacore::Vector<int> antenna2_;
+  casacore::Array<float> unit_weights_;  ///< Used for SIGMA and WEIGHT.
+
   /// The total time spent in the writer.
   common::NSTimer timer_;
 
@@ -215,6 +232,12 @@ class MSWriter : public OutputStep {
   /// time the main thread spends in that operation.
   common::NSTimer create_task_timer_;
 
+  /// A time slot that is ready for writing.
+  struct WriteTask {
+    std::unique_ptr<base::DPBuffer> buffer;
+    std::vector<char> row_flags;  ///< See PrepareData().
+  };
+
   /// The size of the write buffer.
   ///
   /// On machines with "fast" I/O the writing is usually done when the next
@@ -226,11 +249,13 @@ class MSWriter : public OutputStep {
   /// On the other hand the buffer requires additional memory, so making the
   /// buffer large takes more memory while the "slow" I/O will just delay the
   /// final part of the processing. Based on experiments locally and on DAS6 the
-  /// selected size seems a nice trade-off.
-  aocommon::Lane<std::unique_ptr<base::DPBuffer>> write_queue_{3};
+  /// default size of 3 seems a nice trade-off. It can be changed with the
+  /// queuesize parset key.
+  aocommon::Lane<WriteTask> write_queue_;
 
   /// Creates task for the \ref write_queue_.
-  void CreateTask(std::unique_ptr<base::DPBuffer> buffer);
+  void CreateTask(std::unique_ptr<base::DPBuffer> buffer,
+                  std::vector<char> row_flags);
 
   /// The thread used to process \ref write_queue_.
   ///
@@ -51,6 +51,7 @@ MadFlagger::MadFlagger(const common::ParameterSet& parset,
       itsNTimes(0),
       itsNTimesDone(0),
       itsFlagCounter(parset, prefix + "count."),
+      itsMemoryBudget("MADFlagger " + prefix),
       itsMoveTime(0),
       itsMedianTime(0) {
   itsFlagCorr = parset.getUintVector(prefix + "correlations",
@@ -126,6 +127,11 @@ void MadFlagger::updateInfo(const DPInfo& infoIn) {
     itsAmplitudes[i].resize(
         {infoIn.nbaselines(), infoIn.nchan(), infoIn.ncorr()});
   }
+  // The time window of data, flags and weights, and its amplitudes.
+  itsMemoryBudget.SetUsage(double(itsTimeWindow) * infoIn.nbaselines() *
+                           infoIn.nchan() * infoIn.ncorr() *
+                           (sizeof(std::complex<float>) + 2 * sizeof(float) +
+                            sizeof(bool)));
   // Set or check the correlations to flag on.
   std::vector<unsigned int> flagCorr;
   unsigned int ncorr = infoIn.ncorr();
@@ -13,6 +13,7 @@
 
 #include <dp3/base/DPBuffer.h>
 #include "../base/FlagCounter.h"
+#include "../common/Memory.h"
 
 namespace dp3 {
 namespace common {
@@ -138,6 +139,7 @@ class MadFlagger : public Step {
   std::vector<std::unique_ptr<base::DPBuffer>> itsBuffers;
   std::vector<xt::xtensor<float, 3>> itsAmplitudes;  ///< amplitudes of the data
   base::FlagCounter itsFlagCounter;
+  common::MemoryBudget::Consumer itsMemoryBudget;
   common::NSTimer itsTimer;
   common::NSTimer itsComputeTimer;  ///< move/median timer
   double itsMoveTime;               ///< data move timer (sum all threads)
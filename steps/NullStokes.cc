@@ -38,14 +38,25 @@ void NullStokes::showTimings(std::ostream& os, double duration) const {
 
 bool NullStokes::process(std::unique_ptr<DPBuffer> buffer) {
   timer_.start();
-  std::complex<float>* visibilities = buffer->GetData().data();
+  ProcessBaselines(*buffer, 0, buffer->GetData().shape(0));
+  timer_.stop();
+  getNextStep()->process(std::move(buffer));
+  return true;
+}
+
+void NullStokes::ProcessBaselines(DPBuffer& buffer, std::size_t first_baseline,
+                                  std::size_t end_baseline) {
+  const std::size_t baseline_size =
+      buffer.GetData().shape(1) * buffer.GetData().shape(2);
+  std::complex<float>* visibilities = buffer.GetData().data();
   // The Stokes parameters are defined in terms of correlation of the electric
   // field. The visibilities corresponding to these correlations are denoted by
   // xx, xy, yx, yy. For example, Q = xx - yy, U = xy + yx. Here, the
   // visibilities are modified such that Q and/or U is zero, but I and V
   // unchanged. See e.g. eq. (4.28) and §4.5–4.7.2 of
   // https://link.springer.com/book/10.1007/978-3-319-44431-4
-  for (std::size_t i = 0; i < buffer->GetData().size(); i += 4) {
+  for (std::size_t i = first_baseline * baseline_size;
+       i < end_baseline * baseline_size; i += 4) {
     std::complex<float>& xx = visibilities[i];
     std::complex<float>& xy = visibilities[i + 1];
     std::complex<float>& yx = visibilities[i + 2];
@@ -60,9 +71,6 @@ bool NullStokes::process(std::unique_ptr<DPBuffer> buffer) {
       yx = -xy;
     }
   }
-  timer_.stop();
-  getNextStep()->process(std::move(buffer));
-  return true;
 }
 
 void NullStokes::updateInfo(const base::DPInfo& info_in) {
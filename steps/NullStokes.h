@@ -37,6 +37,11 @@ class NullStokes : public Step {
   /// When processed, it invokes the process function of the next step.
   bool process(std::unique_ptr<base::DPBuffer> buffer) override;
 
+  bool SupportsBaselineTiles() const override { return true; }
+
+  void ProcessBaselines(base::DPBuffer& buffer, std::size_t first_baseline,
+                        std::size_t end_baseline) override;
+
   /// Finish the processing of this step and subsequent steps
   void finish() override;
 
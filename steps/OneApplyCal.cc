@@ -25,13 +25,57 @@
 #include <iostream>
 #include <limits>
 #include <algorithm>
+#include <cassert>
+#include <cmath>
 #include <iomanip>
+#include <map>
+#include <tuple>
 
 #include <boost/algorithm/string/case_conv.hpp>
 
+using dp3::base::BDABuffer;
 using dp3::base::DPBuffer;
 using dp3::base::DPInfo;
 
+namespace {
+
+/// Identifies the gridded parameters of a solution table. Gridded parameters
+/// with equal keys are identical, and can be shared between steps.
+struct ParmsCacheKey {
+  std::string file_name;
+  std::string solset_name;
+  std::string correction;
+  std::vector<std::string> soltab_names;
+  GainType gain_type;
+  hsize_t direction;
+  JonesParameters::InterpolationType interpolation_type;
+  JonesParameters::MissingAntennaBehavior missing_antenna_behavior;
+  bool invert;
+  double sigma_mmse;
+  std::vector<std::string> antenna_names;
+  std::vector<double> freqs;
+  std::vector<double> times;
+
+  bool operator<(const ParmsCacheKey& other) const {
+    return std::tie(file_name, solset_name, correction, soltab_names,
+                    gain_type, direction, interpolation_type,
+                    missing_antenna_behavior, invert, sigma_mmse,
+                    antenna_names, freqs, times) <
+           std::tie(other.file_name, other.solset_name, other.correction,
+                    other.soltab_names, other.gain_type, other.direction,
+                    other.interpolation_type, other.missing_antenna_behavior,
+                    other.invert, other.sigma_mmse, other.antenna_names,
+                    other.freqs, other.times);
+  }
+};
+
+/// The cache only holds weak pointers: gridded parameters are shared while
+/// at least one step uses them, and are released afterwards.
+std::mutex parms_cache_mutex;
+std::map<ParmsCacheKey, std::weak_ptr<JonesParameters>> parms_cache;
+
+}  // namespace
+
 namespace dp3 {
 namespace steps {
 // Initialize private static
@@ -40,8 +84,9 @@ std::mutex OneApplyCal::theirHDF5Mutex;
 OneApplyCal::OneApplyCal(const common::ParameterSet& parset,
                          const std::string& prefix,
                          const std::string& defaultPrefix, bool substep,
-                         std::string predictDirection)
-    : itsName(prefix),
+                         std::string predictDirection, MsType input_type)
+    : itsInputType(input_type),
+      itsName(prefix),
       itsParmDBName(parset.isDefined(prefix + "parmdb")
                         ? parset.getString(prefix + "parmdb")
                         : parset.getString(defaultPrefix + "parmdb", "")),
@@ -62,7 +107,10 @@ OneApplyCal::OneApplyCal(const common::ParameterSet& parset,
       itsTimeStep(0),
       itsNCorr(0),
       itsLastTime(-1),
-      itsUseAP(false) {
+      itsUseAP(false),
+      itsBdaFirstTime(0.0),
+      itsBdaNTimes(0),
+      itsPrefetchTime(0.0) {
   if (substep) {
     itsInvert = false;
   } else {
@@ -75,6 +123,9 @@ OneApplyCal::OneApplyCal(const common::ParameterSet& parset,
       parset.isDefined(prefix + "timeslotsperparmupdate")
           ? parset.getInt(prefix + "timeslotsperparmupdate")
           : parset.getInt(defaultPrefix + "timeslotsperparmupdate", 200);
+  itsPrefetch = parset.isDefined(prefix + "prefetch")
+                    ? parset.getBool(prefix + "prefetch")
+                    : parset.getBool(defaultPrefix + "prefetch", false);
   if (itsUseH5Parm) {
     const std::string interpolationStr =
         (parset.isDefined(prefix + "interpolation")
@@ -191,7 +242,10 @@ std::vector<schaapcommon::h5parm::SolTab> OneApplyCal::MakeSolTabs(
   return solution_tables;
 }
 
-OneApplyCal::~OneApplyCal() {}
+OneApplyCal::~OneApplyCal() {
+  // The background read uses the members of this step.
+  if (itsPrefetchedParameters.valid()) itsPrefetchedParameters.wait();
+}
 
 void OneApplyCal::updateInfo(const DPInfo& infoIn) {
   Step::updateInfo(infoIn);
@@ -202,8 +256,10 @@ void OneApplyCal::updateInfo(const DPInfo& infoIn) {
 
   if (itsParmDBOnDisk) {
     if (!itsUseH5Parm) {
-      // Use ParmDB
-      itsParmDB = std::make_shared<parmdb::ParmFacade>(itsParmDBName);
+      // Use ParmDB. ApplyCal only reads it, so it is read into memory once to
+      // avoid table selections for every chunk.
+      itsParmDB = std::make_shared<parmdb::ParmFacade>(itsParmDBName, false,
+                                                       true);
     }
 
     // Detect if full jones solutions are present
@@ -319,6 +375,27 @@ void OneApplyCal::updateInfo(const DPInfo& infoIn) {
 
   itsFlagCounter.init(getInfo());
 
+  if (itsInputType == MsType::kBda) {
+    if (!itsParmDBOnDisk || !itsUseH5Parm) {
+      throw std::runtime_error(
+          "ApplyCal " + itsName + " requires an H5Parm for BDA data");
+    }
+    // Group the baselines by their channel frequencies, such that the
+    // solutions are gridded only once per distinct channel layout.
+    itsBdaLayouts.clear();
+    itsBdaLayoutFreqs.clear();
+    itsBdaLayouts.reserve(infoIn.nbaselines());
+    for (std::size_t bl = 0; bl < infoIn.nbaselines(); ++bl) {
+      const std::vector<double>& freqs = infoIn.chanFreqs(bl);
+      const auto layout =
+          std::find(itsBdaLayoutFreqs.begin(), itsBdaLayoutFreqs.end(), freqs);
+      itsBdaLayouts.push_back(layout - itsBdaLayoutFreqs.begin());
+      if (layout == itsBdaLayoutFreqs.end()) itsBdaLayoutFreqs.push_back(freqs);
+    }
+    itsBdaJonesParameters.clear();
+    itsBdaJonesParameters.resize(itsBdaLayoutFreqs.size());
+  }
+
   // Check that channels are evenly spaced
   if (!itsUseH5Parm && !info().channelsAreRegular()) {
     throw std::runtime_error(
@@ -342,6 +419,7 @@ void OneApplyCal::show(std::ostream& os) const {
        << JonesParameters::MissingAntennaBehaviorToString(
               itsMissingAntennaBehavior)
        << '\n';
+    os << "  Prefetch:       " << std::boolalpha << itsPrefetch << '\n';
   } else if (itsParmDBOnDisk) {
     os << "  Parmdb:         " << itsParmDBName << '\n';
   } else {
@@ -370,14 +448,25 @@ void OneApplyCal::showTimings(std::ostream& os, double duration) const {
 
 bool OneApplyCal::process(std::unique_ptr<DPBuffer> buffer) {
   itsTimer.start();
+  StartBaselineTiles(*buffer);
+  aocommon::StaticFor<size_t> loop;
+  loop.Run(0, buffer->GetData().shape(0),
+           [&](size_t start_baseline, size_t end_baseline) {
+             ProcessBaselines(*buffer, start_baseline, end_baseline);
+           });
+  itsTimer.stop();
+  getNextStep()->process(std::move(buffer));
+  return true;
+}
 
-  if (buffer->GetTime() > itsLastTime) {
+void OneApplyCal::StartBaselineTiles(DPBuffer& buffer) {
+  if (buffer.GetTime() > itsLastTime) {
     if (itsParmDBOnDisk && itsUseH5Parm) {
-      updateParmsH5(buffer->GetTime());
+      updateParmsH5(buffer.GetTime());
     } else if (itsParmDBOnDisk) {
-      updateParmsParmDB(buffer->GetTime());
+      updateParmsParmDB(buffer.GetTime());
     } else {
-      if (buffer->GetSolution().size() == 0) {
+      if (buffer.GetSolution().size() == 0) {
         throw std::runtime_error(
             "No buffer stored before OneApplyCal step. Ensure a solution is "
             "computed before this step, or specify a parmdb/h5parm file in "
@@ -401,10 +490,10 @@ bool OneApplyCal::process(std::unique_ptr<DPBuffer> buffer) {
       }
 
       // Validate that the data is in the correct shape
-      const size_t n_chan = buffer->GetData().shape(1);
+      const size_t n_chan = buffer.GetData().shape(1);
       const size_t n_corrs =
-          buffer->GetSolution()[0].size() / info().antennaNames().size();
-      if (buffer->GetSolution().size() != n_chan ||
+          buffer.GetSolution()[0].size() / info().antennaNames().size();
+      if (buffer.GetSolution().size() != n_chan ||
           (n_corrs != 2 && n_corrs != 4)) {
         throw std::runtime_error(
             "The solution is not in the correct shape. Was the solution "
@@ -413,38 +502,106 @@ bool OneApplyCal::process(std::unique_ptr<DPBuffer> buffer) {
 
       itsJonesParameters = std::make_unique<JonesParameters>(
           info().chanFreqs(), times, info().antennaNames(), gain_type,
-          buffer->GetSolution(), itsInvert, itsSigmaMMSE);
+          buffer.GetSolution(), itsInvert, itsSigmaMMSE);
     }
     itsTimeStep = 0;
   } else {
     itsTimeStep++;
   }
+  itsCount++;
+}
+
+void OneApplyCal::ProcessBaselines(DPBuffer& buffer, size_t first_baseline,
+                                   size_t end_baseline) {
+  // The data always has 4 correlations. The gains have 2 (diagonal) or 4
+  // (full Jones) parameters.
+  if (itsJonesParameters->GetParms().shape()[0] > 2) {
+    ApplyToBaselines<true>(buffer, first_baseline, end_baseline);
+  } else {
+    ApplyToBaselines<false>(buffer, first_baseline, end_baseline);
+  }
+}
 
-  // Loop through all baselines in the buffer.
-  const size_t n_bl = buffer->GetData().shape(0);
-  const size_t n_chan = buffer->GetData().shape(1);
+template <bool FullJones>
+void OneApplyCal::ApplyToBaselines(DPBuffer& buffer, size_t first_baseline,
+                                   size_t end_baseline) {
+  const size_t n_chan = buffer.GetData().shape(1);
   const casacore::Cube<casacore::Complex>& gains =
       itsJonesParameters->GetParms();
-  const size_t n_corr = gains.shape()[0];
 
+  for (size_t bl = first_baseline; bl < end_baseline; ++bl) {
+    const unsigned int ant_a = info().getAnt1()[bl];
+    const unsigned int ant_b = info().getAnt2()[bl];
+
+    for (size_t chan = 0; chan < n_chan; chan++) {
+      const unsigned int time_freq_offset =
+          (itsTimeStep * info().nchan()) + chan;
+      const std::complex<float>* gain_a = &gains(0, ant_a, time_freq_offset);
+      const std::complex<float>* gain_b = &gains(0, ant_b, time_freq_offset);
+      if constexpr (FullJones) {
+        ApplyCal::ApplyFull(aocommon::MC2x2F(gain_a), aocommon::MC2x2F(gain_b),
+                            buffer, bl, chan, itsUpdateWeights,
+                            itsFlagCounter);
+      } else {
+        ApplyCal::ApplyDiag(aocommon::MC2x2FDiag(gain_a),
+                            aocommon::MC2x2FDiag(gain_b), buffer, bl, chan,
+                            itsUpdateWeights, itsFlagCounter);
+      }
+    }
+  }
+}
+
+bool OneApplyCal::process(std::unique_ptr<BDABuffer> buffer) {
+  itsTimer.start();
+
+  std::vector<BDABuffer::Row>& rows = buffer->GetRows();
+  if (!rows.empty()) {
+    double start_time = std::numeric_limits<double>::max();
+    double end_time = std::numeric_limits<double>::lowest();
+    for (const BDABuffer::Row& row : rows) {
+      start_time = std::min(start_time, row.time - 0.5 * row.interval);
+      end_time = std::max(end_time, row.time + 0.5 * row.interval);
+    }
+    // BDA rows are not ordered by time, so also re-read the solutions if a
+    // row starts before the current chunk.
+    if (itsBdaNTimes == 0 ||
+        BDABuffer::TimeIsLess(start_time, itsBdaFirstTime) ||
+        BDABuffer::TimeIsLess(itsLastTime, end_time)) {
+      updateParmsH5Bda(start_time, end_time);
+    }
+  }
+
+  const double time_interval = info().timeInterval();
   aocommon::StaticFor<size_t> loop;
-  loop.Run(0, n_bl, [&](size_t start_baseline, size_t end_baseline) {
-    for (size_t bl = start_baseline; bl < end_baseline; ++bl) {
-      const unsigned int ant_a = info().getAnt1()[bl];
-      const unsigned int ant_b = info().getAnt2()[bl];
-
-      for (size_t chan = 0; chan < n_chan; chan++) {
-        const unsigned int time_freq_offset =
-            (itsTimeStep * info().nchan()) + chan;
+  loop.Run(0, rows.size(), [&](size_t start_row, size_t end_row) {
+    for (size_t row_nr = start_row; row_nr < end_row; ++row_nr) {
+      BDABuffer::Row& row = rows[row_nr];
+      const size_t layout = itsBdaLayouts[row.baseline_nr];
+      const size_t n_layout_chan = itsBdaLayoutFreqs[layout].size();
+      assert(row.n_channels == n_layout_chan);
+      const casacore::Cube<casacore::Complex>& gains =
+          itsBdaJonesParameters[layout]->GetParms();
+      const size_t n_corr = gains.shape()[0];
+      const unsigned int ant_a = info().getAnt1()[row.baseline_nr];
+      const unsigned int ant_b = info().getAnt2()[row.baseline_nr];
+
+      // Use the time slot that contains the centroid of the row.
+      const double slot =
+          std::floor((row.time - itsBdaFirstTime) / time_interval);
+      const size_t time_step =
+          std::min(size_t(std::max(slot, 0.0)), itsBdaNTimes - 1);
+
+      for (size_t chan = 0; chan < row.n_channels; ++chan) {
+        const size_t time_freq_offset = time_step * n_layout_chan + chan;
         const std::complex<float>* gain_a = &gains(0, ant_a, time_freq_offset);
         const std::complex<float>* gain_b = &gains(0, ant_b, time_freq_offset);
         if (n_corr > 2) {
           ApplyCal::ApplyFull(aocommon::MC2x2F(gain_a),
-                              aocommon::MC2x2F(gain_b), *buffer, bl, chan,
+                              aocommon::MC2x2F(gain_b), row, chan,
                               itsUpdateWeights, itsFlagCounter);
         } else {
           ApplyCal::ApplyDiag(aocommon::MC2x2FDiag(gain_a),
-                              aocommon::MC2x2FDiag(gain_b), *buffer, bl, chan,
+                              aocommon::MC2x2FDiag(gain_b), row, chan,
                               itsUpdateWeights, itsFlagCounter);
         }
       }
@@ -465,16 +622,22 @@ void OneApplyCal::finish() {
 
 std::vector<double> OneApplyCal::CalculateBufferTimes(double buffer_start_time,
                                                       bool use_end) {
-  itsLastTime = buffer_start_time - 0.5 * info().timeInterval() +
-                itsTimeSlotsPerParmUpdate * info().timeInterval();
+  return CalculateChunkTimes(buffer_start_time, use_end, itsLastTime);
+}
+
+std::vector<double> OneApplyCal::CalculateChunkTimes(double buffer_start_time,
+                                                     bool use_end,
+                                                     double& last_time) const {
+  last_time = buffer_start_time - 0.5 * info().timeInterval() +
+              itsTimeSlotsPerParmUpdate * info().timeInterval();
   size_t n_times = itsTimeSlotsPerParmUpdate;
   // If calculated time is past the last timestep in the ms,
   // move it back.
   const double lastMSTime =
       info().startTime() + info().ntime() * info().timeInterval();
-  if (itsLastTime > lastMSTime &&
-      !casacore::nearAbs(itsLastTime, lastMSTime, 1.e-3)) {
-    itsLastTime = lastMSTime;
+  if (last_time > lastMSTime &&
+      !casacore::nearAbs(last_time, lastMSTime, 1.e-3)) {
+    last_time = lastMSTime;
     n_times = info().ntime() % itsTimeSlotsPerParmUpdate;
   }
   std::vector<double> times;
@@ -489,10 +652,110 @@ std::vector<double> OneApplyCal::CalculateBufferTimes(double buffer_start_time,
 }
 
 void OneApplyCal::updateParmsH5(const double bufStartTime) {
-  aocommon::Logger::Debug << "Reading and gridding H5Parm for direction "
-                          << itsDirection << ".\n";
   const std::vector<double> times = CalculateBufferTimes(bufStartTime, false);
 
+  // Explicitly reset beforehand to not have two buffers alive
+  // at the same time
+  itsJonesParameters.reset();
+  if (itsPrefetchedParameters.valid()) {
+    std::shared_ptr<JonesParameters> prefetched =
+        itsPrefetchedParameters.get();
+    if (casacore::nearAbs(itsPrefetchTime, bufStartTime,
+                          1.e-3 * info().timeInterval())) {
+      itsJonesParameters = std::move(prefetched);
+    }
+  }
+  if (!itsJonesParameters) {
+    aocommon::Logger::Debug << "Reading and gridding H5Parm for direction "
+                            << itsDirection << ".\n";
+    itsJonesParameters = getParmsH5(info().chanFreqs(), times);
+  }
+
+  if (itsPrefetch) startPrefetchH5();
+}
+
+void OneApplyCal::startPrefetchH5() {
+  const double next_time = itsLastTime + 0.5 * info().timeInterval();
+  const double end_time =
+      info().startTime() + info().ntime() * info().timeInterval();
+  if (next_time >= end_time) return;
+
+  double next_last_time;
+  std::vector<double> times =
+      CalculateChunkTimes(next_time, false, next_last_time);
+  itsPrefetchTime = next_time;
+  itsPrefetchedParameters =
+      std::async(std::launch::async, [this, times = std::move(times)] {
+        return getParmsH5(info().chanFreqs(), times);
+      });
+}
+
+void OneApplyCal::updateParmsH5Bda(double start_time, double end_time) {
+  aocommon::Logger::Debug << "Reading and gridding H5Parm for BDA data for "
+                          << "direction " << itsDirection << ".\n";
+  // Grid the solutions on the original time slots, which are the shortest
+  // intervals in the BDA data.
+  const double time_interval = info().timeInterval();
+  const size_t n_needed =
+      std::ceil((end_time - start_time) / time_interval - 1.0e-6);
+  itsBdaNTimes = std::max<size_t>({n_needed, itsTimeSlotsPerParmUpdate, 1});
+  itsBdaFirstTime = start_time;
+  itsLastTime = start_time + itsBdaNTimes * time_interval;
+
+  std::vector<double> times;
+  times.reserve(itsBdaNTimes);
+  for (size_t t = 0; t < itsBdaNTimes; ++t) {
+    times.push_back(start_time + (t + 0.5) * time_interval);
+  }
+
+  for (size_t layout = 0; layout < itsBdaLayoutFreqs.size(); ++layout) {
+    itsBdaJonesParameters[layout].reset();
+    itsBdaJonesParameters[layout] =
+        getParmsH5(itsBdaLayoutFreqs[layout], times);
+  }
+}
+
+std::shared_ptr<JonesParameters> OneApplyCal::getParmsH5(
+    const std::vector<double>& freqs, const std::vector<double>& times) const {
+  ParmsCacheKey key{itsParmDBName,
+                    itsSolSetName,
+                    specified_correction_,
+                    solution_table_names_,
+                    itsCorrectType,
+                    itsDirection,
+                    itsInterpolationType,
+                    itsMissingAntennaBehavior,
+                    itsInvert,
+                    itsSigmaMMSE,
+                    info().antennaNames(),
+                    freqs,
+                    times};
+  {
+    std::lock_guard<std::mutex> lock(parms_cache_mutex);
+    const auto iterator = parms_cache.find(key);
+    if (iterator != parms_cache.end()) {
+      std::shared_ptr<JonesParameters> parameters = iterator->second.lock();
+      if (parameters) return parameters;
+    }
+  }
+
+  std::shared_ptr<JonesParameters> parameters = readParmsH5(freqs, times);
+
+  std::lock_guard<std::mutex> lock(parms_cache_mutex);
+  // Remove the entries that are no longer used by any step.
+  for (auto iterator = parms_cache.begin(); iterator != parms_cache.end();) {
+    if (iterator->second.expired()) {
+      iterator = parms_cache.erase(iterator);
+    } else {
+      ++iterator;
+    }
+  }
+  parms_cache[std::move(key)] = parameters;
+  return parameters;
+}
+
+std::unique_ptr<JonesParameters> OneApplyCal::readParmsH5(
+    const std::vector<double>& freqs, const std::vector<double>& times) const {
   std::lock_guard<std::mutex> lock(theirHDF5Mutex);
   schaapcommon::h5parm::H5Parm h5parm(itsParmDBName, false, false,
                                       itsSolSetName);
@@ -512,14 +775,10 @@ void OneApplyCal::updateParmsH5(const double bufStartTime) {
     ant_names.push_back(name);
   }
 
-  // Explicitly reset beforehand to not have two buffers alive
-  // at the same time
-  itsJonesParameters.reset();
-  itsJonesParameters = std::make_unique<JonesParameters>(
-      info().chanFreqs(), times, ant_names, itsCorrectType,
-      itsInterpolationType, itsDirection, &solution_tables[0],
-      &solution_tables[1], itsInvert, itsSigmaMMSE, itsParmExprs.size(),
-      itsMissingAntennaBehavior);
+  return std::make_unique<JonesParameters>(
+      freqs, times, ant_names, itsCorrectType, itsInterpolationType,
+      itsDirection, &solution_tables[0], &solution_tables[1], itsInvert,
+      itsSigmaMMSE, itsParmExprs.size(), itsMissingAntennaBehavior);
 }
 
 void OneApplyCal::updateParmsParmDB(const double bufStartTime) {
@@ -9,6 +9,7 @@
 #ifndef DP3_STEPS_ONEAPPLYCAL_H_
 #define DP3_STEPS_ONEAPPLYCAL_H_
 
+#include <future>
 #include <mutex>
 
 #include <casacore/casa/Arrays/Cube.h>
@@ -17,6 +18,7 @@
 #include <schaapcommon/h5parm/jonesparameters.h>
 
 #include <dp3/steps/Step.h>
+#include <dp3/base/BDABuffer.h>
 #include <dp3/base/DPBuffer.h>
 #include "../base/FlagCounter.h"
 #include "../common/Timer.h"
@@ -38,9 +40,12 @@ class OneApplyCal : public Step {
  public:
   /// Construct the object.
   /// Parameters are obtained from the parset using the given prefix.
+  /// @param input_type Input type, Regular (default) or Bda. BDA data is only
+  /// supported when the solutions are read from an H5Parm.
   OneApplyCal(const common::ParameterSet&, const std::string& prefix,
               const std::string& defaultPrefix, bool substep = false,
-              std::string predictDirection = "");
+              std::string predictDirection = "",
+              MsType input_type = MsType::kRegular);
 
   ~OneApplyCal() override;
 
@@ -59,6 +64,26 @@ class OneApplyCal : public Step {
   /// When processed, it invokes the process function of the next step.
   bool process(std::unique_ptr<base::DPBuffer> buffer) override;
 
+  bool SupportsBaselineTiles() const override {
+    return itsInputType == MsType::kRegular;
+  }
+
+  /// Read the solutions for the time of the buffer, if needed.
+  void StartBaselineTiles(base::DPBuffer& buffer) override;
+
+  void ProcessBaselines(base::DPBuffer& buffer, size_t first_baseline,
+                        size_t end_baseline) override;
+
+  /// Process the BDA data.
+  /// Each row uses the solutions at the channel frequencies of its baseline
+  /// and at the original time slot that contains its centroid time.
+  /// When processed, it invokes the process function of the next step.
+  bool process(std::unique_ptr<base::BDABuffer> buffer) override;
+
+  bool accepts(MsType dt) const override { return dt == itsInputType; }
+
+  MsType outputs() const override { return itsInputType; }
+
   /// Finish the processing of this step and subsequent steps.
   void finish() override;
 
@@ -74,6 +99,13 @@ class OneApplyCal : public Step {
   bool invert() { return itsInvert; }
 
  private:
+  /// Apply diagonal or full Jones gains to the baselines
+  /// [first_baseline, end_baseline) of a buffer. Choosing the gain type once
+  /// per tile keeps the branch out of the channel loop.
+  template <bool FullJones>
+  void ApplyToBaselines(base::DPBuffer& buffer, size_t first_baseline,
+                        size_t end_baseline);
+
   /// Read parameters from the associated parmdb and store them in
   /// itsJonesParameters
   void updateParmsParmDB(const double bufStartTime);
@@ -82,6 +114,25 @@ class OneApplyCal : public Step {
   /// itsJonesParameters
   void updateParmsH5(const double bufStartTime);
 
+  /// Read parameters from the associated h5 for BDA data, for all channel
+  /// layouts, on a time grid that covers [start_time, end_time].
+  void updateParmsH5Bda(double start_time, double end_time);
+
+  /// Read parameters from the associated h5 and grid them on the given
+  /// frequencies and times.
+  std::unique_ptr<JonesParameters> readParmsH5(
+      const std::vector<double>& freqs, const std::vector<double>& times) const;
+
+  /// Like readParmsH5, but returns the gridded parameters of another
+  /// OneApplyCal that reads the same solutions on the same grid, if that
+  /// result is still in use. The returned parameters should not be modified.
+  std::shared_ptr<JonesParameters> getParmsH5(
+      const std::vector<double>& freqs, const std::vector<double>& times) const;
+
+  /// Start reading the parameters for the chunk after the current one on a
+  /// background thread, if there is such a chunk.
+  void startPrefetchH5();
+
   /// If needed, show the flag counts.
   void showCounts(std::ostream&) const override;
 
@@ -100,10 +151,17 @@ class OneApplyCal : public Step {
   std::vector<double> CalculateBufferTimes(double buffer_start_time,
                                            bool use_end);
 
+  /// Calculates the solution times for the chunk that starts at
+  /// buffer_start_time, and sets last_time to the end time of that chunk.
+  std::vector<double> CalculateChunkTimes(double buffer_start_time,
+                                          bool use_end,
+                                          double& last_time) const;
+
   /// in the case of full Jones, amp and phase table need to be open
   std::vector<schaapcommon::h5parm::SolTab> MakeSolTabs(
       schaapcommon::h5parm::H5Parm& h5parm) const;
 
+  const MsType itsInputType;
   std::string itsName;
   std::string itsParmDBName;
   // itsParmDBOnDisk specifies the existence of a parmdb on disk. If this is
@@ -120,6 +178,7 @@ class OneApplyCal : public Step {
   bool itsInvert;
   JonesParameters::InterpolationType itsInterpolationType;
   unsigned int itsTimeSlotsPerParmUpdate;
+  bool itsPrefetch;  ///< read the next chunk of solutions in the background
   double itsSigmaMMSE;
   bool itsUpdateWeights;
 
@@ -131,7 +190,7 @@ class OneApplyCal : public Step {
   /// itsJonesParameters contains the gridded parameters, first for all
   /// parameters (e.g. Gain:0:0 and Gain:1:1), next all antennas, next over freq
   /// * time as returned by ParmDB numparms, antennas, time x frequency
-  std::unique_ptr<JonesParameters> itsJonesParameters;
+  std::shared_ptr<JonesParameters> itsJonesParameters;
   unsigned int itsTimeStep;  ///< time step within current chunk
   unsigned int itsNCorr;
   double itsLastTime;  ///< last time of current chunk
@@ -141,6 +200,24 @@ class OneApplyCal : public Step {
   common::NSTimer itsTimer;
   std::vector<std::string> solution_table_names_;
 
+  /// For BDA data, baselines with equal channel frequencies share a channel
+  /// layout. itsBdaLayouts holds the layout index for each baseline.
+  /// itsBdaLayoutFreqs and itsBdaJonesParameters hold the channel frequencies
+  /// and the gridded parameters for each layout.
+  /// @{
+  std::vector<std::size_t> itsBdaLayouts;
+  std::vector<std::vector<double>> itsBdaLayoutFreqs;
+  std::vector<std::shared_ptr<JonesParameters>> itsBdaJonesParameters;
+  /// @}
+  /// Parameters of the next chunk that are being read in the background, and
+  /// the start time of that chunk.
+  /// @{
+  std::future<std::shared_ptr<JonesParameters>> itsPrefetchedParameters;
+  double itsPrefetchTime;
+  /// @}
+  double itsBdaFirstTime;  ///< start time of the current BDA chunk
+  std::size_t itsBdaNTimes;  ///< number of time slots in current BDA chunk
+
   static std::mutex theirHDF5Mutex;  ///< Prevent parallel access to HDF5
 };
 
@@ -123,6 +123,15 @@ void OnePredict::init(const common::ParameterSet& parset,
                              exception.what());
   }
 
+  min_flux_ = parset.getDouble(prefix + "minflux", 0.0);
+  if (min_flux_ > 0.0) {
+    patch_list_ = base::RemoveFaintComponents(patch_list_, min_flux_);
+    if (patch_list_.empty()) {
+      throw std::runtime_error("All sources for direction " + direction_str_ +
+                               " are fainter than minflux");
+    }
+  }
+
   if (apply_beam_) {
     use_channel_freq_ = parset.getBool(prefix + "usechannelfreq", true);
     one_beam_per_patch_ = parset.getBool(prefix + "onebeamperpatch", false);
@@ -303,6 +312,9 @@ void OnePredict::show(std::ostream& os) const {
   os << "   patches clustered:      " << std::boolalpha
      << (!one_beam_per_patch_ && (beam_proximity_limit_ > 0.0)) << '\n';
   os << "   number of components:   " << source_list_.size() << '\n';
+  if (min_flux_ > 0.0) {
+    os << "   minimum flux:           " << min_flux_ << " Jy\n";
+  }
   os << "   absolute orientation:   " << std::boolalpha
      << any_orientation_is_absolute_ << '\n';
   os << "   all unpolarized:        " << std::boolalpha << stokes_i_only_
@@ -178,6 +178,9 @@ class OnePredict : public ModelDataStep {
   /// will be grouped into one patch. Value is in arcsec; zero means don't
   /// group.
   double beam_proximity_limit_{false};
+  /// Components with an absolute Stokes I flux below this value (in Jy) are
+  /// not predicted. Zero means don't remove any components.
+  double min_flux_{0.0};
   bool stokes_i_only_{false};
   bool any_orientation_is_absolute_{false};  ///< Any of the Gaussian sources
                                              ///< has absolute orientation
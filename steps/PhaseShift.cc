@@ -20,11 +20,13 @@
 #include <casacore/casa/Quanta/MVAngle.h>
 #include <casacore/casa/BasicSL/Constants.h>
 
+#include <cassert>
 #include <iostream>
 #include <iomanip>
 
 #include <boost/algorithm/string/case_conv.hpp>
 
+using dp3::base::BDABuffer;
 using dp3::base::DPBuffer;
 using dp3::base::DPInfo;
 using dp3::base::FlagCounter;
@@ -37,13 +39,16 @@ using casacore::MDirection;
 namespace dp3 {
 namespace steps {
 
-PhaseShift::PhaseShift(const common::ParameterSet& parset, const string& prefix)
-    : itsName(prefix),
+PhaseShift::PhaseShift(const common::ParameterSet& parset, const string& prefix,
+                       MsType input_type)
+    : itsInputType(input_type),
+      itsName(prefix),
       itsCenter(parset.getStringVector(prefix + "phasecenter")) {}
 
 PhaseShift::PhaseShift(const common::ParameterSet& parset, const string& prefix,
                        const std::vector<std::string>& defVal)
-    : itsName(prefix),
+    : itsInputType(MsType::kRegular),
+      itsName(prefix),
       itsCenter(parset.getStringVector(prefix + "phasecenter", defVal)) {}
 
 PhaseShift::~PhaseShift() {}
@@ -82,8 +87,35 @@ void PhaseShift::updateInfo(const DPInfo& infoIn) {
     itsFreqC.push_back(2. * casacore::C::pi * freq[i] / casacore::C::c);
   }
 
-  std::array<size_t, 2> phasors_shape{infoIn.nbaselines(), infoIn.nchan()};
-  itsPhasors.resize(phasors_shape);
+  if (itsInputType == MsType::kBda) {
+    // BDA data has different channels per baseline.
+    itsBdaFreqC.resize(infoIn.nbaselines());
+    for (size_t bl = 0; bl < infoIn.nbaselines(); ++bl) {
+      const std::vector<double>& bl_freqs = infoIn.chanFreqs(bl);
+      itsBdaFreqC[bl].reserve(bl_freqs.size());
+      for (double bl_freq : bl_freqs) {
+        itsBdaFreqC[bl].push_back(2. * casacore::C::pi * bl_freq /
+                                  casacore::C::c);
+      }
+    }
+  } else {
+    std::array<size_t, 2> phasors_shape{infoIn.nbaselines(), infoIn.nchan()};
+    itsPhasors.resize(phasors_shape);
+
+    switch (infoIn.ncorr()) {
+      case 1:
+        itsShiftBaselines = &PhaseShift::ShiftBaselines<1>;
+        break;
+      case 2:
+        itsShiftBaselines = &PhaseShift::ShiftBaselines<2>;
+        break;
+      case 4:
+        itsShiftBaselines = &PhaseShift::ShiftBaselines<4>;
+        break;
+      default:
+        itsShiftBaselines = &PhaseShift::ShiftBaselines<0>;
+    }
+  }
 }
 
 void PhaseShift::show(std::ostream& os) const {
@@ -100,49 +132,85 @@ void PhaseShift::showTimings(std::ostream& os, double duration) const {
 bool PhaseShift::process(std::unique_ptr<base::DPBuffer> buffer) {
   itsTimer.start();
 
-  int ncorr = buffer->GetData().shape(2);
-  int nchan = buffer->GetData().shape(1);
-  int nbl = buffer->GetData().shape(0);
-  const double* mat1 = itsEulerMatrix.data();
-  // If ever in the future a time dependent phase center is used,
-  // the machine must be reset for each new time, thus each new call
-  // to process.
+  aocommon::StaticFor<size_t> loop;
+  loop.Run(0, buffer->GetData().shape(0), [&](size_t begin, size_t end) {
+    (this->*itsShiftBaselines)(*buffer, begin, end);
+  });
+  itsTimer.stop();
+  getNextStep()->process(std::move(buffer));
+  return true;
+}
 
+template <size_t NCorr>
+void PhaseShift::ShiftBaselines(DPBuffer& buffer, size_t begin, size_t end) {
+  assert(NCorr == 0 || buffer.GetData().shape(2) == NCorr);
+  const size_t ncorr = NCorr == 0 ? buffer.GetData().shape(2) : NCorr;
+  const size_t nchan = buffer.GetData().shape(1);
+
+  for (size_t bl = begin; bl != end; ++bl) {
+    std::complex<float>* __restrict__ data = &buffer.GetData()(bl, 0, 0);
+    std::complex<double>* __restrict__ phasors = &itsPhasors(bl, 0);
+    const double phase = RotateUvw(&buffer.GetUvw()(bl, 0));
+    for (size_t j = 0; j < nchan; ++j) {
+      // Shift the phase of the data of this baseline.
+      // Converting the phase term to wavelengths (and applying 2*pi)
+      //      u_wvl = u_m / wvl = u_m * freq / c
+      // has been done once in the beginning (in updateInfo).
+      double phasewvl = phase * itsFreqC[j];
+      std::complex<double> phasor(cos(phasewvl), sin(phasewvl));
+      *phasors++ = phasor;
+      for (size_t k = 0; k < ncorr; ++k) {
+        *data = std::complex<double>(*data) * phasor;
+        data++;
+      }
+    }
+  }
+}
+
+bool PhaseShift::process(std::unique_ptr<BDABuffer> buffer) {
+  itsTimer.start();
+
+  std::vector<BDABuffer::Row>& rows = buffer->GetRows();
   aocommon::StaticFor<size_t> loop;
-  loop.Run(0, nbl, [&](size_t begin, size_t end) {
-    for (unsigned int bl = begin; bl != end; ++bl) {
-      std::complex<float>* __restrict__ data = &buffer->GetData()(bl, 0, 0);
-      double* __restrict__ uvw = &buffer->GetUvw()(bl, 0);
-      std::complex<double>* __restrict__ phasors = &itsPhasors(bl, 0);
-      double u = uvw[0] * mat1[0] + uvw[1] * mat1[3] + uvw[2] * mat1[6];
-      double v = uvw[0] * mat1[1] + uvw[1] * mat1[4] + uvw[2] * mat1[7];
-      double w = uvw[0] * mat1[2] + uvw[1] * mat1[5] + uvw[2] * mat1[8];
-      double phase =
-          itsXYZ[0] * uvw[0] + itsXYZ[1] * uvw[1] + itsXYZ[2] * uvw[2];
-      for (int j = 0; j < nchan; ++j) {
-        // Shift the phase of the data of this baseline.
-        // Converting the phase term to wavelengths (and applying 2*pi)
-        //      u_wvl = u_m / wvl = u_m * freq / c
-        // has been done once in the beginning (in updateInfo).
-        double phasewvl = phase * itsFreqC[j];
-        std::complex<double> phasor(cos(phasewvl), sin(phasewvl));
-        *phasors++ = phasor;
-        for (int k = 0; k < ncorr; ++k) {
+  loop.Run(0, rows.size(), [&](size_t begin, size_t end) {
+    for (size_t row_nr = begin; row_nr != end; ++row_nr) {
+      BDABuffer::Row& row = rows[row_nr];
+      const std::vector<double>& freq_c = itsBdaFreqC[row.baseline_nr];
+      assert(row.n_channels == freq_c.size());
+      std::complex<float>* __restrict__ data = row.data;
+      const double phase = RotateUvw(row.uvw);
+      for (size_t j = 0; j < row.n_channels; ++j) {
+        const double phasewvl = phase * freq_c[j];
+        const std::complex<double> phasor(cos(phasewvl), sin(phasewvl));
+        for (size_t k = 0; k < row.n_correlations; ++k) {
           *data = std::complex<double>(*data) * phasor;
           data++;
         }
       }
-      uvw[0] = u;
-      uvw[1] = v;
-      uvw[2] = w;
-      uvw += 3;
     }
   });
+
   itsTimer.stop();
   getNextStep()->process(std::move(buffer));
   return true;
 }
 
+double PhaseShift::RotateUvw(double* uvw) const {
+  // If ever in the future a time dependent phase center is used,
+  // the machine must be reset for each new time, thus each new call
+  // to process.
+  const double* mat1 = itsEulerMatrix.data();
+  const double u = uvw[0] * mat1[0] + uvw[1] * mat1[3] + uvw[2] * mat1[6];
+  const double v = uvw[0] * mat1[1] + uvw[1] * mat1[4] + uvw[2] * mat1[7];
+  const double w = uvw[0] * mat1[2] + uvw[1] * mat1[5] + uvw[2] * mat1[8];
+  const double phase =
+      itsXYZ[0] * uvw[0] + itsXYZ[1] * uvw[1] + itsXYZ[2] * uvw[2];
+  uvw[0] = u;
+  uvw[1] = v;
+  uvw[2] = w;
+  return phase;
+}
+
 void PhaseShift::finish() {
   // Let the next steps finish.
   getNextStep()->finish();
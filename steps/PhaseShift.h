@@ -10,6 +10,7 @@
 
 #include "InputStep.h"
 
+#include <dp3/base/BDABuffer.h>
 #include <dp3/base/DPBuffer.h>
 
 #include <aocommon/staticfor.h>
@@ -39,7 +40,9 @@ class PhaseShift : public Step {
   /// Construct the object.
   /// Parameters are obtained from the parset using the given prefix.
   /// This is the standard constructor where the phasecenter must be given.
-  PhaseShift(const common::ParameterSet&, const string& prefix);
+  /// @param input_type Input type, Regular (default) or Bda.
+  PhaseShift(const common::ParameterSet&, const string& prefix,
+             MsType input_type = MsType::kRegular);
 
   /// Construct the object.
   /// Parameters are obtained from the parset using the given prefix.
@@ -63,6 +66,16 @@ class PhaseShift : public Step {
   /// When processed, it invokes the process function of the next step.
   bool process(std::unique_ptr<base::DPBuffer> buffer) override;
 
+  /// Process the BDA data.
+  /// It keeps the data. The phase term of each row is evaluated at the
+  /// channel frequencies of the baseline of that row.
+  /// When processed, it invokes the process function of the next step.
+  bool process(std::unique_ptr<base::BDABuffer> buffer) override;
+
+  bool accepts(MsType dt) const override { return dt == itsInputType; }
+
+  MsType outputs() const override { return itsInputType; }
+
   /// Finish the processing of this step and subsequent steps.
   void finish() override;
 
@@ -93,13 +106,28 @@ class PhaseShift : public Step {
   /// Currently only J2000 RA and DEC can be given.
   casacore::MDirection handleCenter();
 
+  /// Rotate the uvw coordinates of one baseline and return the phase term
+  /// (in meters) for shifting its visibilities.
+  double RotateUvw(double* uvw) const;
+
+  /// Shift the baselines [begin, end) of a buffer. NCorr is the number of
+  /// correlations, or zero to use the number of correlations of the buffer.
+  template <size_t NCorr>
+  void ShiftBaselines(base::DPBuffer& buffer, size_t begin, size_t end);
+
+  const MsType itsInputType;
   std::string itsName;
   std::vector<string> itsCenter;
   std::vector<double> itsFreqC;  ///< freq/C
+  /// freq/C per baseline, only used for BDA data.
+  std::vector<std::vector<double>> itsBdaFreqC;
   casacore::Matrix<double> itsEulerMatrix;
   double itsXYZ[3];  ///< numpy.dot((w-w1).T, T)
   xt::xtensor<std::complex<double>, 2>
       itsPhasors;  ///< phase factor per chan,bl
+  /// Kernel for the number of correlations, set in updateInfo().
+  void (PhaseShift::*itsShiftBaselines)(base::DPBuffer&, size_t, size_t) =
+      &PhaseShift::ShiftBaselines<0>;
   common::NSTimer itsTimer;
 };
 
@@ -192,6 +192,14 @@ bool ScaleData::process(std::unique_ptr<base::DPBuffer> buf) {
   return true;
 }
 
+void ScaleData::ProcessBaselines(base::DPBuffer& buffer,
+                                 std::size_t first_baseline,
+                                 std::size_t end_baseline) {
+  const auto baselines = xt::range(first_baseline, end_baseline);
+  xt::view(buffer.GetData(), baselines, xt::all(), xt::all()) *=
+      xt::view(itsFactors, baselines, xt::all(), xt::all());
+}
+
 bool ScaleData::process(std::unique_ptr<BDABuffer> bda_buffer) {
   itsTimer.start();
   std::vector<BDABuffer::Row> rows = bda_buffer->GetRows();
@@ -64,6 +64,13 @@ class ScaleData : public Step {
   /// When processed, it invokes the process function of the next step.
   bool process(std::unique_ptr<base::BDABuffer>) override;
 
+  bool SupportsBaselineTiles() const override {
+    return itsInputType == MsType::kRegular;
+  }
+
+  void ProcessBaselines(base::DPBuffer& buffer, std::size_t first_baseline,
+                        std::size_t end_baseline) override;
+
   /// Finish the processing of this step and subsequent steps.
   void finish() override;
 
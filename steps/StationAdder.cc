@@ -27,6 +27,7 @@
 #include "../base/FlagCounter.h"
 
 #include <aocommon/logger.h>
+#include <aocommon/staticfor.h>
 
 using casacore::ArrayColumn;
 using casacore::MPosition;
@@ -187,7 +188,10 @@ void StationAdder::updateInfo(const DPInfo& infoIn) {
   // itsBufRows contains for each new baseline the rownrs in the DPBuffer
   // to be added for the new baseline. If rownr<0, the conjugate has to be
   // added (1 is added to rownr, otherwise 0 is ambiguous).
-  // Note that a rownr can be the rownr of a new baseline.
+  // Note that a rownr can be the rownr of a new baseline of an earlier
+  // superstation. itsSuperStationEnds keeps where the new baselines of each
+  // superstation end, so process() can form them in that order.
+  itsSuperStationEnds.clear();
   for (unsigned int j = 0; j < itsParts.size(); ++j) {
     std::fill(newbl.begin(), newbl.end(), -1);
     std::vector<int> newAnt1;
@@ -240,6 +244,7 @@ void StationAdder::updateInfo(const DPInfo& infoIn) {
         ant2[oldsz + i] = newAnt2[i];
       }
     }
+    itsSuperStationEnds.push_back(itsBufRows.size());
   }
   // Set the new info.
   info().setAntennas(antennaNames, antennaDiam, antennaPos, ant1, ant2);
@@ -274,184 +279,203 @@ void StationAdder::showTimings(std::ostream& os, double duration) const {
   os << " StationAdder " << itsName << '\n';
 }
 
+namespace {
+/// Enlarges the first (baseline) axis of a tensor, keeping the existing
+/// baselines at the start. Since baselines are the outermost axis, the
+/// existing elements keep their positions, so they are copied once into the
+/// enlarged storage, which then replaces the original storage.
+template <typename Tensor, std::size_t N>
+void AppendBaselines(Tensor& tensor, const std::array<std::size_t, N>& shape) {
+  Tensor enlarged(shape);
+  std::copy_n(tensor.data(), tensor.size(), enlarged.data());
+  tensor = std::move(enlarged);
+}
+}  // namespace
+
 bool StationAdder::process(std::unique_ptr<base::DPBuffer> buffer) {
   itsTimer.start();
 
-  // Resize of data buffers can be destructive, therefore we must:
-  // 1. Store the data locally.
-  // TODO(AST-1330): Avoid copying the data, e.g., using 'swap'.
-  const xt::xtensor<std::complex<float>, 3> input_data = buffer->GetData();
-  const xt::xtensor<bool, 3> input_flags = buffer->GetFlags();
-  const xt::xtensor<float, 3> input_weights = buffer->GetWeights();
-  const xt::xtensor<double, 2> input_uvws = buffer->GetUvw();
-  // 2. Resize the buffer to the new sizes that were set in our info object
+  const unsigned int nrOldBL = buffer->GetData().shape(0);
+  // Make room for the new baselines after the existing ones.
   const std::array<std::size_t, 3> new_shape{
       getInfo().nbaselines(), getInfo().nchan(), getInfo().ncorr()};
-  buffer->GetData().resize(new_shape);
-  buffer->GetFlags().resize(new_shape);
-  buffer->GetWeights().resize(new_shape);
-  buffer->GetUvw().resize({getInfo().nbaselines(), 3});
-  // 3. Copy the data back into the resized buffer; only the existing baselines
-  // at the start will be filled the additional new baselines at the end will be
-  // empty.
-  std::copy_n(input_data.data(), input_data.size(), buffer->GetData().data());
-  std::copy_n(input_flags.data(), input_flags.size(),
-              buffer->GetFlags().data());
-  std::copy_n(input_weights.data(), input_weights.size(),
-              buffer->GetWeights().data());
-  std::copy_n(input_uvws.data(), input_uvws.size(), buffer->GetUvw().data());
+  AppendBaselines(buffer->GetData(), new_shape);
+  AppendBaselines(buffer->GetFlags(), new_shape);
+  AppendBaselines(buffer->GetWeights(), new_shape);
+  AppendBaselines(buffer->GetUvw(),
+                  std::array<std::size_t, 2>{getInfo().nbaselines(), 3});
 
-  // Now calculate the data pointers of the new baselines.
-  unsigned int nrOldBL = input_data.shape()[0];
-  unsigned int nrcc = input_data.shape()[2] * input_data.shape()[1];
-  std::complex<float>* dataPtr = buffer->GetData().data() + input_data.size();
-  bool* flagPtr = buffer->GetFlags().data() + input_data.size();
-  float* wghtPtr = buffer->GetWeights().data() + input_data.size();
-  double* uvwPtr = buffer->GetUvw().data() + input_uvws.size();
-  std::vector<unsigned int> npoints(nrcc);
-  std::vector<std::complex<float>> dataFlg(nrcc);
-  std::vector<float> wghtFlg(nrcc);
-  // Loop over all new baselines.
-  for (unsigned int i = 0; i < itsBufRows.size(); ++i) {
-    // Clear the data for the new baseline.
-    for (unsigned int k = 0; k < nrcc; ++k) {
-      dataPtr[k] = std::complex<float>();
-      wghtPtr[k] = 0.;
-      npoints[k] = 0;
-      dataFlg[k] = std::complex<float>();
-      wghtFlg[k] = 0.;
-    }
+  // The new baselines of a superstation read the existing baselines and the
+  // new baselines of earlier superstations (e.g. for a baseline between two
+  // superstations). Therefore the superstations are handled in order, and
+  // only the new baselines of a single superstation are formed in parallel.
+  std::size_t superStationStart = 0;
+  for (std::size_t superStationEnd : itsSuperStationEnds) {
+    formBaselines(*buffer, nrOldBL, superStationStart, superStationEnd);
+    superStationStart = superStationEnd;
+  }
+  itsTimer.stop();
+  getNextStep()->process(std::move(buffer));
+  return true;
+}
 
-    for (unsigned int k = 0; k < 3; ++k) {
-      uvwPtr[k] = 0.;
-    }
-    double uvwWghtSum = 0.;
+void StationAdder::formBaselines(base::DPBuffer& buffer, unsigned int nrOldBL,
+                                 std::size_t firstNew, std::size_t endNew) {
+  const unsigned int nrcc =
+      buffer.GetData().shape(1) * buffer.GetData().shape(2);
+  // The UVW calculator caches per time slot and is not thread-safe, so new
+  // baselines whose UVW has to be calculated are handled after the loop.
+  std::vector<char> calculateUvw(itsBufRows.size(), false);
 
-    // Sum the baselines forming the new baselines.
-    for (unsigned int j = 0; j < itsBufRows[i].size(); ++j) {
-      // Get the baseline number to use.
-      // A negative one means using the conjugate.
-      int blnr = itsBufRows[i][j];
-      bool useConj = false;
-      if (blnr < 0) {
-        blnr = -blnr;
-        useConj = true;
+  aocommon::StaticFor<std::size_t> loop;
+  loop.Run(firstNew, endNew, [&](std::size_t start, std::size_t end) {
+    std::vector<unsigned int> npoints(nrcc);
+    std::vector<std::complex<float>> dataFlg(nrcc);
+    std::vector<float> wghtFlg(nrcc);
+    for (std::size_t i = start; i < end; ++i) {
+      std::complex<float>* dataPtr = &buffer.GetData()(nrOldBL + i, 0, 0);
+      bool* flagPtr = &buffer.GetFlags()(nrOldBL + i, 0, 0);
+      float* wghtPtr = &buffer.GetWeights()(nrOldBL + i, 0, 0);
+      double* uvwPtr = &buffer.GetUvw()(nrOldBL + i, 0);
+      // Clear the data for the new baseline.
+      for (unsigned int k = 0; k < nrcc; ++k) {
+        dataPtr[k] = std::complex<float>();
+        wghtPtr[k] = 0.;
+        npoints[k] = 0;
+        dataFlg[k] = std::complex<float>();
+        wghtFlg[k] = 0.;
       }
-      blnr--;  // decrement because blnr+1 is stored in itsBufRows
-      // Get pointers to the input baseline data.
-      const std::complex<float>* inDataPtr = &buffer->GetData()(blnr, 0, 0);
-      const bool* inFlagPtr = &buffer->GetFlags()(blnr, 0, 0);
-      const float* inWghtPtr = &buffer->GetWeights()(blnr, 0, 0);
-      const double* inUvwPtr = &buffer->GetUvw()(blnr, 0);
 
-      // Add the data, uvw, and weights if not flagged.
-      // Write 4 loops to avoid having to test inside the loop.
-      // Count the flagged points separately, so it can be used
-      // if too many points are flagged.
-      if (useConj) {
-        if (itsUseWeight) {
-          for (unsigned int k = 0; k < nrcc; ++k) {
-            if (inFlagPtr[k]) {
-              dataFlg[k] += conj(inDataPtr[k]) * inWghtPtr[k];
-              wghtFlg[k] += inWghtPtr[k];
-            } else {
-              npoints[k]++;
-              dataPtr[k] += conj(inDataPtr[k]) * inWghtPtr[k];
-              wghtPtr[k] += inWghtPtr[k];
-              for (int ui = 0; ui < 3; ++ui) {
-                uvwPtr[ui] -= inUvwPtr[ui] * inWghtPtr[k];
+      for (unsigned int k = 0; k < 3; ++k) {
+        uvwPtr[k] = 0.;
+      }
+      double uvwWghtSum = 0.;
+
+      // Sum the baselines forming the new baselines.
+      for (unsigned int j = 0; j < itsBufRows[i].size(); ++j) {
+        // Get the baseline number to use.
+        // A negative one means using the conjugate.
+        int blnr = itsBufRows[i][j];
+        bool useConj = false;
+        if (blnr < 0) {
+          blnr = -blnr;
+          useConj = true;
+        }
+        blnr--;  // decrement because blnr+1 is stored in itsBufRows
+        // Get pointers to the input baseline data.
+        const std::complex<float>* inDataPtr = &buffer.GetData()(blnr, 0, 0);
+        const bool* inFlagPtr = &buffer.GetFlags()(blnr, 0, 0);
+        const float* inWghtPtr = &buffer.GetWeights()(blnr, 0, 0);
+        const double* inUvwPtr = &buffer.GetUvw()(blnr, 0);
+
+        // Add the data, uvw, and weights if not flagged.
+        // Write 4 loops to avoid having to test inside the loop.
+        // Count the flagged points separately, so it can be used
+        // if too many points are flagged.
+        if (useConj) {
+          if (itsUseWeight) {
+            for (unsigned int k = 0; k < nrcc; ++k) {
+              if (inFlagPtr[k]) {
+                dataFlg[k] += conj(inDataPtr[k]) * inWghtPtr[k];
+                wghtFlg[k] += inWghtPtr[k];
+              } else {
+                npoints[k]++;
+                dataPtr[k] += conj(inDataPtr[k]) * inWghtPtr[k];
+                wghtPtr[k] += inWghtPtr[k];
+                for (int ui = 0; ui < 3; ++ui) {
+                  uvwPtr[ui] -= inUvwPtr[ui] * inWghtPtr[k];
+                }
+                uvwWghtSum += inWghtPtr[k];
               }
-              uvwWghtSum += inWghtPtr[k];
             }
-          }
-        } else {
-          for (unsigned int k = 0; k < nrcc; ++k) {
-            if (inFlagPtr[k]) {
-              dataFlg[k] += conj(inDataPtr[k]);
-              wghtFlg[k] += 1.;
-            } else {
-              npoints[k]++;
-              dataPtr[k] += conj(inDataPtr[k]);
-              wghtPtr[k] += 1.;
-              for (int ui = 0; ui < 3; ++ui) {
-                uvwPtr[ui] -= inUvwPtr[ui];
+          } else {
+            for (unsigned int k = 0; k < nrcc; ++k) {
+              if (inFlagPtr[k]) {
+                dataFlg[k] += conj(inDataPtr[k]);
+                wghtFlg[k] += 1.;
+              } else {
+                npoints[k]++;
+                dataPtr[k] += conj(inDataPtr[k]);
+                wghtPtr[k] += 1.;
+                for (int ui = 0; ui < 3; ++ui) {
+                  uvwPtr[ui] -= inUvwPtr[ui];
+                }
+                uvwWghtSum += 1;
               }
-              uvwWghtSum += 1;
             }
           }
-        }
-      } else {
-        if (itsUseWeight) {
-          for (unsigned int k = 0; k < nrcc; ++k) {
-            if (inFlagPtr[k]) {
-              dataFlg[k] += inDataPtr[k] * inWghtPtr[k];
-              wghtFlg[k] += inWghtPtr[k];
-            } else {
-              npoints[k]++;
-              dataPtr[k] += inDataPtr[k] * inWghtPtr[k];
-              wghtPtr[k] += inWghtPtr[k];
-              for (int ui = 0; ui < 3; ++ui) {
-                uvwPtr[ui] += inUvwPtr[ui] * inWghtPtr[k];
+        } else {
+          if (itsUseWeight) {
+            for (unsigned int k = 0; k < nrcc; ++k) {
+              if (inFlagPtr[k]) {
+                dataFlg[k] += inDataPtr[k] * inWghtPtr[k];
+                wghtFlg[k] += inWghtPtr[k];
+              } else {
+                npoints[k]++;
+                dataPtr[k] += inDataPtr[k] * inWghtPtr[k];
+                wghtPtr[k] += inWghtPtr[k];
+                for (int ui = 0; ui < 3; ++ui) {
+                  uvwPtr[ui] += inUvwPtr[ui] * inWghtPtr[k];
+                }
+                uvwWghtSum += inWghtPtr[k];
               }
-              uvwWghtSum += inWghtPtr[k];
             }
-          }
-        } else {
-          for (unsigned int k = 0; k < nrcc; ++k) {
-            if (inFlagPtr[k]) {
-              dataFlg[k] += inDataPtr[k];
-              wghtFlg[k] += 1.;
-            } else {
-              npoints[k]++;
-              dataPtr[k] += inDataPtr[k];
-              wghtPtr[k] += 1.;
-              for (int ui = 0; ui < 3; ++ui) {
-                uvwPtr[ui] += inUvwPtr[ui];
+          } else {
+            for (unsigned int k = 0; k < nrcc; ++k) {
+              if (inFlagPtr[k]) {
+                dataFlg[k] += inDataPtr[k];
+                wghtFlg[k] += 1.;
+              } else {
+                npoints[k]++;
+                dataPtr[k] += inDataPtr[k];
+                wghtPtr[k] += 1.;
+                for (int ui = 0; ui < 3; ++ui) {
+                  uvwPtr[ui] += inUvwPtr[ui];
+                }
+                uvwWghtSum += 1;
               }
-              uvwWghtSum += 1;
             }
           }
         }
       }
-    }
-    // Set the resulting flags. Average if needed.
-    // Set flag if too few unflagged data points; use flagged data too.
-    for (unsigned int k = 0; k < nrcc; ++k) {
-      if (wghtPtr[k] == 0 || npoints[k] < itsMinNPoint) {
-        flagPtr[k] = true;
-        dataPtr[k] += dataFlg[k];
-        wghtPtr[k] += wghtFlg[k];
-      } else {
-        flagPtr[k] = false;
+      // Set the resulting flags. Average if needed.
+      // Set flag if too few unflagged data points; use flagged data too.
+      for (unsigned int k = 0; k < nrcc; ++k) {
+        if (wghtPtr[k] == 0 || npoints[k] < itsMinNPoint) {
+          flagPtr[k] = true;
+          dataPtr[k] += dataFlg[k];
+          wghtPtr[k] += wghtFlg[k];
+        } else {
+          flagPtr[k] = false;
+        }
+        if (itsDoAverage) {
+          dataPtr[k] /= wghtPtr[k];
+        }
       }
-      if (itsDoAverage) {
-        dataPtr[k] /= wghtPtr[k];
+
+      // Average or calculate the UVW coordinate of the new station.
+      if (itsDoAverage && uvwWghtSum != 0) {
+        for (int ui = 0; ui < 3; ++ui) {
+          uvwPtr[ui] /= uvwWghtSum;
+        }
+      } else {
+        calculateUvw[i] = true;
       }
     }
+  });
 
-    // Average or calculate the UVW coordinate of the new station.
-    if (itsDoAverage && uvwWghtSum != 0) {
-      for (int ui = 0; ui < 3; ++ui) {
-        uvwPtr[ui] /= uvwWghtSum;
-      }
-    } else {
+  // Calculate the UVWs before later superstations read them.
+  for (std::size_t i = firstNew; i < endNew; ++i) {
+    if (calculateUvw[i]) {
       unsigned int blnr = nrOldBL + i;
       const std::array<double, 3> uvws =
           itsUVWCalc->getUVW(getInfo().getAnt1()[blnr],
-                             getInfo().getAnt2()[blnr], buffer->GetTime());
-      uvwPtr[0] = uvws[0];
-      uvwPtr[1] = uvws[1];
-      uvwPtr[2] = uvws[2];
+                             getInfo().getAnt2()[blnr], buffer.GetTime());
+      buffer.GetUvw()(blnr, 0) = uvws[0];
+      buffer.GetUvw()(blnr, 1) = uvws[1];
+      buffer.GetUvw()(blnr, 2) = uvws[2];
     }
-
-    dataPtr += nrcc;
-    flagPtr += nrcc;
-    wghtPtr += nrcc;
-    uvwPtr += 3;
   }
-  itsTimer.stop();
-  getNextStep()->process(std::move(buffer));
-  return true;
 }
 
 void StationAdder::finish() {
@@ -89,6 +89,12 @@ class StationAdder : public Step {
       const std::vector<string>& patterns);
 
  private:
+  /// Form the new baselines [firstNew, endNew) (indices in itsBufRows) in
+  /// parallel, after the existing baselines (nrOldBL) in the buffer. They
+  /// may only read existing baselines and new baselines before firstNew.
+  void formBaselines(base::DPBuffer& buffer, unsigned int nrOldBL,
+                     std::size_t firstNew, std::size_t endNew);
+
   /// Update the beam info subtables.
   void updateBeamInfo(const string& msName, unsigned int origNant,
                       casacore::Table& antTab);
@@ -99,6 +105,8 @@ class StationAdder : public Step {
       itsParts;  ///< the stations in each superstation
   std::vector<std::vector<int>>
       itsBufRows;             ///< old baseline rows in each new baseline
+  /// End index in itsBufRows of the new baselines of each superstation.
+  std::vector<std::size_t> itsSuperStationEnds;
   unsigned int itsMinNPoint;  ///< flag data if too few unflagged data
   bool itsMakeAutoCorr;       ///< also form new auto-correlations?
   bool itsSumAutoCorr;        ///< sum auto- or cross-correlations?
@@ -229,3 +229,54 @@ def test_filter():
             "gaincal.caltype=diagonal",
         ]
     )
+
+
+@pytest.mark.parametrize("caltype", ["diagonal", "scalarphase"])
+def test_parallel_solution_intervals(caltype):
+    """
+    Solving several solution intervals concurrently gives the same solutions
+    as solving them one by one. The 6 time slots are solved in 6 intervals,
+    with 4 parallel intervals, so the last parallel batch is incomplete.
+    Solutions are not propagated, since that depends on the solution
+    interval that was solved 'parallelsolints' intervals earlier.
+    """
+    for parallel_solints in [1, 4]:
+        check_call(
+            [
+                tcf.DP3EXE,
+                "checkparset=1",
+                f"msin={MSIN}",
+                "msout=",
+                "steps=[gaincal]",
+                f"gaincal.sourcedb={MSIN}/sky",
+                f"gaincal.parmdb=parallel{parallel_solints}.h5",
+                "gaincal.usebeammodel=false",
+                f"gaincal.caltype={caltype}",
+                "gaincal.propagatesolutions=false",
+                "gaincal.solint=1",
+                f"gaincal.parallelsolints={parallel_solints}",
+            ]
+        )
+
+    import h5py  # Don't import h5py when pytest is only collecting tests.
+    import numpy as np
+
+    with h5py.File("parallel1.h5", "r") as serial, h5py.File(
+        "parallel4.h5", "r"
+    ) as parallel:
+        soltabs = [
+            f"{solset}/{soltab}"
+            for solset in serial
+            for soltab in serial[solset]
+            if "val" in serial[solset][soltab]
+        ]
+        assert soltabs
+        for soltab in soltabs:
+            assert serial[soltab]["time"].shape[0] == 6
+            for name in ["time", "val", "weight"]:
+                np.testing.assert_allclose(
+                    parallel[soltab][name][()],
+                    serial[soltab][name][()],
+                    rtol=1e-6,
+                    atol=1e-6,
+                )
@@ -1,6 +1,7 @@
 # Copyright (C) 2023 ASTRON (Netherlands Institute for Radio Astronomy)
 # SPDX-License-Identifier: GPL-3.0-or-later
 
+import ctypes.util
 import pytest
 import os
 import re
@@ -12,7 +13,13 @@ import sys
 sys.path.append(".")
 
 import testconfig as tcf
-from utils import check_output, get_taql_result, run_in_tmp_path, untar
+from utils import (
+    assert_taql,
+    check_output,
+    get_taql_result,
+    run_in_tmp_path,
+    untar,
+)
 
 MSIN = "tNDPPP-generic.MS"
 
@@ -115,3 +122,57 @@ def test_write_thread_disabled():
         b"(1[0-9]| [ 0-9])[0-9]\\.[0-9]% \\([ 0-9]{5} [m ]s\\) Writing\n",
         result,
     )
+
+
+@pytest.mark.skipif(
+    ctypes.util.find_library("dysco") is None,
+    reason="The Dysco storage manager is not available",
+)
+def test_dysco_queue_size():
+    """Assert that FLAG_ROW and the Dysco preparation of flagged samples do
+    not depend on the size of the write queue."""
+
+    def run(msout, extra_args):
+        check_call(
+            [
+                tcf.DP3EXE,
+                f"msin={MSIN}",
+                f"msout={msout}",
+                "steps=[preflag1,preflag2]",
+                # Flags complete rows, which sets FLAG_ROW.
+                "preflag1.baseline=CS*&",
+                # Flags a part of the other rows.
+                "preflag2.chan=[0]",
+            ]
+            + extra_args
+        )
+
+    run("reference.MS", [])
+    for queue_size in [1, 7]:
+        run(
+            f"dysco{queue_size}.MS",
+            ["msout.storagemanager=dysco", f"msout.queuesize={queue_size}"],
+        )
+
+    assert_taql("select from reference.MS where FLAG_ROW limit 1", 1)
+    for queue_size in [1, 7]:
+        ms = f"dysco{queue_size}.MS"
+        assert_taql(f"select from {ms} where FLAG_ROW != all(FLAG)")
+        assert_taql(
+            f"select from {ms} where "
+            "not all(!FLAG || (isnan(DATA) && WEIGHT_SPECTRUM == 0))"
+        )
+        assert_taql(
+            f"select from reference.MS t1, {ms} t2 where "
+            "t1.FLAG_ROW != t2.FLAG_ROW || not all(t1.FLAG == t2.FLAG)"
+        )
+
+    # The compression is deterministic, so the queue size may not change the
+    # output.
+    assert_taql(
+        "select from dysco1.MS t1, dysco7.MS t2 where "
+        "t1.TIME != t2.TIME || t1.INTERVAL != t2.INTERVAL || "
+        "t1.EXPOSURE != t2.EXPOSURE || "
+        "not all(t1.WEIGHT_SPECTRUM == t2.WEIGHT_SPECTRUM) || "
+        "not all(t1.DATA == t2.DATA || (isnan(t1.DATA) && isnan(t2.DATA)))"
+    )
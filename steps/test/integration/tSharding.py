@@ -0,0 +1,96 @@
+# Copyright (C) 2023 ASTRON (Netherlands Institute for Radio Astronomy)
+# SPDX-License-Identifier: GPL-3.0-or-later
+
+import pytest
+from subprocess import check_call
+import numpy as np
+
+# Append current directory to system path in order to import testconfig
+import sys
+
+sys.path.append(".")
+
+import testconfig as tcf
+from utils import assert_taql, get_taql_result, run_in_tmp_path, untar
+
+"""
+Tests for running a pipeline in several shards (shards=N).
+
+Script can be invoked in two ways:
+- as standalone from the build/steps/test/integration directory,
+  using `pytest source/tSharding.py` (extended with pytest options of your choice)
+- using ctest, see DP3/steps/test/integration/CMakeLists.txt
+"""
+
+MSIN = "tDDECal.MS"
+
+
+@pytest.fixture(autouse=True)
+def source_env(run_in_tmp_path):
+    untar(f"{tcf.RESOURCEDIR}/tDDECal.in_MS.tgz")
+    check_call([tcf.MAKESOURCEDBEXE, f"in={MSIN}/sky.txt", f"out={MSIN}/sky"])
+
+
+def run_pipeline(n_shards, msout, h5parm):
+    check_call(
+        [
+            tcf.DP3EXE,
+            "numthreads=1",
+            f"shards={n_shards}",
+            f"msin={MSIN}",
+            f"msout={msout}",
+            "steps=[average,ddecal]",
+            "average.timestep=2",
+            "average.freqstep=2",
+            f"ddecal.sourcedb={MSIN}/sky",
+            "ddecal.directions=[[center,dec_off],[ra_off],[radec_off]]",
+            "ddecal.mode=scalarphase",
+            "ddecal.solint=1",
+            f"ddecal.h5parm={h5parm}",
+        ]
+    )
+
+
+def test_merged_output_equals_unsharded_output():
+    run_pipeline(1, "unsharded.MS", "unsharded.h5")
+    run_pipeline(3, "sharded.MS", "sharded.h5")
+
+    # The merged MS has the rows of all shards, in the order of the shards.
+    assert get_taql_result("select nrows() from sharded.MS") == get_taql_result(
+        "select nrows() from unsharded.MS"
+    )
+    assert_taql(
+        "select from unsharded.MS t1, sharded.MS t2 where "
+        "t1.TIME != t2.TIME || t1.ANTENNA1 != t2.ANTENNA1 || "
+        "t1.ANTENNA2 != t2.ANTENNA2 || t1.FLAG_ROW != t2.FLAG_ROW || "
+        "not all(near(t1.UVW, t2.UVW, 1e-9)) || "
+        "not all(t1.FLAG == t2.FLAG) || "
+        "not all(near(t1.WEIGHT_SPECTRUM, t2.WEIGHT_SPECTRUM, 1e-6)) || "
+        "not all(near(t1.DATA, t2.DATA, 1e-6) || "
+        "(isnan(t1.DATA) && isnan(t2.DATA)))"
+    )
+    assert_taql(
+        "select from unsharded.MS/OBSERVATION t1, sharded.MS/OBSERVATION t2 "
+        "where not all(near(t1.TIME_RANGE, t2.TIME_RANGE, 1e-9))"
+    )
+
+    import h5py  # Don't import h5py when pytest is only collecting tests.
+
+    with h5py.File("unsharded.h5", "r") as unsharded, h5py.File(
+        "sharded.h5", "r"
+    ) as sharded:
+        soltabs = [
+            f"{solset}/{soltab}"
+            for solset in unsharded
+            for soltab in unsharded[solset]
+            if "val" in unsharded[solset][soltab]
+        ]
+        assert soltabs
+        for soltab in soltabs:
+            for name in ["time", "val", "weight"]:
+                expected = unsharded[soltab][name]
+                merged = sharded[soltab][name]
+                assert merged.shape == expected.shape
+                np.testing.assert_allclose(
+                    merged[()], expected[()], rtol=1e-6, atol=1e-6
+                )
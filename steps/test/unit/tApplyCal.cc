@@ -17,17 +17,28 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <schaapcommon/h5parm/h5parm.h>
+#include <schaapcommon/h5parm/soltab.h>
+
+#include <filesystem>
+
 #include "tStepCommon.h"
+#include "mock/MockStep.h"
 #include "mock/ThrowStep.h"
+#include "../../OneApplyCal.h"
+#include <dp3/base/BDABuffer.h>
 #include <dp3/base/DPBuffer.h>
 #include <dp3/base/DPInfo.h>
 #include "../../../common/ParameterSet.h"
 #include "../../../common/StringTools.h"
 #include "../../../common/StreamUtil.h"
 
+using dp3::base::BDABuffer;
 using dp3::base::DPBuffer;
 using dp3::base::DPInfo;
 using dp3::steps::ApplyCal;
+using dp3::steps::MockStep;
+using dp3::steps::OneApplyCal;
 using dp3::steps::Step;
 
 namespace {
@@ -279,4 +290,191 @@ BOOST_AUTO_TEST_CASE(test_gain) {
   dp3::steps::test::Execute({input, apply_cal, output});
 }
 
+// Create an info object for the BDA test, with three antennas and three
+// baselines. The channels are given per baseline, or for all baselines when
+// @p freqs has a single element.
+DPInfo MakeBdaTestInfo(std::vector<std::vector<double>> freqs) {
+  DPInfo info(kNCorrelations, freqs.front().size());
+  info.setTimes(5.0, 15.0, 10.0);
+  info.setAntennas({"ant1", "ant2", "ant3"}, std::vector<double>(3, 70.0),
+                   std::vector<casacore::MPosition>(3), {0, 0, 1}, {1, 2, 2});
+  std::vector<std::vector<double>> widths;
+  for (const std::vector<double>& baseline_freqs : freqs) {
+    widths.emplace_back(baseline_freqs.size(),
+                        baseline_freqs.size() > 1
+                            ? baseline_freqs[1] - baseline_freqs[0]
+                            : 1.0e7);
+  }
+  if (freqs.size() == 1) {
+    info.setChannels(std::move(freqs.front()), std::move(widths.front()));
+  } else {
+    info.setChannels(std::move(freqs), std::move(widths));
+  }
+  return info;
+}
+
+std::complex<float> BdaTestData(size_t time, size_t baseline, size_t channel,
+                                size_t correlation) {
+  return {1.0f + time + 0.1f * baseline, 0.5f * channel - 0.2f * correlation};
+}
+
+float BdaTestWeight(size_t channel, size_t correlation) {
+  return 1.0f + (channel + correlation) % 3;
+}
+
+bool BdaTestFlag(size_t time, size_t channel, size_t correlation) {
+  return time == 0 && channel == 1 && correlation == 0;
+}
+
+// Applying H5Parm solutions to a BDABuffer should give the same result as
+// applying them to regular buffers with the same channels.
+BOOST_AUTO_TEST_CASE(bda_same_as_regular) {
+  const std::string kH5Parm = "tApplyCal_bda_tmp.h5";
+  const size_t kNBdaTimes = 2;
+  const size_t kNBdaBaselines = 3;
+  const std::vector<double> full_freqs{1.0e8, 1.1e8, 1.2e8, 1.3e8};
+  const std::vector<double> averaged_freqs{1.05e8, 1.25e8};
+  // Baselines 0 and 1 have full resolution channels. Baseline 2 has averaged
+  // channels, so the solutions are gridded for two channel layouts.
+  const std::vector<std::vector<double>> bda_freqs{full_freqs, full_freqs,
+                                                   averaged_freqs};
+
+  {
+    const std::vector<std::string> names{"ant1", "ant2", "ant3"};
+    schaapcommon::h5parm::H5Parm h5parm(kH5Parm, true);
+    h5parm.AddAntennas(names, std::vector<std::array<double, 3>>(
+                                  3, std::array<double, 3>{42.0}));
+    for (const std::string type : {"amplitude", "phase"}) {
+      schaapcommon::h5parm::SolTab soltab = h5parm.CreateSolTab(
+          "my" + type, type, {{"ant", 3}, {"time", 2}, {"freq", 4}});
+      soltab.SetAntennas(names);
+      soltab.SetTimes({5.0, 15.0});
+      soltab.SetFreqs(full_freqs);
+      std::vector<double> values;
+      std::vector<double> weights;
+      for (size_t ant = 0; ant < 3; ++ant) {
+        for (size_t t = 0; t < 2; ++t) {
+          for (size_t f = 0; f < 4; ++f) {
+            values.push_back(type == "amplitude"
+                                 ? 1.0 + 0.1 * ant + 0.2 * t + 0.05 * f
+                                 : 0.3 * ant - 0.1 * t + 0.2 * f);
+            // This solution flags the last channel of baseline 1 at time 1.
+            const bool flagged =
+                type == "amplitude" && ant == 2 && t == 1 && f == 3;
+            weights.push_back(flagged ? 0.0 : 1.0);
+          }
+        }
+      }
+      soltab.SetValues(values, weights, "CREATE with DP3 tApplyCal");
+    }
+  }
+
+  dp3::common::ParameterSet parset;
+  parset.add("amplitude.parmdb", kH5Parm);
+  parset.add("amplitude.correction", "myamplitude");
+  parset.add("amplitude.updateweights", "true");
+  parset.add("phase.parmdb", kH5Parm);
+  parset.add("phase.correction", "myphase");
+
+  auto make_steps = [&](Step::MsType type, const DPInfo& info) {
+    auto amplitude = std::make_shared<OneApplyCal>(
+        parset, "amplitude.", "amplitude.", false, "", type);
+    auto phase = std::make_shared<OneApplyCal>(parset, "phase.", "phase.",
+                                               false, "", type);
+    auto result = std::make_shared<MockStep>();
+    amplitude->setNextStep(phase);
+    phase->setNextStep(result);
+    amplitude->updateInfo(info);
+    phase->updateInfo(info);
+    return std::make_pair(amplitude, result);
+  };
+
+  // Apply the solutions to regular buffers, once with the full resolution
+  // channels and once with the averaged channels.
+  auto run_regular = [&](const std::vector<double>& freqs) {
+    auto [first_step, result] =
+        make_steps(Step::MsType::kRegular, MakeBdaTestInfo({freqs}));
+    for (size_t t = 0; t < kNBdaTimes; ++t) {
+      auto buffer = std::make_unique<DPBuffer>(5.0 + t * 10.0, 10.0);
+      const std::array<size_t, 3> shape{kNBdaBaselines, freqs.size(),
+                                        kNCorrelations};
+      buffer->GetData().resize(shape);
+      buffer->GetWeights().resize(shape);
+      buffer->GetFlags().resize(shape);
+      for (size_t bl = 0; bl < kNBdaBaselines; ++bl) {
+        for (size_t ch = 0; ch < freqs.size(); ++ch) {
+          for (size_t cr = 0; cr < kNCorrelations; ++cr) {
+            buffer->GetData()(bl, ch, cr) = BdaTestData(t, bl, ch, cr);
+            buffer->GetWeights()(bl, ch, cr) = BdaTestWeight(ch, cr);
+            buffer->GetFlags()(bl, ch, cr) = BdaTestFlag(t, ch, cr);
+          }
+        }
+      }
+      first_step->process(std::move(buffer));
+    }
+    BOOST_REQUIRE_EQUAL(result->GetRegularBuffers().size(), kNBdaTimes);
+    return result;
+  };
+  const std::shared_ptr<MockStep> full_result = run_regular(full_freqs);
+  const std::shared_ptr<MockStep> averaged_result = run_regular(averaged_freqs);
+
+  auto [bda_step, bda_result] =
+      make_steps(Step::MsType::kBda, MakeBdaTestInfo(bda_freqs));
+  auto bda_buffer = std::make_unique<BDABuffer>(
+      kNBdaTimes * (2 * full_freqs.size() + averaged_freqs.size()) *
+      kNCorrelations);
+  for (size_t t = 0; t < kNBdaTimes; ++t) {
+    for (size_t bl = 0; bl < kNBdaBaselines; ++bl) {
+      const size_t n_channels = bda_freqs[bl].size();
+      std::vector<std::complex<float>> data;
+      std::vector<float> weights;
+      std::unique_ptr<bool[]> flags(new bool[n_channels * kNCorrelations]);
+      for (size_t ch = 0; ch < n_channels; ++ch) {
+        for (size_t cr = 0; cr < kNCorrelations; ++cr) {
+          data.push_back(BdaTestData(t, bl, ch, cr));
+          weights.push_back(BdaTestWeight(ch, cr));
+          flags[ch * kNCorrelations + cr] = BdaTestFlag(t, ch, cr);
+        }
+      }
+      const std::array<double, 3> uvw{0.0, 0.0, 0.0};
+      BOOST_REQUIRE(bda_buffer->AddRow(5.0 + t * 10.0, 10.0, 10.0, bl,
+                                       n_channels, kNCorrelations, data.data(),
+                                       flags.get(), weights.data(), nullptr,
+                                       uvw.data()));
+    }
+  }
+  bda_step->process(std::move(bda_buffer));
+
+  BOOST_REQUIRE_EQUAL(bda_result->GetBdaBuffers().size(), 1u);
+  const BDABuffer& result = *bda_result->GetBdaBuffers().front();
+  BOOST_REQUIRE_EQUAL(result.GetRows().size(), kNBdaTimes * kNBdaBaselines);
+  for (size_t row = 0; row < result.GetRows().size(); ++row) {
+    const size_t t = row / kNBdaBaselines;
+    const size_t bl = row % kNBdaBaselines;
+    const DPBuffer& regular =
+        *(bl < 2 ? full_result : averaged_result)->GetRegularBuffers()[t];
+    BOOST_REQUIRE_EQUAL(result.GetRows()[row].n_channels,
+                        regular.GetData().shape(1));
+    for (size_t ch = 0; ch < regular.GetData().shape(1); ++ch) {
+      for (size_t cr = 0; cr < kNCorrelations; ++cr) {
+        const size_t index = ch * kNCorrelations + cr;
+        BOOST_CHECK_EQUAL(result.GetFlags(row)[index],
+                          regular.GetFlags()(bl, ch, cr));
+        BOOST_CHECK_CLOSE(result.GetWeights(row)[index],
+                          regular.GetWeights()(bl, ch, cr), 1.0e-4);
+        const std::complex<float> difference =
+            result.GetData(row)[index] - regular.GetData()(bl, ch, cr);
+        BOOST_CHECK_SMALL(std::abs(difference), 1.0e-5f);
+      }
+    }
+  }
+  // The solutions changed the data and flagged channel 3 of baseline 1 at
+  // time 1.
+  BOOST_CHECK(std::abs(result.GetData(0)[0] - BdaTestData(0, 0, 0, 0)) >
+              1.0e-3f);
+  BOOST_CHECK(result.GetFlags(kNBdaBaselines + 1)[3 * kNCorrelations]);
+
+  std::filesystem::remove(kH5Parm);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -283,7 +283,8 @@ class TestOutput : public dp3::steps::test::ThrowStep {
 };
 
 // Test amplitude correction
-void testampl(int ntime, int nchan, bool freqaxis, bool timeaxis) {
+void testampl(int ntime, int nchan, bool freqaxis, bool timeaxis,
+              bool prefetch = false) {
   // Create the steps.
   TestInput* in = new TestInput(ntime, nchan);
   Step::ShPtr step1(in);
@@ -291,6 +292,11 @@ void testampl(int ntime, int nchan, bool freqaxis, bool timeaxis) {
   ParameterSet parset1;
   parset1.add("correction", "myampl");
   parset1.add("parmdb", "tApplyCalH5_tmp.h5");
+  if (prefetch) {
+    // Use multiple chunks, such that the solutions are prefetched.
+    parset1.add("timeslotsperparmupdate", "2");
+    parset1.add("prefetch", "true");
+  }
   auto step2 = std::make_shared<ApplyCal>(parset1, "");
 
   Step::ShPtr step3(new TestOutput(ntime, nchan, TestOutput::WeightsNotChanged,
@@ -413,6 +419,14 @@ BOOST_AUTO_TEST_CASE(testampl5) {
   testampl(9, 2, false, false);
 }
 
+BOOST_AUTO_TEST_CASE(testampl_prefetch) {
+  const std::vector<double> times{4472025742.0, 4472025745.0, 4472025747.5,
+                                  4472025748.0, 4472025762.0};
+  const std::vector<double> freqs{90.e6, 139.e6, 170.e6};
+  createH5Parm(times, freqs);
+  testampl(5, 7, true, true, true);
+}
+
 // Check an exception message starts with a given string
 bool checkMissingAntError(const std::exception& ex) {
   BOOST_CHECK_EQUAL(ex.what(),
@@ -19,13 +19,16 @@
 #include <boost/test/unit_test.hpp>
 
 #include "tStepCommon.h"
+#include "mock/MockStep.h"
 #include "mock/ThrowStep.h"
 #include "../../Averager.h"
+#include <dp3/base/BDABuffer.h>
 #include <dp3/base/DPBuffer.h>
 #include <dp3/base/DPInfo.h>
 #include "../../../common/ParameterSet.h"
 #include "../../../common/StringTools.h"
 
+using dp3::base::BDABuffer;
 using dp3::base::DPBuffer;
 using dp3::base::DPInfo;
 using dp3::common::ParameterSet;
@@ -543,6 +546,9 @@ BOOST_AUTO_TEST_CASE(testaverager11) { TestAveragingAndFlagging(1, 4, 3); }
 
 BOOST_AUTO_TEST_CASE(testaverager12) { TestAveragingAndFlagging(20, 4, 5); }
 
+// Three correlations use the generic kernel instead of a specialized one.
+BOOST_AUTO_TEST_CASE(testaverager13) { test1(10, 3, 30, 3, 3, 3, true); }
+
 BOOST_AUTO_TEST_CASE(testresolution1) {
   test1resolution(10, 3, 32, 4, 10., 100000, "Hz", false);
 }
@@ -555,4 +561,109 @@ BOOST_AUTO_TEST_CASE(testresolution3) {
   test1resolution(11, 3, 32, 4, 15., 0.4, "MHz", false);
 }
 
+BOOST_AUTO_TEST_CASE(bda_frequency_averaging) {
+  const std::size_t kNCorr = 2;
+  // Baseline 0 has 6 channels, baseline 1 was averaged to 3 channels.
+  DPInfo info(kNCorr, 6);
+  info.setTimes(0.0, 10.0, 10.0);
+  info.setAntennas({"a0", "a1"}, {70.0, 70.0},
+                   {casacore::MPosition(), casacore::MPosition()}, {0, 0},
+                   {0, 1});
+  std::vector<std::vector<double>> freqs{
+      {1.0e8, 1.1e8, 1.2e8, 1.3e8, 1.4e8, 1.5e8}, {1.05e8, 1.25e8, 1.45e8}};
+  std::vector<std::vector<double>> widths{std::vector<double>(6, 1.0e7),
+                                          std::vector<double>(3, 2.0e7)};
+  info.setChannels(std::move(freqs), std::move(widths));
+
+  ParameterSet parset;
+  parset.add("freqstep", "2");
+  auto averager =
+      std::make_shared<Averager>(parset, "", Step::MsType::kBda);
+  auto mock_step = std::make_shared<dp3::steps::MockStep>();
+  averager->setNextStep(mock_step);
+  BOOST_CHECK(averager->accepts(Step::MsType::kBda));
+  BOOST_CHECK(averager->outputs() == Step::MsType::kBda);
+  averager->updateInfo(info);
+
+  const DPInfo& info_out = averager->getInfoOut();
+  BOOST_REQUIRE_EQUAL(info_out.chanFreqs(0).size(), 3u);
+  BOOST_REQUIRE_EQUAL(info_out.chanFreqs(1).size(), 2u);
+  BOOST_CHECK_CLOSE(info_out.chanFreqs(0)[0], 1.05e8, 1.0e-6);
+  BOOST_CHECK_CLOSE(info_out.chanWidths(0)[2], 2.0e7, 1.0e-6);
+  // The second baseline has an uneven split: channel 0 and channels 1-2.
+  BOOST_CHECK_CLOSE(info_out.chanFreqs(1)[0], 1.05e8, 1.0e-6);
+  BOOST_CHECK_CLOSE(info_out.chanFreqs(1)[1], 1.35e8, 1.0e-6);
+  BOOST_CHECK_CLOSE(info_out.chanWidths(1)[1], 4.0e7, 1.0e-6);
+
+  std::vector<std::complex<float>> data(9 * kNCorr);
+  std::vector<float> weights(9 * kNCorr);
+  std::vector<bool> flags_vector(9 * kNCorr, false);
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    data[i] = std::complex<float>(i, -float(i));
+    weights[i] = 1.0f + i % 3;
+  }
+  // Flag the first correlation of the first channel of baseline 0.
+  flags_vector[0] = true;
+  std::unique_ptr<bool[]> flags(new bool[flags_vector.size()]);
+  std::copy(flags_vector.begin(), flags_vector.end(), flags.get());
+
+  const std::array<double, 3> uvw{1.0, 2.0, 3.0};
+  auto buffer = std::make_unique<BDABuffer>(data.size());
+  buffer->AddRow(5.0, 10.0, 10.0, 0, 6, kNCorr, data.data(), flags.get(),
+                 weights.data(), nullptr, uvw.data());
+  buffer->AddRow(5.0, 10.0, 10.0, 1, 3, kNCorr, data.data() + 6 * kNCorr,
+                 flags.get() + 6 * kNCorr, weights.data() + 6 * kNCorr,
+                 nullptr, uvw.data());
+  averager->process(std::move(buffer));
+
+  BOOST_REQUIRE_EQUAL(mock_step->GetBdaBuffers().size(), 1u);
+  const BDABuffer& result = *mock_step->GetBdaBuffers().front();
+  BOOST_REQUIRE_EQUAL(result.GetRows().size(), 2u);
+  BOOST_CHECK_EQUAL(result.GetRows()[0].n_channels, 3u);
+  BOOST_CHECK_EQUAL(result.GetRows()[1].n_channels, 2u);
+  BOOST_CHECK_EQUAL(result.GetRows()[1].uvw[2], 3.0);
+
+  // Compute the expected weighted averages.
+  auto expected = [&](std::size_t first, std::size_t n_chan, std::size_t corr,
+                      float& weight_sum) {
+    std::complex<float> sum;
+    weight_sum = 0.0f;
+    for (std::size_t ch = 0; ch < n_chan; ++ch) {
+      const std::size_t index = (first + ch) * kNCorr + corr;
+      if (!flags_vector[index]) {
+        sum += data[index] * weights[index];
+        weight_sum += weights[index];
+      }
+    }
+    return sum / weight_sum;
+  };
+  float weight = 0.0f;
+  // Baseline 0, channel 0, correlation 0 only has one unflagged input.
+  BOOST_CHECK_CLOSE(result.GetData(0)[0].real(),
+                    expected(0, 2, 0, weight).real(), 1.0e-4);
+  BOOST_CHECK_CLOSE(result.GetWeights(0)[0], weight, 1.0e-4);
+  BOOST_CHECK(!result.GetFlags(0)[0]);
+  BOOST_CHECK_CLOSE(result.GetData(0)[5].imag(),
+                    expected(4, 2, 1, weight).imag(), 1.0e-4);
+  BOOST_CHECK_CLOSE(result.GetWeights(0)[5], weight, 1.0e-4);
+  BOOST_CHECK_CLOSE(result.GetData(1)[0].real(),
+                    expected(6, 1, 0, weight).real(), 1.0e-4);
+  BOOST_CHECK_CLOSE(result.GetData(1)[3].real(),
+                    expected(7, 2, 1, weight).real(), 1.0e-4);
+  BOOST_CHECK_CLOSE(result.GetWeights(1)[3], weight, 1.0e-4);
+}
+
+BOOST_AUTO_TEST_CASE(bda_time_averaging_unsupported) {
+  DPInfo info(1, 2);
+  info.setTimes(0.0, 10.0, 10.0);
+  info.setAntennas({"a0"}, {70.0}, {casacore::MPosition()}, {0}, {0});
+  std::vector<std::vector<double>> freqs{{1.0e8, 1.1e8}};
+  std::vector<std::vector<double>> widths{{1.0e7, 1.0e7}};
+  info.setChannels(std::move(freqs), std::move(widths));
+  ParameterSet parset;
+  parset.add("timestep", "2");
+  Averager averager(parset, "", Step::MsType::kBda);
+  BOOST_CHECK_THROW(averager.updateInfo(info), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
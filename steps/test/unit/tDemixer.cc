@@ -241,12 +241,13 @@ class TestOutput : public dp3::steps::test::ThrowStep {
 
 // This test only tests the averager functionality of the Demixer.
 void TestDemixer(size_t ntime, size_t nbl, size_t nchan, size_t navgtime,
-                 size_t navgchan, bool flag) {
+                 size_t navgchan, bool flag, bool dense_solver = false) {
   auto step1 = std::make_shared<TestInput>(ntime, nbl, nchan, flag);
   ParameterSet parset;
   parset.add("freqstep", std::to_string(navgchan));
   parset.add("timestep", std::to_string(navgtime));
   parset.add("skymodel", dp3::steps::test::kPredictSourceDB);
+  if (dense_solver) parset.add("usedensesolver", "true");
   auto step2 = std::make_shared<Demixer>(parset, "");
   auto step3 =
       std::make_shared<TestOutput>(ntime, nbl, nchan, navgtime, navgchan, flag);
@@ -267,6 +268,10 @@ BOOST_AUTO_TEST_CASE(execute_4) { TestDemixer(11, 3, 30, 3, 3, false); }
 
 BOOST_AUTO_TEST_CASE(execute_5) { TestDemixer(10, 3, 32, 1, 32, false); }
 
+BOOST_AUTO_TEST_CASE(execute_dense_solver) {
+  TestDemixer(10, 3, 32, 2, 4, false, true);
+}
+
 BOOST_AUTO_TEST_CASE(fields) {
   using dp3::steps::Averager;
 
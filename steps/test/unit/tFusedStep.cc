@@ -0,0 +1,263 @@
+// Copyright (C) 2023 ASTRON (Netherlands Institute for Radio Astronomy)
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "../../FusedStep.h"
+
+#include <filesystem>
+#include <functional>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <casacore/measures/Measures/MPosition.h>
+
+#include <schaapcommon/h5parm/h5parm.h>
+#include <schaapcommon/h5parm/soltab.h>
+
+#include "../../MultiResultStep.h"
+#include "../../NullStokes.h"
+#include "../../OneApplyCal.h"
+#include "../../ResultStep.h"
+#include "../../ScaleData.h"
+#include "../../../common/ParameterSet.h"
+
+using dp3::steps::FusedStep;
+using dp3::steps::MultiResultStep;
+using dp3::steps::NullStokes;
+using dp3::steps::OneApplyCal;
+using dp3::steps::ResultStep;
+using dp3::steps::ScaleData;
+using dp3::steps::Step;
+
+BOOST_AUTO_TEST_SUITE(fused_step)
+
+namespace {
+constexpr std::size_t kNBaselines = 27;
+constexpr std::size_t kNChannels = 5;
+constexpr std::size_t kNCorrelations = 4;
+constexpr std::size_t kNAntennas = 6;
+constexpr std::size_t kNTimes = 3;
+constexpr double kStartTime = 4.87128e+09;
+constexpr double kInterval = 10.0;
+const std::string kParmDb = "tFusedStep_tmp.h5";
+
+// The size of a baseline in the data, weights and flags of a buffer.
+constexpr std::size_t kBaselineSize =
+    kNChannels * kNCorrelations *
+    (sizeof(std::complex<float>) + sizeof(float) + sizeof(bool));
+
+std::unique_ptr<dp3::base::DPBuffer> CreateBuffer(std::size_t time_index = 0) {
+  auto buffer = std::make_unique<dp3::base::DPBuffer>(
+      kStartTime + time_index * kInterval, kInterval);
+  const std::array<std::size_t, 3> shape{kNBaselines, kNChannels,
+                                         kNCorrelations};
+  buffer->GetData().resize(shape);
+  buffer->GetWeights().resize(shape);
+  buffer->GetFlags().resize(shape);
+  for (std::size_t i = 0; i < buffer->GetData().size(); ++i) {
+    buffer->GetData().data()[i] =
+        std::complex<float>(i + time_index, 1000.0f - i * 3.0f);
+    buffer->GetWeights().data()[i] = 1.0f + (i % 3);
+    buffer->GetFlags().data()[i] = (i % 17 == 0);
+  }
+  return buffer;
+}
+
+/// Creates an info with antennas and channels, as needed by ScaleData and
+/// OneApplyCal.
+dp3::base::DPInfo CreateInfo() {
+  dp3::base::DPInfo info(kNCorrelations, kNChannels);
+  info.setTimes(kStartTime, kStartTime + (kNTimes - 1) * kInterval, kInterval);
+
+  std::vector<int> ant1(kNBaselines);
+  std::vector<int> ant2(kNBaselines);
+  for (std::size_t bl = 0; bl < kNBaselines; ++bl) {
+    ant1[bl] = bl % kNAntennas;
+    ant2[bl] = (bl / kNAntennas) % kNAntennas;
+  }
+  std::vector<std::string> names;
+  std::vector<casacore::MPosition> positions;
+  for (std::size_t ant = 0; ant < kNAntennas; ++ant) {
+    names.push_back("ant" + std::to_string(ant + 1));
+    casacore::Vector<double> values(3);
+    values[0] = 3828763.0 - 17.0 * ant;
+    values[1] = 442449.0 + 143.0 * ant;
+    values[2] = 5064923.0 + ant;
+    positions.emplace_back(
+        casacore::Quantum<casacore::Vector<double>>(values, "m"),
+        casacore::MPosition::ITRF);
+  }
+  info.setAntennas(names, std::vector<double>(kNAntennas, 70.0), positions,
+                   ant1, ant2);
+
+  std::vector<double> frequencies;
+  for (std::size_t ch = 0; ch < kNChannels; ++ch) {
+    frequencies.push_back(120.0e6 + ch * 1.0e6);
+  }
+  info.setChannels(std::move(frequencies),
+                   std::vector<double>(kNChannels, 1.0e6));
+  return info;
+}
+
+/// Writes an H5Parm with an amplitude and a phase solution table, with values
+/// per antenna, time and channel. One solution has a zero weight, which flags
+/// the data.
+void CreateH5Parm() {
+  schaapcommon::h5parm::H5Parm h5parm(kParmDb, true);
+  std::vector<std::string> names;
+  for (std::size_t ant = 0; ant < kNAntennas; ++ant) {
+    names.push_back("ant" + std::to_string(ant + 1));
+  }
+  h5parm.AddAntennas(names, std::vector<std::array<double, 3>>(
+                                kNAntennas, std::array<double, 3>{42.0}));
+  std::vector<double> times;
+  for (std::size_t t = 0; t < kNTimes; ++t) {
+    times.push_back(kStartTime + t * kInterval);
+  }
+  const std::vector<double> frequencies = CreateInfo().chanFreqs();
+
+  for (const std::string type : {"amplitude", "phase"}) {
+    schaapcommon::h5parm::SolTab soltab = h5parm.CreateSolTab(
+        "my" + type, type,
+        {{"ant", kNAntennas}, {"time", kNTimes}, {"freq", kNChannels}});
+    soltab.SetAntennas(names);
+    soltab.SetTimes(times);
+    soltab.SetFreqs(frequencies);
+    std::vector<double> values;
+    std::vector<double> weights;
+    for (std::size_t ant = 0; ant < kNAntennas; ++ant) {
+      for (std::size_t t = 0; t < kNTimes; ++t) {
+        for (std::size_t f = 0; f < kNChannels; ++f) {
+          values.push_back(1.0 + 0.1 * ant + 0.01 * t + 0.001 * f);
+          weights.push_back((ant == 1 && t == 2 && f == 3) ? 0.0 : 1.0);
+        }
+      }
+    }
+    soltab.SetValues(values, weights, "CREATE with DP3 tFusedStep");
+  }
+}
+
+struct H5ParmFixture {
+  H5ParmFixture() { CreateH5Parm(); }
+  ~H5ParmFixture() { std::filesystem::remove(kParmDb); }
+};
+
+/// Processes kNTimes buffers with the steps created by @p create_steps, with
+/// and without a FusedStep in front of them, and checks that the output is
+/// equal. The tile size does not divide the number of baselines.
+void CheckSameAsUnfused(
+    const std::function<std::vector<std::shared_ptr<Step>>()>& create_steps) {
+  const dp3::base::DPInfo info = CreateInfo();
+
+  std::vector<std::shared_ptr<Step>> steps = create_steps();
+  auto reference_result = std::make_shared<MultiResultStep>(kNTimes);
+  steps.back()->setNextStep(reference_result);
+  steps.front()->setInfo(info);
+  for (std::size_t t = 0; t < kNTimes; ++t) {
+    steps.front()->process(CreateBuffer(t));
+  }
+
+  steps = create_steps();
+  auto fused_step = std::make_shared<FusedStep>(steps, 4 * kBaselineSize);
+  auto fused_result = std::make_shared<MultiResultStep>(kNTimes);
+  fused_step->setNextStep(steps.front());
+  steps.back()->setNextStep(fused_result);
+  fused_step->setInfo(info);
+  BOOST_CHECK_EQUAL(fused_step->TileSize(), 4);
+  for (std::size_t t = 0; t < kNTimes; ++t) {
+    fused_step->process(CreateBuffer(t));
+  }
+
+  BOOST_REQUIRE_EQUAL(fused_result->size(), kNTimes);
+  BOOST_REQUIRE_EQUAL(reference_result->size(), kNTimes);
+  for (std::size_t t = 0; t < kNTimes; ++t) {
+    const dp3::base::DPBuffer& fused = *fused_result->get()[t];
+    const dp3::base::DPBuffer& reference = *reference_result->get()[t];
+    BOOST_TEST(fused.GetData() == reference.GetData());
+    BOOST_TEST(fused.GetFlags() == reference.GetFlags());
+    BOOST_TEST(fused.GetWeights() == reference.GetWeights());
+    BOOST_TEST(fused.GetData() != CreateBuffer(t)->GetData());
+  }
+}
+
+std::vector<std::shared_ptr<Step>> CreateSteps() {
+  dp3::common::ParameterSet parset;
+  parset.add("q.modify_q", "true");
+  parset.add("u.modify_u", "true");
+  auto null_stokes_q = std::make_shared<NullStokes>(parset, "q.");
+  auto null_stokes_u = std::make_shared<NullStokes>(parset, "u.");
+  null_stokes_q->setNextStep(null_stokes_u);
+  return {null_stokes_q, null_stokes_u};
+}
+
+std::vector<std::shared_ptr<Step>> CreateScaleDataSteps() {
+  dp3::common::ParameterSet parset;
+  parset.add("scale1.stations", "[ant2, *]");
+  parset.add("scale1.coeffs", "[[2,0.5],[3,2,1]]");
+  parset.add("scale1.scalesize", "false");
+  parset.add("scale2.stations", "[ant[14]]");
+  parset.add("scale2.coeffs", "[[0.5,0.01]]");
+  parset.add("scale2.scalesize", "false");
+  parset.add("q.modify_q", "true");
+  auto scale_1 =
+      std::make_shared<ScaleData>(parset, "scale1.", Step::MsType::kRegular);
+  auto null_stokes = std::make_shared<NullStokes>(parset, "q.");
+  auto scale_2 =
+      std::make_shared<ScaleData>(parset, "scale2.", Step::MsType::kRegular);
+  scale_1->setNextStep(null_stokes);
+  null_stokes->setNextStep(scale_2);
+  return {scale_1, null_stokes, scale_2};
+}
+
+std::vector<std::shared_ptr<Step>> CreateApplyCalSteps() {
+  dp3::common::ParameterSet parset;
+  parset.add("amplitude.parmdb", kParmDb);
+  parset.add("amplitude.correction", "myamplitude");
+  parset.add("amplitude.updateweights", "true");
+  parset.add("phase.parmdb", kParmDb);
+  parset.add("phase.correction", "myphase");
+  parset.add("u.modify_u", "true");
+  auto amplitude =
+      std::make_shared<OneApplyCal>(parset, "amplitude.", "amplitude.");
+  auto phase = std::make_shared<OneApplyCal>(parset, "phase.", "phase.");
+  auto null_stokes = std::make_shared<NullStokes>(parset, "u.");
+  amplitude->setNextStep(phase);
+  phase->setNextStep(null_stokes);
+  return {amplitude, phase, null_stokes};
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(same_as_unfused) {
+  const dp3::base::DPInfo info(kNCorrelations, kNChannels);
+
+  std::vector<std::shared_ptr<dp3::steps::Step>> steps = CreateSteps();
+  auto reference_result = std::make_shared<ResultStep>();
+  steps.back()->setNextStep(reference_result);
+  steps.front()->setInfo(info);
+  steps.front()->process(CreateBuffer());
+
+  steps = CreateSteps();
+  // Use a tile size that does not divide the number of baselines.
+  auto fused_step = std::make_shared<FusedStep>(steps, 4 * kBaselineSize);
+  auto fused_result = std::make_shared<ResultStep>();
+  fused_step->setNextStep(steps.front());
+  steps.back()->setNextStep(fused_result);
+  fused_step->setInfo(info);
+  BOOST_CHECK_EQUAL(fused_step->TileSize(), 4);
+  fused_step->process(CreateBuffer());
+
+  BOOST_TEST(fused_result->get().GetData() ==
+             reference_result->get().GetData());
+  BOOST_TEST(fused_result->get().GetData() != CreateBuffer()->GetData());
+}
+
+BOOST_AUTO_TEST_CASE(scale_data_same_as_unfused) {
+  CheckSameAsUnfused(CreateScaleDataSteps);
+}
+
+BOOST_FIXTURE_TEST_CASE(apply_cal_same_as_unfused, H5ParmFixture) {
+  CheckSameAsUnfused(CreateApplyCalSteps);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
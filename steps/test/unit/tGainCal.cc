@@ -40,4 +40,17 @@ BOOST_AUTO_TEST_CASE(provided_fields) {
              (GainCal::kDataField | GainCal::kFlagsField));
 }
 
+BOOST_AUTO_TEST_CASE(parallel_solints) {
+  dp3::common::ParameterSet parset;
+  parset.add("parmdb", "foo");
+  parset.add("caltype", "scalar");
+  parset.add("usemodelcolumn", "true");
+  parset.add("parallelsolints", "4");
+  BOOST_CHECK_NO_THROW(std::make_unique<GainCal>(parset, ""));
+
+  parset.replace("parallelsolints", "0");
+  BOOST_CHECK_THROW(std::make_unique<GainCal>(parset, ""),
+                    std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
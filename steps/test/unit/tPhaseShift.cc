@@ -9,12 +9,15 @@
 #include <boost/test/unit_test.hpp>
 
 #include "tStepCommon.h"
+#include "mock/MockStep.h"
 #include "mock/ThrowStep.h"
+#include <dp3/base/BDABuffer.h>
 #include <dp3/base/DPBuffer.h>
 #include <dp3/base/DPInfo.h>
 #include "../../../common/ParameterSet.h"
 #include "../../../common/StringTools.h"
 
+using dp3::base::BDABuffer;
 using dp3::base::DPBuffer;
 using dp3::base::DPInfo;
 using dp3::common::ParameterSet;
@@ -288,4 +291,131 @@ BOOST_AUTO_TEST_CASE(test2a) { test2(10, 6, 32, 4, false); }
 
 BOOST_AUTO_TEST_CASE(test2b) { test2(10, 6, 30, 1, true); }
 
+// Create an info object for BDA tests, with two baselines. The first baseline
+// has full resolution channels, the second one has averaged channels.
+DPInfo MakeBdaInfo(const std::vector<double>& full_freqs) {
+  DPInfo info(4, full_freqs.size());
+  info.setTimes(0.0, 10.0, 10.0);
+  const casacore::MDirection phase_center(casacore::Quantity(45, "deg"),
+                                          casacore::Quantity(30, "deg"),
+                                          casacore::MDirection::J2000);
+  info.setArrayInformation(casacore::MPosition(), phase_center, phase_center,
+                           phase_center);
+  info.setAntennas({"a0", "a1"}, {70.0, 70.0},
+                   {casacore::MPosition(), casacore::MPosition()}, {0, 0},
+                   {0, 1});
+  std::vector<double> averaged_freqs;
+  for (std::size_t ch = 0; ch + 1 < full_freqs.size(); ch += 2) {
+    averaged_freqs.push_back(0.5 * (full_freqs[ch] + full_freqs[ch + 1]));
+  }
+  const double width = full_freqs[1] - full_freqs[0];
+  std::vector<std::vector<double>> freqs{full_freqs, averaged_freqs};
+  std::vector<std::vector<double>> widths{
+      std::vector<double>(full_freqs.size(), width),
+      std::vector<double>(averaged_freqs.size(), 2.0 * width)};
+  info.setChannels(std::move(freqs), std::move(widths));
+  return info;
+}
+
+BOOST_AUTO_TEST_CASE(bda_round_trip) {
+  const std::vector<double> full_freqs{1.0e8, 1.1e8, 1.2e8, 1.3e8};
+  const std::size_t kNCorr = 4;
+  const DPInfo info = MakeBdaInfo(full_freqs);
+
+  ParameterSet parset1;
+  parset1.add("phasecenter", "[50deg, 35deg]");
+  ParameterSet parset2;
+  parset2.add("phasecenter", "[]");
+  auto phase_shift1 =
+      std::make_shared<PhaseShift>(parset1, "", Step::MsType::kBda);
+  auto phase_shift2 =
+      std::make_shared<PhaseShift>(parset2, "", Step::MsType::kBda);
+  auto shifted = std::make_shared<dp3::steps::MockStep>();
+  auto restored = std::make_shared<dp3::steps::MockStep>();
+  BOOST_CHECK(phase_shift1->accepts(Step::MsType::kBda));
+  BOOST_CHECK(phase_shift1->outputs() == Step::MsType::kBda);
+  phase_shift1->setNextStep(shifted);
+  phase_shift2->setNextStep(restored);
+  phase_shift1->updateInfo(info);
+  phase_shift2->updateInfo(phase_shift1->getInfoOut());
+
+  const std::size_t n_elements =
+      (full_freqs.size() + info.chanFreqs(1).size()) * kNCorr;
+  std::vector<std::complex<float>> data(n_elements);
+  for (std::size_t i = 0; i < n_elements; ++i) {
+    data[i] = std::complex<float>(i + 1.0, -2.0 * i);
+  }
+  const std::array<double, 3> uvw_0{10.0, 20.0, 5.0};
+  const std::array<double, 3> uvw_1{-30.0, 15.0, 2.0};
+  auto make_buffer = [&]() {
+    auto buffer = std::make_unique<BDABuffer>(n_elements);
+    buffer->AddRow(5.0, 10.0, 10.0, 0, full_freqs.size(), kNCorr, data.data(),
+                   nullptr, nullptr, nullptr, uvw_0.data());
+    buffer->AddRow(5.0, 10.0, 10.0, 1, info.chanFreqs(1).size(), kNCorr,
+                   data.data() + full_freqs.size() * kNCorr, nullptr, nullptr,
+                   nullptr, uvw_1.data());
+    return buffer;
+  };
+
+  phase_shift1->process(make_buffer());
+  BOOST_REQUIRE_EQUAL(shifted->GetBdaBuffers().size(), 1u);
+  std::unique_ptr<BDABuffer> shifted_buffer =
+      std::make_unique<BDABuffer>(*shifted->GetBdaBuffers().front(),
+                                  BDABuffer::Fields(), BDABuffer::Fields());
+  const std::complex<float>* shifted_data = shifted_buffer->GetData();
+  for (std::size_t i = 0; i < n_elements; ++i) {
+    BOOST_CHECK_CLOSE(std::abs(shifted_data[i]), std::abs(data[i]), 1.0e-3);
+  }
+  BOOST_CHECK(shifted_buffer->GetRows()[0].uvw[0] != uvw_0[0]);
+
+  // The first row has full resolution channels, so it should match the
+  // result of the regular step.
+  {
+    DPInfo regular_info(kNCorr, full_freqs.size());
+    regular_info.setTimes(0.0, 10.0, 10.0);
+    regular_info.setArrayInformation(casacore::MPosition(), info.phaseCenter(),
+                                     info.phaseCenter(), info.phaseCenter());
+    regular_info.setAntennas({"a0"}, {70.0}, {casacore::MPosition()}, {0},
+                             {0});
+    regular_info.setChannels(std::vector<double>(full_freqs),
+                             std::vector<double>(full_freqs.size(), 1.0e7));
+    auto regular_shift = std::make_shared<PhaseShift>(parset1, "");
+    auto regular_out = std::make_shared<dp3::steps::MockStep>();
+    regular_shift->setNextStep(regular_out);
+    regular_shift->updateInfo(regular_info);
+    auto regular_buffer = std::make_unique<DPBuffer>();
+    regular_buffer->GetData().resize({1, full_freqs.size(), kNCorr});
+    std::copy_n(data.data(), full_freqs.size() * kNCorr,
+                regular_buffer->GetData().data());
+    regular_buffer->GetUvw().resize({1, 3});
+    std::copy_n(uvw_0.data(), 3, regular_buffer->GetUvw().data());
+    regular_shift->process(std::move(regular_buffer));
+    BOOST_REQUIRE_EQUAL(regular_out->GetRegularBuffers().size(), 1u);
+    const DPBuffer& regular_result = *regular_out->GetRegularBuffers().front();
+    for (std::size_t i = 0; i < full_freqs.size() * kNCorr; ++i) {
+      BOOST_CHECK_CLOSE(shifted_data[i].real(),
+                        regular_result.GetData().data()[i].real(), 1.0e-3);
+      BOOST_CHECK_CLOSE(shifted_data[i].imag(),
+                        regular_result.GetData().data()[i].imag(), 1.0e-3);
+    }
+    for (std::size_t i = 0; i < 3; ++i) {
+      BOOST_CHECK_CLOSE(shifted_buffer->GetRows()[0].uvw[i],
+                        regular_result.GetUvw()(0, i), 1.0e-6);
+    }
+  }
+
+  // Shifting back should restore the original data and uvw coordinates.
+  phase_shift2->process(std::move(shifted_buffer));
+  BOOST_REQUIRE_EQUAL(restored->GetBdaBuffers().size(), 1u);
+  const BDABuffer& restored_buffer = *restored->GetBdaBuffers().front();
+  const std::complex<float>* restored_data = restored_buffer.GetData();
+  for (std::size_t i = 0; i < n_elements; ++i) {
+    BOOST_CHECK_SMALL(std::abs(restored_data[i] - data[i]), 1.0e-3f);
+  }
+  for (std::size_t i = 0; i < 3; ++i) {
+    BOOST_CHECK_CLOSE(restored_buffer.GetRows()[0].uvw[i], uvw_0[i], 1.0e-6);
+    BOOST_CHECK_CLOSE(restored_buffer.GetRows()[1].uvw[i], uvw_1[i], 1.0e-6);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
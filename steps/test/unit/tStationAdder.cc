@@ -11,8 +11,11 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/test/data/test_case.hpp>
 
+#include <aocommon/threadpool.h>
+
 #include "tStepCommon.h"
 #include "mock/ThrowStep.h"
+#include "../../ResultStep.h"
 #include "../../StationAdder.h"
 #include <dp3/base/DPBuffer.h>
 #include <dp3/base/DPInfo.h>
@@ -504,6 +507,64 @@ BOOST_AUTO_TEST_CASE(test_add_two_groups_of_two_stations) {
   dp3::steps::test::Execute({step1, step2, step3});
 }
 
+namespace {
+// Forms the superstations ns1 and ns2 and the baseline between them, which is
+// formed from new baselines of ns1, using the given number of threads.
+std::unique_ptr<DPBuffer> AddTwoSuperStations(bool average,
+                                              std::size_t n_threads) {
+  auto input = std::make_shared<TestInput>(1, 16, 64, 4);
+  dp3::common::ParameterSet parset;
+  parset.add("stations",
+             "{ns1:[rs01.s01, rs02.s01], ns2:[cs01.s02, cs01.s01]}");
+  parset.add("autocorr", "false");
+  parset.add("average", average ? "true" : "false");
+  parset.add("useweights", "false");
+  auto adder = std::make_shared<StationAdder>(parset, "");
+  auto result = std::make_shared<dp3::steps::ResultStep>();
+  input->setNextStep(adder);
+  adder->setNextStep(result);
+
+  aocommon::ThreadPool::GetInstance().SetNThreads(n_threads);
+  input->setInfo(DPInfo());
+  input->process(std::make_unique<DPBuffer>());
+  input->finish();
+  aocommon::ThreadPool::GetInstance().SetNThreads(1);
+  return result->take();
+}
+}  // namespace
+
+BOOST_DATA_TEST_CASE(test_baseline_between_superstations,
+                     boost::unit_test::data::make({true, false}), average) {
+  const std::unique_ptr<DPBuffer> serial = AddTwoSuperStations(average, 1);
+  const std::unique_ptr<DPBuffer> parallel = AddTwoSuperStations(average, 4);
+
+  // 16 old baselines, 2 new baselines per superstation and ns1-ns2.
+  BOOST_REQUIRE_EQUAL(serial->GetData().shape(0), 21);
+  BOOST_CHECK(parallel->GetData() == serial->GetData());
+  BOOST_CHECK(parallel->GetFlags() == serial->GetFlags());
+  BOOST_CHECK(parallel->GetWeights() == serial->GetWeights());
+  BOOST_CHECK(parallel->GetUvw() == serial->GetUvw());
+
+  // ns1-ns2 (baseline 20) is formed from the finished baselines
+  // cs01.s01-ns1 (16) and cs01.s02-ns1 (17).
+  const auto sum = xt::conj(xt::view(serial->GetData(), 16, xt::all(),
+                                     xt::all())) +
+                   xt::conj(xt::view(serial->GetData(), 17, xt::all(),
+                                     xt::all()));
+  const xt::xtensor<std::complex<float>, 2> expected =
+      average ? xt::xtensor<std::complex<float>, 2>(sum / 2.0f)
+              : xt::xtensor<std::complex<float>, 2>(sum);
+  BOOST_CHECK(xt::allclose(xt::view(serial->GetData(), 20, xt::all(),
+                                    xt::all()),
+                           expected));
+  if (average) {
+    const auto uvw_sum = -xt::view(serial->GetUvw(), 16, xt::all()) -
+                         xt::view(serial->GetUvw(), 17, xt::all());
+    BOOST_CHECK(xt::allclose(xt::view(serial->GetUvw(), 20, xt::all()),
+                             uvw_sum / 2.0));
+  }
+}
+
 BOOST_DATA_TEST_CASE(
     test_invalid_station,
     boost::unit_test::data::make(